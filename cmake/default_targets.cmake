@@ -76,18 +76,12 @@ function(define_executable target_name )
       PARENT_SCOPE)
 endfunction()
 
-function(define_ut_target target_name ut_name)
-  file(GLOB src_ut ${ut_name}/*)
-
-  string(REGEX REPLACE "test(.*)" "\\1" short_ut_name ${ut_name})
-  string(REPLACE "/" "_" valid_ut_name "${short_ut_name}")
-
-  set(target_ut_name "${target_name}${valid_ut_name}_ut")
+function(add_ut_executable target_ut_name)
   message("* Adding UTs ${target_ut_name} ")
 
-  add_executable(${target_ut_name} ${src_ut})
+  add_executable(${target_ut_name} ${ARGN})
   target_include_directories(${target_ut_name} PRIVATE src test)
-  target_link_libraries(${target_ut_name} PUBLIC ${target_name} fmt::fmt GTest::gmock GTest::gtest ${ut_runner})
+  target_link_libraries(${target_ut_name} PUBLIC fmt::fmt GTest::gmock GTest::gtest ${ut_runner})
   target_compile_definitions(${target_ut_name} PRIVATE -DWANTS_GTEST_MOCKS)
 
   add_custom_target(
@@ -95,7 +89,7 @@ function(define_ut_target target_name ut_name)
     COMMAND ${target_ut_name} --gtest_shuffle
     WORKING_DIRECTORY ${TARGET_DESTINATTION}
     COMMENT "Running test ${target_ut_name}"
-    DEPENDS ${target_ut_name} ${target_name})
+    DEPENDS ${target_ut_name})
 
   add_test(
     NAME test_${target_ut_name}
@@ -116,6 +110,17 @@ function(define_ut_target target_name ut_name)
   add_dependencies(build_all_test ${target_ut_name})
 endfunction()
 
+function(define_ut_target target_name ut_name)
+  file(GLOB src_ut ${ut_name}/*)
+
+  string(REGEX REPLACE "test(.*)" "\\1" short_ut_name ${ut_name})
+  string(REPLACE "/" "_" valid_ut_name "${short_ut_name}")
+
+  set(target_ut_name "${target_name}${valid_ut_name}_ut")
+  add_ut_executable(${target_ut_name} ${src_ut})
+  target_link_libraries(${target_ut_name} PUBLIC ${target_name})
+endfunction()
+
 function(define_ut_multi_target target_name ut_name)
   file(
     GLOB src_ut
@@ -137,6 +142,18 @@ function(define_ut_multi_target target_name ut_name)
   endif()
 endfunction()
 
+# Executables have no library to link tests with, their sources (except main.cpp) are
+# built into the test. Has to be called after libraries are linked to the executable.
+function(define_executable_ut target_name)
+  file(GLOB_RECURSE SRC src/*.cpp src/*.hpp)
+  list(FILTER SRC EXCLUDE REGEX "/src/main\\.cpp$")
+  file(GLOB src_ut test/*)
+
+  add_ut_executable(${target_name}_ut ${src_ut} ${SRC})
+  get_target_property(libraries ${target_name} LINK_LIBRARIES)
+  target_link_libraries(${target_name}_ut PUBLIC ${libraries})
+endfunction()
+
 function(define_static_lib_with_ut target_name)
   define_static_lib(${target_name})
   define_ut_multi_target(${target_name} test)
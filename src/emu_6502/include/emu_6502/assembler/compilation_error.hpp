@@ -36,6 +36,9 @@ enum class CompilationError {
 
     InvalidCommandArgument,
 
+    MacroRedefinition,
+    UnterminatedBlock,
+    ExpansionTooDeep,
 };
 
 std::string to_string(CompilationError error);
@@ -62,11 +65,11 @@ class CompilationException : public std::exception {
 public:
     CompilationException(std::string _message, CompilationError _error,
                          std::optional<Token> _token = {})
-        : message(std::move(_message)), error(_error), token(std::move(_token)) {}
+        : message(std::move(_message)), error(_error), token(Detached(std::move(_token))) {}
 
     CompilationException(const CompilationSubException &sub_exception, Token token = {})
         : message(sub_exception.message), error(sub_exception.error),
-          token(Token{std::move(token), sub_exception.offset}) {}
+          token(Detached(Token{std::move(token), sub_exception.offset})) {}
 
     virtual std::string Message() const;
     bool HasToken() const { return token.has_value(); }
@@ -88,6 +91,14 @@ private:
     const std::string message;
     const CompilationError error;
     const std::optional<Token> token;
+
+    // Exception may outlive the source being compiled
+    static std::optional<Token> Detached(std::optional<Token> t) {
+        if (t.has_value()) {
+            t->Detach();
+        }
+        return t;
+    }
 };
 
 template <typename... ARGS>
@@ -3,15 +3,19 @@
 #include "emu_6502/instruction_set.hpp"
 #include "emu_core/program.hpp"
 #include "emu_core/symbol_factory.hpp"
+#include "keyword_map.hpp"
+#include "listing.hpp"
 #include "tokenizer.hpp"
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace emu::emu6502::assembler {
 
 struct CompilationContext;
+class MacroProcessor;
 
 struct InstructionParsingInfo {
     std::unordered_map<AddressMode, OpcodeInfo> variants;
@@ -29,17 +33,34 @@ public:
     void CompileFile(const std::string &file);
 
     void AddDefinitions(const SymbolDefVector &symbols);
+    // Run peephole optimizer and zero page selection before relocations are applied.
+    // Out of range branches are extended regardless of this setting
+    void SetOptimize(bool enable) { optimize = enable; }
+    // Record listing of instructions, available after GetProgram or GetObject
+    void SetListing(bool enable);
+    const Listing &GetListing() const { return listing; }
+    // Files included by .incbin, available after GetProgram or GetObject
+    const std::vector<std::string> &GetIncludedFiles() const { return included_files; }
     std::unique_ptr<Program> GetProgram();
+    // Program with relocations not applied, input for Linker
+    std::unique_ptr<Program> GetObject();
 
 private:
     std::unordered_map<std::string_view, InstructionParsingInfo> instruction_set;
+    KeywordMap<const InstructionParsingInfo *, 10> mnemonics;
     std::ostream *const verbose_stream;
+    bool optimize = false;
+    bool listing_enabled = false;
+    Listing listing;
+    std::vector<std::string> included_files;
 
     std::unique_ptr<Program> program;
     std::unique_ptr<CompilationContext> context;
+    std::unique_ptr<MacroProcessor> macros;
 
     void Start();
 
+    void HandleLine(LineTokenizer &line);
     void ProcessLine(LineTokenizer &line);
     bool TryDefinition(const Token &first_token, LineTokenizer &line);
 };
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace emu::emu6502::assembler {
+
+// Case insensitive map of short keywords (mnemonics, directives) with perfect hashing.
+// Keywords of up to 8 characters are packed into 64 bit keys with letters folded to
+// lower case, so lookup neither allocates nor compares strings. Constructor searches
+// for multiplier which maps all keys into distinct slots; it can run at compile time.
+template <typename Value, size_t kSlotBits>
+class KeywordMap {
+public:
+    using Item = std::pair<std::string_view, Value>;
+
+    static constexpr size_t kSlotCount = size_t{1} << kSlotBits;
+    static constexpr size_t kMaxKeywordLength = 8;
+
+    static constexpr std::optional<uint64_t> PackKeyword(std::string_view keyword) {
+        if (keyword.empty() || keyword.size() > kMaxKeywordLength) {
+            return std::nullopt;
+        }
+        uint64_t key = 0;
+        for (auto c : keyword) {
+            auto byte = static_cast<uint8_t>(c);
+            if (byte == 0) {
+                return std::nullopt;
+            }
+            if (byte >= 'A' && byte <= 'Z') {
+                byte |= 0x20;
+            }
+            key = (key << 8) | byte;
+        }
+        return key;
+    }
+
+    constexpr KeywordMap() = default;
+    constexpr KeywordMap(std::initializer_list<Item> items) { Build(items); }
+    template <typename Range>
+    constexpr explicit KeywordMap(const Range &items) {
+        Build(items);
+    }
+
+    [[nodiscard]] constexpr const Value *Find(std::string_view keyword) const {
+        auto key = PackKeyword(keyword);
+        if (!key.has_value() || count == 0) {
+            return nullptr;
+        }
+        auto &slot = slots[SlotIndex(*key, seed)];
+        return slot.key == *key ? &slot.value : nullptr;
+    }
+
+    [[nodiscard]] constexpr size_t size() const { return count; }
+
+private:
+    static constexpr size_t kMaxSeedAttempts = 4096;
+
+    struct Slot {
+        uint64_t key = 0;
+        Value value{};
+    };
+
+    std::array<Slot, kSlotCount> slots{};
+    uint64_t seed = 0;
+    size_t count = 0;
+
+    static constexpr size_t SlotIndex(uint64_t key, uint64_t seed) {
+        return static_cast<size_t>((key * seed) >> (64 - kSlotBits));
+    }
+
+    template <typename Range>
+    constexpr void Build(const Range &items) {
+        std::array<uint64_t, kSlotCount> keys{};
+        for (auto &[name, value] : items) {
+            auto key = PackKeyword(name);
+            if (!key.has_value()) {
+                throw std::invalid_argument("Keyword is empty or too long");
+            }
+            if (count == kSlotCount) {
+                throw std::length_error("Too many keywords");
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (keys[i] == *key) {
+                    throw std::invalid_argument("Duplicated keyword");
+                }
+            }
+            keys[count++] = *key;
+        }
+
+        uint64_t candidate = 0x9E3779B97F4A7C15ull;
+        for (size_t attempt = 0; attempt < kMaxSeedAttempts; ++attempt) {
+            candidate = (candidate * 6364136223846793005ull + 1442695040888963407ull) | 1;
+            if (IsPerfect(keys, candidate)) {
+                seed = candidate;
+                size_t i = 0;
+                for (auto &[name, value] : items) {
+                    auto key = keys[i++];
+                    slots[SlotIndex(key, seed)] = Slot{key, value};
+                }
+                return;
+            }
+        }
+        throw std::runtime_error("Unable to find perfect hash for keywords");
+    }
+
+    constexpr bool IsPerfect(const std::array<uint64_t, kSlotCount> &keys,
+                             uint64_t candidate) const {
+        std::array<bool, kSlotCount> used{};
+        for (size_t i = 0; i < count; ++i) {
+            auto index = SlotIndex(keys[i], candidate);
+            if (used[index]) {
+                return false;
+            }
+            used[index] = true;
+        }
+        return true;
+    }
+};
+
+} // namespace emu::emu6502::assembler
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "emu_core/program.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace emu::emu6502::assembler {
+
+// Combines objects produced by Compiler6502::GetObject into single program.
+// Code of all objects is placed at addresses selected during compilation, symbols
+// defined in one object resolve imports of others, aliases stay local to object
+// (first definition is kept in result). Relocations are applied last.
+class Linker {
+public:
+    Linker(std::ostream *verbose_stream = nullptr) : verbose_stream(verbose_stream) {}
+
+    void AddObject(std::unique_ptr<Program> object, std::string name);
+    std::unique_ptr<Program> Link();
+
+private:
+    struct Object {
+        std::unique_ptr<Program> program;
+        std::string name;
+    };
+
+    std::ostream *const verbose_stream;
+    std::vector<Object> objects;
+
+    template <typename... ARGS>
+    void Log(ARGS &&...args) {
+        if (verbose_stream != nullptr) {
+            (*verbose_stream) << "Linker: " << fmt::format(std::forward<ARGS>(args)...)
+                              << "\n";
+        }
+    }
+};
+
+} // namespace emu::emu6502::assembler
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "emu_6502/assembler/tokenizer.hpp"
+#include "emu_6502/instruction_set.hpp"
+#include "emu_core/program.hpp"
+#include <string>
+#include <vector>
+
+namespace emu::emu6502::assembler {
+
+// Instruction as placed in final layout, with line of source which produced it
+struct ListingEntry {
+    Address_t position;
+    OpcodeInfo opcode;
+    TokenLocation location;
+};
+
+using Listing = std::vector<ListingEntry>;
+
+// Each instruction is printed with address, bytes, cycles and source line. Cycles are
+// printed as range when instruction may take longer: indexed read crossing page or
+// taken branch (its page crossing is known from operand).
+// Totals are computed from opcode timing only:
+//  - basic block (split at labels, after jumps and branches): from all conditional
+//    branches falling through to all penalties paid and final branch taken
+//  - labelled loop (label with later branch or JMP back to it): straight path from
+//    label to that instruction, with the closing branch taken
+std::string FormatListing(const Program &program, const Listing &listing);
+
+} // namespace emu::emu6502::assembler
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "emu_6502/instruction_set.hpp"
+#include "emu_core/program.hpp"
+#include "emu_core/symbol_factory.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace emu::emu6502::assembler {
+
+constexpr auto kObjectFileExtension = ".emu_obj";
+
+// Directory of objects (see Compiler6502::GetObject) keyed by hash of source text and
+// everything else which affects compilation result. Entries are never invalidated,
+// changed input simply produces different key.
+class ObjectCache {
+public:
+    ObjectCache(std::filesystem::path directory);
+
+    static uint64_t Key(std::string_view source, InstructionSet instruction_set,
+                        const SymbolDefVector &definitions, bool optimize = false);
+
+    // nullptr if object is not cached or cannot be loaded
+    std::unique_ptr<Program> Load(uint64_t key) const;
+    // Failure to store object is ignored
+    void Store(uint64_t key, const Program &object) const;
+
+private:
+    const std::filesystem::path directory;
+
+    std::filesystem::path ObjectPath(uint64_t key) const;
+};
+
+} // namespace emu::emu6502::assembler
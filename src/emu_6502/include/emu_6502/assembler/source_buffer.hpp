@@ -0,0 +1,42 @@
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace emu::emu6502::assembler {
+
+// Whole assembler input kept in memory, either mapped file or owned text.
+// Tokens and locations produced by Tokenizer refer to it without copying.
+class SourceBuffer : public std::enable_shared_from_this<SourceBuffer> {
+public:
+    ~SourceBuffer();
+
+    static std::shared_ptr<const SourceBuffer> FromString(std::string text,
+                                                          std::string name);
+    static std::shared_ptr<const SourceBuffer> FromStream(std::istream &input,
+                                                          std::string name);
+    static std::shared_ptr<const SourceBuffer> MapFile(const std::string &path);
+
+    [[nodiscard]] std::string_view Text() const { return text; }
+    [[nodiscard]] const std::string &Name() const { return name; }
+
+    // Content of line starting at offset, without line terminator
+    [[nodiscard]] std::string_view LineAt(size_t offset) const;
+
+private:
+    struct PrivateTag {};
+
+public:
+    SourceBuffer(PrivateTag, std::string name);
+
+private:
+    const std::string name;
+    std::string owned_text;
+    void *mapped = nullptr;
+    size_t mapped_size = 0;
+    std::string_view text;
+};
+
+} // namespace emu::emu6502::assembler
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "source_buffer.hpp"
 #include <iostream>
 #include <memory>
 #include <optional>
@@ -15,32 +16,38 @@ struct Tokenizer;
 struct LineTokenizer;
 struct TokenListIterator;
 
+// Position of token in SourceBuffer. Source is not owned while compiling, Detach()
+// takes ownership when location has to outlive the tokenizer (e.g. in exceptions).
 struct TokenLocation {
     TokenLocation() = default;
     TokenLocation(TokenLocation &&) = default;
     TokenLocation(const TokenLocation &) = default;
 
-    TokenLocation(std::shared_ptr<const std::string> input_name,
-                  std::shared_ptr<const std::string> line_content, size_t line,
-                  size_t column)
-        : input_name(std::move(input_name)), line_content(std::move(line_content)),
-          line(line), column(column) {}
+    TokenLocation(const SourceBuffer *source, size_t line_offset, size_t line, size_t column)
+        : source(source), line_offset(line_offset), line(line), column(column) {}
 
     TokenLocation &operator=(const TokenLocation &) = default;
     TokenLocation &operator=(TokenLocation &&) = default;
 
-    std::shared_ptr<const std::string> input_name = {};
-    std::shared_ptr<const std::string> line_content = {};
+    const SourceBuffer *source = nullptr;
+    std::shared_ptr<const SourceBuffer> owner = {};
+    size_t line_offset = 0;
     size_t line = 0;
     size_t column = 0;
 
+    void Detach();
+
+    std::string_view InputName() const;
+    std::string_view LineContent() const;
     std::string GetDescription() const;
 };
 
 std::string to_string(const TokenLocation &location);
 
+// Value refers to source buffer, unless token was built from text which is not present
+// in the source as is (quoted strings with escape sequences, synthetic tokens).
 struct Token {
-    std::string value;
+    std::string_view value;
     TokenLocation location = {};
 
     Token() = default;
@@ -50,13 +57,19 @@ struct Token {
     Token(const Token &other, size_t column_offset) : Token(other) {
         location.column += column_offset;
     }
-    Token(Token &&other, size_t column_offset) : Token(other) {
+    Token(Token &&other, size_t column_offset) : Token(std::move(other)) {
         location.column += column_offset;
     }
-    Token(TokenLocation location, std::string input = {})
-        : value(input), location(location) {}
+    Token(TokenLocation location) : location(std::move(location)) {}
     Token(TokenLocation location, std::string_view input)
-        : value(input), location(location) {}
+        : value(input), location(std::move(location)) {}
+    Token(TokenLocation location, const char *input)
+        : value(input), location(std::move(location)) {}
+    Token(TokenLocation location, std::string input)
+        : location(std::move(location)),
+          storage(std::make_shared<const std::string>(std::move(input))) {
+        value = *storage;
+    }
 
     operator bool() const { return !value.empty(); }
     bool operator==(std::string_view s) const { return value == s; }
@@ -64,19 +77,29 @@ struct Token {
     Token &operator=(const Token &) = default;
     Token &operator=(Token &&) = default;
 
+    // Makes token independent of source buffer lifetime
+    void Detach();
+
     std::string Upper() const;
     std::string Lower() const;
-    std::string_view View() const { return std::string_view(value); }
-    const std::string &String() const { return value; }
+    std::string_view View() const { return value; }
+    std::string String() const { return std::string(value); }
+
+private:
+    std::shared_ptr<const std::string> storage;
 };
 
 std::string to_string(const Token &token);
 
 struct LineTokenizer {
-    LineTokenizer(Tokenizer &_tokenizer, size_t _line_number,
-                  std::shared_ptr<const std::string> _line_storage)
-        : tokenizer(_tokenizer), line_number(_line_number), line_storage(_line_storage),
-          line(*line_storage) {}
+    LineTokenizer(Tokenizer &_tokenizer, size_t _line_number, size_t _line_offset,
+                  std::string_view _line)
+        : tokenizer(&_tokenizer), line_number(_line_number), line_offset(_line_offset),
+          line(_line) {}
+    // Replays tokens recorded earlier (e.g. body of macro) instead of reading source
+    LineTokenizer(std::vector<Token> _tokens, TokenLocation _end_location)
+        : line_number(_end_location.line), line_offset(_end_location.line_offset),
+          replayed_tokens(std::move(_tokens)), end_location(std::move(_end_location)) {}
 
     bool HasInput();
     Token NextToken();
@@ -85,29 +108,35 @@ struct LineTokenizer {
     TokenListIterator TokenList(std::string separator);
 
 private:
-    Tokenizer &tokenizer;
+    Tokenizer *const tokenizer = nullptr;
     const size_t line_number;
-    std::shared_ptr<const std::string> line_storage;
+    const size_t line_offset;
     size_t column = 0;
     std::string_view line;
+    std::vector<Token> replayed_tokens;
+    size_t replay_position = 0;
+    TokenLocation end_location;
 
     void ConsumeUntilNextToken();
 };
 
 struct Tokenizer {
+    Tokenizer(std::shared_ptr<const SourceBuffer> _source) : source(std::move(_source)) {}
     Tokenizer(std::istream &_input, std::string _input_name)
-        : input(_input), input_name(std::make_shared<std::string>(_input_name)) {}
+        : Tokenizer(SourceBuffer::FromStream(_input, std::move(_input_name))) {}
 
     LineTokenizer NextLine();
     bool HasInput();
     TokenLocation Location() const;
 
-    auto GetInputName() const { return input_name; }
+    const SourceBuffer *GetSource() const { return source.get(); }
+    const std::string &GetInputName() const { return source->Name(); }
 
 private:
-    std::istream &input;
-    const std::shared_ptr<const std::string> input_name;
-    std::shared_ptr<const std::string> current_line = std::make_shared<std::string>();
+    const std::shared_ptr<const SourceBuffer> source;
+    size_t position = 0;
+    size_t line_offset = 0;
+    bool finished = false;
     size_t line = 0;
 };
 
@@ -25,6 +25,13 @@ struct ExecutionHalted : public std::runtime_error {
     const Reg8 halt_code;
 };
 
+struct WatchdogExpired : public std::runtime_error {
+    WatchdogExpired(Registers regs, uint64_t cycle)
+        : std::runtime_error("Watchdog expired"), regs(regs), cycle(cycle) {}
+    const Registers regs;
+    const uint64_t cycle;
+};
+
 struct InvalidOpcodeException : public std::runtime_error {
     InvalidOpcodeException(Registers regs, Reg8 opcode)
         : std::runtime_error("Invalid opcode"), regs(regs), opcode(opcode) {}
@@ -33,6 +40,10 @@ struct InvalidOpcodeException : public std::runtime_error {
 };
 
 struct Cpu {
+    // Deadline and watchdog are checked at least once per this many instructions.
+    // Batches are shorter when clock is slow enough to pass the deadline before.
+    static constexpr uint32_t kDeadlineCheckInterval = 1024;
+
     Registers reg;
     Memory16 *const memory;
     const InstructionHandlerArray *instruction_handlers;
@@ -61,6 +72,9 @@ private:
     Debugger *const debugger;
 
     Interrupt pending_interrupt = Interrupt::None;
+
+    void ExecuteInstructionBatch(uint32_t count);
+    uint32_t BatchSize(std::chrono::steady_clock::duration remaining) const;
 };
 
 } // namespace emu::emu6502::cpu
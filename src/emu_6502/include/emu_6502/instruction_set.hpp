@@ -48,6 +48,18 @@ struct OpcodeInfo {
     AddressMode addres_mode;
 };
 
+// Documented NMOS 6502 timing of instruction, known without executing it
+struct InstructionTiming {
+    uint8_t cycles;
+    // Indexed read takes one more cycle when effective address is in other page
+    bool page_cross_penalty = false;
+    // Branch takes one more cycle when taken, and another one when target is in other
+    // page than the next instruction
+    bool branch = false;
+};
+
+InstructionTiming GetInstructionTiming(const OpcodeInfo &info);
+
 using OpcodeInstructionMap = std::unordered_map<Opcode, OpcodeInfo>;
 
 const OpcodeInstructionMap &Get6502InstructionSet();
@@ -3,11 +3,16 @@
 #include "emu_core/byte_utils.hpp"
 #include "instruction_argument.hpp"
 #include "instruction_variant_compiler.hpp"
+#include "peephole_optimizer.hpp"
+#include "relaxer.hpp"
+#include <array>
 #include <bit>
+#include <filesystem>
+#include <optional>
 
 namespace emu::emu6502::assembler {
 
-const std::unordered_map<std::string, CompilationContext::CommandParsingInfo>
+constinit const KeywordMap<CompilationContext::CommandParsingInfo, 5>
     CompilationContext::kCommandParseInfo = {
         //cc65
         {"addr", {&CompilationContext::ParseDataCommand<2>}},  //
@@ -17,6 +22,7 @@ const std::unordered_map<std::string, CompilationContext::CommandParsingInfo>
         {"byte", {&CompilationContext::ParseDataCommand<1>}},  //
         {"dbyt", {&CompilationContext::ParseDataCommand<2>}},  //
         {"dword", {&CompilationContext::ParseDataCommand<4>}}, //
+        {"incbin", {&CompilationContext::ParseIncbinCommand}}, //
         {"org", {&CompilationContext::ParseOriginCommand}},    //
         {"word", {&CompilationContext::ParseDataCommand<2>}},  //
 
@@ -79,12 +85,11 @@ void CompilationContext::HandleCommand(const Token &command_token,
                                        LineTokenizer &line_tokenizer) {
     auto command = command_token.View();
     command.remove_prefix(1);
-    if (auto it = kCommandParseInfo.find(std::string(command));
-        it == kCommandParseInfo.end()) {
+    ++region;
+    if (auto *info = kCommandParseInfo.Find(command); info == nullptr) {
         ThrowCompilationError(CompilationError::UnknownCommand, command_token);
     } else {
-        auto handler = it->second.handler;
-        (this->*handler)(line_tokenizer);
+        (this->*(info->handler))(line_tokenizer);
     }
 }
 
@@ -202,6 +207,71 @@ void CompilationContext::ParseIsrCommand(LineTokenizer &tokenizer) {
 void CompilationContext::ParseSymbolCommand(LineTokenizer &tokenizer) {
 }
 
+void CompilationContext::ParseIncbinCommand(LineTokenizer &tokenizer) {
+    auto file_token = tokenizer.NextToken();
+    auto file_name = file_token.View();
+    if (file_name.size() < 2 || !file_name.starts_with('"') ||
+        !file_name.ends_with('"')) {
+        ThrowCompilationError(CompilationError::InvalidCommandArgument, file_token,
+                              "Expected quoted file name");
+    }
+    file_name = file_name.substr(1, file_name.size() - 2);
+
+    // Optional offset and length of included part
+    std::array<std::optional<size_t>, 2> range;
+    for (auto &value : range) {
+        auto separator = tokenizer.NextToken();
+        if (!separator) {
+            break;
+        }
+        if (separator != ",") {
+            ThrowCompilationError(CompilationError::InvalidToken, separator);
+        }
+        auto tok = tokenizer.NextToken();
+        if (!tok) {
+            ThrowCompilationError(CompilationError::UnexpectedEndOfInput, tok);
+        }
+        try {
+            value = ParseWord(tok.View());
+        } catch (...) {
+            ThrowCompilationError(CompilationError::InvalidCommandArgument, tok,
+                                  "Cannot parse value");
+        }
+    }
+
+    // Relative paths are resolved against directory of the including source
+    std::filesystem::path path{file_name};
+    if (auto source = std::filesystem::path{file_token.location.InputName()};
+        path.is_relative() && std::filesystem::is_regular_file(source)) {
+        path = source.parent_path() / path;
+    }
+
+    std::shared_ptr<const SourceBuffer> file;
+    try {
+        file = SourceBuffer::MapFile(path.string());
+    } catch (const std::exception &e) {
+        ThrowCompilationError(CompilationError::InvalidCommandArgument, file_token, "{}",
+                              e.what());
+    }
+    auto content = file->Text();
+    auto offset = range[0].value_or(0);
+    auto length = range[1].value_or(content.size() - std::min(offset, content.size()));
+    if (offset + length > content.size()) {
+        ThrowCompilationError(CompilationError::InvalidCommandArgument, file_token,
+                              "Range {}+{} exceeds size {} of '{}'", offset, length,
+                              content.size(), path.string());
+    }
+    if (current_position + length > 0x10000) {
+        ThrowCompilationError(CompilationError::InvalidCommandArgument, file_token,
+                              "Including {} bytes at {:04x} exceeds address space",
+                              length, current_position);
+    }
+
+    Log("Including {} bytes of '{}' at {:04x}", length, path.string(), current_position);
+    included_files.emplace_back(path.string());
+    EmitBytes({reinterpret_cast<const uint8_t *>(content.data()) + offset, length});
+}
+
 std::vector<uint8_t>
 CompilationContext::ParseTokenToBytes(const Token &value_token,
                                       size_t expected_byte_size) const {
@@ -218,18 +288,16 @@ void CompilationContext::BeginSymbol(const Token &name_token) {
     if (view.ends_with(":")) {
         view.remove_suffix(1);
     }
-    auto symbol_name = std::string(view);
 
-    if (auto symbol = program.FindSymbol(symbol_name); symbol == nullptr) {
-        Log("Adding symbol '{}' at {:04x}", symbol_name, current_position);
-        auto l = SymbolInfo{
-            .name = symbol_name,
+    if (auto *symbol = program.FindSymbol(view); symbol == nullptr) {
+        Log("Adding symbol '{}' at {:04x}", view, current_position);
+        program.AddSymbol(SymbolInfo{
+            .name = std::string(view),
             .offset = current_position,
             .imported = false,
-        };
-        program.AddSymbol(std::make_shared<SymbolInfo>(l));
+        });
     } else {
-        Log("Found symbol '{}' at {:04x}", symbol_name, current_position);
+        Log("Found symbol '{}' at {:04x}", view, current_position);
         symbol->imported = false;
         if (HasValue(symbol->offset)) {
             ThrowCompilationError(CompilationError::SymbolRedefinition, name_token);
@@ -285,6 +353,16 @@ void CompilationContext::EmitInstruction(LineTokenizer &tokenizer,
             .current_position = current_position,
         };
         auto r = iadp.DispatchProcess(argument.argument_value);
+        auto &emitted = emitted_instructions.emplace_back(EmittedInstruction{
+            .position = current_position,
+            .opcode = iadp.opcode,
+            .region = region,
+            .variants = &instruction,
+        });
+        if (record_locations) {
+            emitted.location = first_token.location;
+            emitted.location.Detach();
+        }
         EmitBytes(r.bytes);
         if (r.relocation_mode.has_value()) {
             PutSymbolReference(*r.relocation_mode, r.relocation_symbol,
@@ -299,11 +377,10 @@ void CompilationContext::EmitInstruction(LineTokenizer &tokenizer,
 void CompilationContext::PutSymbolReference(RelocationMode mode,
                                             const std::string &symbol,
                                             Address_t position) {
-    auto relocation = std::make_shared<RelocationInfo>();
-    std::shared_ptr<SymbolInfo> symbol_ptr = program.FindSymbol(symbol);
-    if (symbol_ptr == nullptr) {
+    auto symbol_id = program.FindSymbolId(symbol);
+    if (!symbol_id.has_value()) {
         Log("Adding reference at {:04x} to unknown symbol '{}'", position, symbol);
-        symbol_ptr = program.AddSymbol(SymbolInfo{
+        symbol_id = program.AddSymbol(SymbolInfo{
             .name = symbol,
             .imported = true,
         });
@@ -311,48 +388,89 @@ void CompilationContext::PutSymbolReference(RelocationMode mode,
         Log("Adding reference at {:04x} to symbol '{}'", position, symbol);
     }
 
-    relocation->position = position;
-    relocation->mode = mode;
-    relocation->target_symbol = symbol_ptr;
-    program.relocations.insert(relocation);
+    program.relocations.push_back(RelocationInfo{
+        .target_symbol = *symbol_id,
+        .position = position,
+        .mode = mode,
+    });
 }
 
 void CompilationContext::AddDefinition(const Token &name_token,
                                        const Token &value_token) {
     auto data = ParsePackedIntegral(value_token.View());
     Log("Adding definition '{}' = '{}'", name_token.String(), ToHex(data, ""));
-    if (program.FindAlias(name_token.String()) != nullptr) {
+    if (program.FindAlias(name_token.View()) != nullptr) {
         ThrowCompilationError(CompilationError::AliasRedefinition, name_token);
     }
-    program.AddAlias(std::make_shared<ValueAlias>(ValueAlias{name_token.String(), data}));
+    program.AddAlias(ValueAlias{name_token.String(), data});
 }
 
-void CompilationContext::EmitBytes(const ByteVector &data) {
+void CompilationContext::EmitBytes(std::span<const uint8_t> data) {
     program.sparse_binary_code.PutBytes(current_position, data);
     current_position += static_cast<Address_t>(data.size());
 }
 
 void CompilationContext::UpdateRelocations() {
     for (const auto &relocation : program.relocations) {
-        auto symbol = relocation->target_symbol.lock();
-        if (!symbol) {
+        if (relocation.target_symbol >= program.symbols.size()) {
             ThrowCompilationError(CompilationError::InternalError, std::nullopt,
-                                  "Failed to relocate at {:04x}: target symbol expired",
-                                  relocation->position);
+                                  "Failed to relocate at {:04x}: unknown target symbol",
+                                  relocation.position);
+        }
+        auto &symbol = program.Target(relocation);
+        Log("Relocating reference to symbol '{}' at {}", symbol.name,
+            to_string(relocation, program.symbols));
+
+        switch (relocation.mode) {
+        case RelocationMode::Absolute: {
+            auto bytes = ToBytes(symbol.offset, std::nullopt);
+            program.sparse_binary_code.PutBytes(relocation.position, bytes, true);
+            break;
+        }
+        case RelocationMode::ZeroPage: {
+            auto bytes = ToBytes(symbol.offset, std::nullopt);
+            if (bytes.empty() || (bytes.size() > 1 && bytes[1] != 0)) {
+                ThrowCompilationError(
+                    CompilationError::InvalidOperandSize, std::nullopt,
+                    "Symbol '{}' referenced at {:04x} is not in zero page", symbol.name,
+                    relocation.position);
+            }
+            program.sparse_binary_code.PutByte(relocation.position, bytes[0], true);
+            break;
         }
-        Log("Relocating reference to symbol '{}' at {}", symbol->name,
-            to_string(relocation));
-
-        if (relocation->mode == RelocationMode::Absolute) {
-            auto bytes = ToBytes(symbol->offset, std::nullopt);
-            program.sparse_binary_code.PutBytes(relocation->position, bytes, true);
-        } else {
-            auto jump = RelativeJumpOffset(relocation->position + 1,
-                                           GetOr(symbol->offset, relocation->position));
-            program.sparse_binary_code.PutBytes(relocation->position, ToBytes(jump),
-                                                true);
+        case RelocationMode::Relative: {
+            auto jump = RelativeJumpOffset(relocation.position + 1,
+                                           GetOr(symbol.offset, relocation.position));
+            program.sparse_binary_code.PutBytes(relocation.position, ToBytes(jump), true);
+            break;
         }
+        }
+    }
+}
+
+void CompilationContext::Optimize() {
+    auto removed =
+        PeepholeOptimizer{program, verbose_stream}.Optimize(emitted_instructions);
+    Log("Peephole optimizer removed {} instructions", removed);
+}
+
+void CompilationContext::Relax(bool select_zero_page) {
+    auto result =
+        Relaxer{program, verbose_stream}.Relax(emitted_instructions, select_zero_page);
+    Log("Relaxation selected zero page for {} instructions, extended {} branches",
+        result.zero_page, result.long_branches);
+}
+
+Listing CompilationContext::GetListing() const {
+    Listing r;
+    for (auto &instruction : emitted_instructions) {
+        r.push_back(ListingEntry{
+            .position = instruction.position,
+            .opcode = instruction.opcode,
+            .location = instruction.location,
+        });
     }
+    return r;
 }
 
 void CompilationContext::AddDefinition(const SymbolDefinition &symbol) {
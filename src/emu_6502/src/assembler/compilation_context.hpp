@@ -2,15 +2,20 @@
 
 #include "emu_6502/assembler/compilation_error.hpp"
 #include "emu_6502/assembler/compiler.hpp"
+#include "emu_6502/assembler/keyword_map.hpp"
+#include "emu_6502/assembler/listing.hpp"
 #include "emu_6502/assembler/tokenizer.hpp"
 #include "emu_6502/instruction_set.hpp"
 #include "emu_core/program.hpp"
 #include "emu_core/symbol_factory.hpp"
+#include "emitted_instruction.hpp"
 #include <fmt/format.h>
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace emu::emu6502::assembler {
 
@@ -23,7 +28,7 @@ struct CompilationContext {
         CommandParserFunc handler;
     };
 
-    static const std::unordered_map<std::string, CommandParsingInfo> kCommandParseInfo;
+    static const KeywordMap<CommandParsingInfo, 5> kCommandParseInfo;
     static const std::unordered_map<std::string, Address_t> kIsrMap;
 
     void HandleCommand(const Token &command_token, LineTokenizer &line_tokenizer);
@@ -37,11 +42,24 @@ struct CompilationContext {
                          const InstructionParsingInfo &instruction);
 
     void UpdateRelocations();
+    void Optimize();
+    void Relax(bool select_zero_page);
+
+    // Keep source location of each instruction, required by GetListing
+    void SetRecordLocations(bool enable) { record_locations = enable; }
+    Listing GetListing() const;
+
+    // Files included by .incbin, in order of inclusion
+    const std::vector<std::string> &GetIncludedFiles() const { return included_files; }
 
 private:
     Program &program;
     std::ostream *const verbose_stream;
     Address_t current_position = 0;
+    std::vector<EmittedInstruction> emitted_instructions;
+    size_t region = 0;
+    bool record_locations = false;
+    std::vector<std::string> included_files;
 
     template <typename... ARGS>
     void Log(ARGS &&...args) {
@@ -56,6 +74,7 @@ private:
     void ParseAlignCommand(LineTokenizer &tokenizer);
     void ParseIsrCommand(LineTokenizer &tokenizer);
     void ParseSymbolCommand(LineTokenizer &tokenizer);
+    void ParseIncbinCommand(LineTokenizer &tokenizer);
 
     template <Address_t L>
     void ParseDataCommand(LineTokenizer &tokenizer) {
@@ -69,7 +88,7 @@ private:
     void PutSymbolReference(RelocationMode mode, const std::string &symbol,
                             Address_t position);
 
-    void EmitBytes(const ByteVector &data);
+    void EmitBytes(std::span<const uint8_t> data);
 };
 
 } // namespace emu::emu6502::assembler
@@ -42,6 +42,12 @@ std::string to_string(CompilationError error) {
         return "UnknownCommand";
     case CompilationError::InvalidOperandArgument:
         return "InvalidOperandArgument";
+    case CompilationError::MacroRedefinition:
+        return "MacroRedefinition";
+    case CompilationError::UnterminatedBlock:
+        return "UnterminatedBlock";
+    case CompilationError::ExpansionTooDeep:
+        return "ExpansionTooDeep";
     }
 
     return fmt::format("Invalid error id {}", static_cast<int>(error));
@@ -94,6 +100,13 @@ std::string GetDefaultMessage(CompilationError error, const Token &t) {
         return fmt::format("Invalid operand address mode");
     case CompilationError::InvalidCommandArgument:
         return fmt::format("Invalid operand argument");
+
+    case CompilationError::MacroRedefinition:
+        return fmt::format("Macro '{}' is already defined", t.View());
+    case CompilationError::UnterminatedBlock:
+        return fmt::format("Block started by '{}' is not terminated", t.View());
+    case CompilationError::ExpansionTooDeep:
+        return fmt::format("Expansion of '{}' is nested too deep", t.View());
     }
 
     return fmt::format("Unknown message for code {}", static_cast<int>(error));
@@ -2,9 +2,11 @@
 #include "compilation_context.hpp"
 #include "emu_6502/assembler/compilation_error.hpp"
 #include "emu_core/base16.hpp"
-#include "emu_core/container_utils.hpp"
-#include <fstream>
+#include "emu_core/text_utils.hpp"
+#include "macro_processor.hpp"
+#include <map>
 #include <sstream>
+#include <string_view>
 
 namespace emu::emu6502::assembler {
 
@@ -22,16 +24,27 @@ std::unique_ptr<Program> CompileFile(const std::string &file,
     return c.GetProgram();
 }
 
+namespace {
+
+template <typename Table>
+auto SortedByName(const Table &table) {
+    std::map<std::string_view, const typename Table::value_type *> sorted;
+    for (auto &entry : table) {
+        sorted.emplace(entry.name, &entry);
+    }
+    return sorted;
+}
+
+} // namespace
+
 std::string GenerateSymbolDump(Program &program) {
     std::stringstream ss;
     ss << ";Aliases:\n";
-    for (auto &name : SortedKeys(program.aliases)) {
-        auto ptr = program.aliases.at(name);
+    for (auto &[name, ptr] : SortedByName(program.aliases)) {
         ss << fmt::format("{} = {}\n", name, FormatHex(ptr->value, ""));
     }
     ss << ";Symbols:\n";
-    for (auto &name : SortedKeys(program.symbols)) {
-        auto ptr = program.symbols.at(name);
+    for (auto &[name, ptr] : SortedByName(program.symbols)) {
         auto hex = FormatHex(ToBytes(ptr->offset, std::nullopt), "");
         ss << fmt::format(".symbol {}, {}, {}\n", name, hex,
                           (ptr->imported ? "true" : "false"));
@@ -47,18 +60,51 @@ Compiler6502::Compiler6502(InstructionSet cpu_instruction_set,
     for (auto &[opcode, info] : GetInstructionSet(cpu_instruction_set)) {
         instruction_set[info.mnemonic].variants[info.addres_mode] = info;
     }
+
+    std::vector<std::pair<std::string_view, const InstructionParsingInfo *>> items;
+    for (auto &[mnemonic, info] : instruction_set) {
+        items.emplace_back(mnemonic, &info);
+    }
+    mnemonics = KeywordMap<const InstructionParsingInfo *, 10>{items};
 }
 
 Compiler6502::~Compiler6502() = default;
 
+std::unique_ptr<Program> Compiler6502::GetObject() {
+    if (!program) {
+        throw std::runtime_error("No compiled program available");
+    }
+
+    if (optimize) {
+        context->Optimize();
+    }
+    context->Relax(optimize);
+    if (listing_enabled) {
+        listing = context->GetListing();
+    }
+    included_files = context->GetIncludedFiles();
+    context.reset();
+    macros.reset();
+    return std::move(program);
+}
+
 std::unique_ptr<Program> Compiler6502::GetProgram() {
     if (!program) {
         throw std::runtime_error("No compiled program available");
     }
 
+    if (optimize) {
+        context->Optimize();
+    }
+    context->Relax(optimize);
     context->UpdateRelocations();
+    if (listing_enabled) {
+        listing = context->GetListing();
+    }
+    included_files = context->GetIncludedFiles();
 
     context.reset();
+    macros.reset();
     return std::move(program);
 }
 
@@ -67,8 +113,9 @@ void Compiler6502::Compile(Tokenizer &tokenizer) {
 
     while (tokenizer.HasInput()) {
         auto line = tokenizer.NextLine();
-        ProcessLine(line);
+        HandleLine(line);
     }
+    macros->EndOfInput();
 }
 
 void Compiler6502::Compile(std::istream &stream, const std::string &name) {
@@ -77,15 +124,21 @@ void Compiler6502::Compile(std::istream &stream, const std::string &name) {
 }
 
 void Compiler6502::CompileString(std::string text, const std::string &name) {
-    std::istringstream ss(text);
-    ss.exceptions(std::ifstream::badbit);
-    Compile(ss, name);
+    auto tokenizer = Tokenizer(SourceBuffer::FromString(std::move(text), name));
+    Compile(tokenizer);
 }
 
 void Compiler6502::CompileFile(const std::string &file) {
-    std::ifstream ss(file, std::ios::in);
-    ss.exceptions(std::ifstream::badbit);
-    Compile(ss, file);
+    auto tokenizer = Tokenizer(SourceBuffer::MapFile(file));
+    Compile(tokenizer);
+}
+
+void Compiler6502::HandleLine(LineTokenizer &line) {
+    if (macros->IsRecording()) {
+        macros->Record(line);
+    } else {
+        ProcessLine(line);
+    }
 }
 
 void Compiler6502::ProcessLine(LineTokenizer &line) {
@@ -102,14 +155,18 @@ void Compiler6502::ProcessLine(LineTokenizer &line) {
                 continue;
             }
             if (first_token_view.starts_with(".")) {
-                context->HandleCommand(first_token, line);
+                if (!macros->HandleCommand(first_token, line)) {
+                    context->HandleCommand(first_token, line);
+                }
                 continue;
             }
         }
         {
-            auto op_handler = instruction_set.find(first_token.Upper());
-            if (op_handler != instruction_set.end()) {
-                context->EmitInstruction(line, op_handler->second);
+            if (auto *op_handler = mnemonics.Find(first_token.View()); op_handler != nullptr) {
+                context->EmitInstruction(line, **op_handler);
+                continue;
+            }
+            if (macros->Expand(first_token, line)) {
                 continue;
             }
         }
@@ -133,7 +190,7 @@ void Compiler6502::ProcessLine(LineTokenizer &line) {
 
 bool Compiler6502::TryDefinition(const Token &first_token, LineTokenizer &line) {
     auto second_token = line.NextToken();
-    if (second_token == "=" || second_token.Lower() == "equ") {
+    if (second_token == "=" || EqualsIgnoreCase(second_token.View(), "equ")) {
         if (!line.HasInput()) {
             ThrowCompilationError(CompilationError::UnexpectedEndOfInput, second_token);
         }
@@ -155,6 +212,17 @@ void Compiler6502::Start() {
     if (!program) {
         program = std::make_unique<Program>();
         context = std::make_unique<CompilationContext>(*program, verbose_stream);
+        context->SetRecordLocations(listing_enabled);
+        macros = std::make_unique<MacroProcessor>(
+            [this](LineTokenizer &line) { HandleLine(line); },
+            [this](std::string_view name) { return mnemonics.Find(name) != nullptr; });
+    }
+}
+
+void Compiler6502::SetListing(bool enable) {
+    listing_enabled = enable;
+    if (context) {
+        context->SetRecordLocations(enable);
     }
 }
 
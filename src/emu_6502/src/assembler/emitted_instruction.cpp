@@ -0,0 +1,68 @@
+#include "emitted_instruction.hpp"
+#include <limits>
+#include <string_view>
+
+namespace emu::emu6502::assembler {
+
+namespace {
+
+bool FallsThrough(std::string_view mnemonic) {
+    return mnemonic != "JMP" && mnemonic != "RTS" && mnemonic != "RTI";
+}
+
+} // namespace
+
+RelocationMap MapRelocations(Program &program) {
+    RelocationMap r;
+    for (auto &relocation : program.relocations) {
+        r[relocation.position] = &relocation;
+    }
+    return r;
+}
+
+std::vector<std::span<EmittedInstruction>>
+SplitBlocks(std::vector<EmittedInstruction> &instructions) {
+    std::vector<std::span<EmittedInstruction>> r;
+    size_t begin = 0;
+    for (size_t i = 1; i <= instructions.size(); ++i) {
+        if (i == instructions.size() ||
+            instructions[i].region != instructions[i - 1].region ||
+            instructions[i].position != instructions[i - 1].End()) {
+            r.emplace_back(instructions.data() + begin, i - begin);
+            begin = i;
+        }
+    }
+    return r;
+}
+
+bool CanMoveBlock(const Program &program, const RelocationMap &relocations,
+                  std::span<const EmittedInstruction> block) {
+    auto &code = program.sparse_binary_code;
+    auto start = block.front().position;
+    auto end = block.back().End();
+
+    for (auto &instruction : block) {
+        auto &opcode = instruction.opcode;
+        auto operand = static_cast<Address_t>(instruction.position + 1);
+        if (relocations.contains(operand)) {
+            continue;
+        }
+        if (opcode.addres_mode == AddressMode::REL) {
+            return false;
+        }
+        if ((opcode.mnemonic == "JMP" || opcode.mnemonic == "JSR") &&
+            opcode.addres_mode == AddressMode::ABS) {
+            auto target =
+                code.At(operand) | (code.At(static_cast<Address_t>(operand + 1)) << 8);
+            if (target >= start && target < end) {
+                return false;
+            }
+        }
+    }
+
+    return !FallsThrough(block.back().opcode.mnemonic) ||
+           end > std::numeric_limits<Address_t>::max() ||
+           !code.Contains(static_cast<Address_t>(end));
+}
+
+} // namespace emu::emu6502::assembler
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "emu_6502/assembler/compiler.hpp"
+#include "emu_6502/instruction_set.hpp"
+#include "emu_core/program.hpp"
+#include <map>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace emu::emu6502::assembler {
+
+struct EmittedInstruction {
+    Address_t position;
+    OpcodeInfo opcode;
+    // Instructions from different regions (separated by any directive) are never
+    // treated as one block of code
+    size_t region;
+    // All address modes of the mnemonic, null if instruction cannot be re-encoded
+    const InstructionParsingInfo *variants = nullptr;
+    // Source of instruction, recorded only for listing
+    TokenLocation location = {};
+
+    [[nodiscard]] Address_t Size() const {
+        return static_cast<Address_t>(1 + ArgumentByteSize(opcode.addres_mode));
+    }
+    [[nodiscard]] int End() const { return position + Size(); }
+};
+
+// Points into relocations of program, valid until relocation is added or removed
+using RelocationMap = std::map<Address_t, RelocationInfo *>;
+RelocationMap MapRelocations(Program &program);
+
+// Splits instructions into blocks of adjacent instructions from the same region
+std::vector<std::span<EmittedInstruction>>
+SplitBlocks(std::vector<EmittedInstruction> &instructions);
+
+// Code of the block can be moved if all relative jumps refer to labels, no jump by
+// value targets the block and the last instruction does not fall through into
+// adjacent bytes
+bool CanMoveBlock(const Program &program, const RelocationMap &relocations,
+                  std::span<const EmittedInstruction> block);
+
+} // namespace emu::emu6502::assembler
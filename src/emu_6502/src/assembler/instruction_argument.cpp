@@ -2,13 +2,15 @@
 #include "emu_6502/assembler/compilation_error.hpp"
 #include "emu_core/byte_utils.hpp"
 #include "emu_core/text_utils.hpp"
+#include <algorithm>
 #include <charconv>
 #include <cinttypes>
 #include <fmt/format.h>
 #include <limits>
-#include <regex>
+#include <optional>
 #include <stdexcept>
 #include <string_view>
+#include <tuple>
 
 namespace emu::emu6502::assembler {
 
@@ -23,7 +25,7 @@ std::set<AddressMode> FilterPossibleModes(const std::set<AddressMode> &modes,
     return r;
 }
 
-ByteVector ParseImmediateValue(std::string_view data, const AliasMap &aliases,
+ByteVector ParseImmediateValue(std::string_view data, const AliasTable &aliases,
                                std::optional<size_t> expected_size) {
     auto check = [&](ByteVector v) {
         if (expected_size.has_value() && v.size() != expected_size.value()) {
@@ -35,8 +37,8 @@ ByteVector ParseImmediateValue(std::string_view data, const AliasMap &aliases,
     };
 
     if (!data.starts_with("$")) {
-        if (const auto it = aliases.find(std::string(data)); it != aliases.end()) {
-            return check(it->second->value);
+        if (const auto *alias = aliases.Find(data); alias != nullptr) {
+            return check(alias->value);
         }
 
         if (data.starts_with("\"")) {
@@ -95,8 +97,76 @@ std::string to_string(const InstructionArgument &ia) {
     return r;
 }
 
+namespace {
+
+bool IsOperandValueChar(char c) {
+    return c == '$' || c == '_' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+           (c >= 'A' && c <= 'Z');
+}
+
+using OperandMatch = std::tuple<std::string_view, const std::set<AddressMode> *>;
+
+// Value and possible address modes of operand, nullopt if format is not recognized.
+// Value is a non empty sequence of [$0-9A-Za-z_].
+std::optional<OperandMatch> ClassifyOperand(std::string_view text) {
+    using AM = AddressMode;
+    // | Immediate           |          #aa             |
+    static const std::set<AM> kImmediate = {AM::Immediate};
+    // | Absolute            |          aaaa            |
+    // | Zero Page           |          aa              |
+    // | Relative            |          aaaa            |
+    static const std::set<AM> kAbsolute = {AM::ABS, AM::ZP, AM::REL};
+    // | Indirect Absolute   |          (aaaa)          |
+    static const std::set<AM> kIndirect = {AM::ABS_IND};
+    // | Zero Page Indexed,X |          aa,X            |
+    // | Absolute Indexed,X  |          aaaa,X          |
+    static const std::set<AM> kIndexedX = {AM::ABSX, AM::ZPX};
+    // | Zero Page Indexed,Y |          aa,Y            |
+    // | Absolute Indexed,Y  |          aaaa,Y          |
+    static const std::set<AM> kIndexedY = {AM::ABSY, AM::ZPY};
+    // | Indexed Indirect    |          (aa,X)          |
+    static const std::set<AM> kIndexedIndirect = {AM::INDX};
+    // | Indirect Indexed    |          (aa),Y          |
+    static const std::set<AM> kIndirectIndexed = {AM::INDY};
+
+    bool immediate = text.starts_with('#');
+    bool indirect = text.starts_with('(');
+    if (immediate || indirect) {
+        text.remove_prefix(1);
+    }
+
+    auto length = std::find_if_not(text.begin(), text.end(), IsOperandValueChar) - text.begin();
+    if (length == 0) {
+        return std::nullopt;
+    }
+    auto value = text.substr(0, static_cast<size_t>(length));
+    auto rest = text.substr(static_cast<size_t>(length));
+
+    const std::set<AM> *modes = nullptr;
+    if (immediate) {
+        modes = rest.empty() ? &kImmediate : nullptr;
+    } else if (indirect) {
+        modes = rest == ")"     ? &kIndirect
+                : rest == ",X)" ? &kIndexedIndirect
+                : rest == "),Y" ? &kIndirectIndexed
+                                : nullptr;
+    } else {
+        modes = rest.empty()   ? &kAbsolute
+                : rest == ",X" ? &kIndexedX
+                : rest == ",Y" ? &kIndexedY
+                               : nullptr;
+    }
+
+    if (modes == nullptr) {
+        return std::nullopt;
+    }
+    return OperandMatch{value, modes};
+}
+
+} // namespace
+
 InstructionArgument ParseInstructionArgument(const Token &token,
-                                             const AliasMap &aliases) {
+                                             const AliasTable &aliases) {
     // +---------------------+--------------------------+
     // |      mode           |     assembler format     |
     // +=====================+==========================+
@@ -117,82 +187,47 @@ InstructionArgument ParseInstructionArgument(const Token &token,
         };
     }
 
-    using AM = AddressMode;
-    const std::vector<std::tuple<std::regex, std::set<AM>>> fmt_regex = {
-        // | Immediate           |          #aa             |
-        {std::regex{R"==(^#([$\w]+)$)=="}, {AM::Immediate}},
-
-        // | Absolute            |          aaaa            |
-        // | Zero Page           |          aa              |
-        // | Relative            |          aaaa            |
-        {std::regex{R"==(^([$\w]+)$)=="}, {AM::ABS, AM::ZP, AM::REL}},
-
-        // | Indirect Absolute   |          (aaaa)          |
-        {std::regex{R"==(^\(([$\w]+)\)$)=="}, {AM::ABS_IND}},
-
-        // | Zero Page Indexed,X |          aa,X            |
-        // | Absolute Indexed,X  |          aaaa,X          |
-        {std::regex{R"==(^([$\w]+),X$)=="}, {AM::ABSX, AM::ZPX}},
-
-        // | Zero Page Indexed,Y |          aa,Y            |
-        // | Absolute Indexed,Y  |          aaaa,Y          |
-        {std::regex{R"==(^([$\w]+),Y$)=="}, {AM::ABSY, AM::ZPY}},
-
-        // | Indexed Indirect    |          (aa,X)          |
-        {std::regex{R"==(^\(([$\w]+),X\)$)=="}, {AM::INDX}},
-
-        // | Indirect Indexed    |          (aa),Y          |
-        {std::regex{R"==(^\(([$\w]+)\),Y$)=="}, {AM::INDY}},
-    };
+    auto operand = ClassifyOperand(token.View());
+    if (!operand.has_value()) {
+        ThrowCompilationError(CompilationError::InvalidOperandArgument, token);
+    }
 
-    for (const auto &[regex, matched_modes] : fmt_regex) {
-        std::smatch match;
-        const auto &str = token.String();
-        if (std::regex_match(str, match, regex)) {
-            std::string s_value = match[1];
-            auto value = std::string_view(s_value);
-
-            if (value.empty()) {
-                throw std::runtime_error("Failed to match operand argument with regex");
-            }
-
-            InstructionArgument ia;
-
-            if (value.starts_with("$")) {
-                std::vector<uint8_t> data = ParseImmediateValue(value, aliases);
-                auto possible_address_modes = matched_modes;
-                possible_address_modes.erase(AM::REL);
-                ia = InstructionArgument{
-                    .possible_address_modes =
-                        FilterPossibleModes(possible_address_modes, data.size()),
-                    .argument_value = data,
-                };
-            } else {
-                if (auto it = aliases.find(s_value); it != aliases.end()) {
-                    auto possible_address_modes = matched_modes;
-                    possible_address_modes.erase(AM::REL);
-                    const auto &v = it->second->value;
-                    ia = InstructionArgument{
-                        .possible_address_modes =
-                            FilterPossibleModes(possible_address_modes, v.size()),
-                        .argument_value = v,
-                    };
-                } else {
-                    ia = InstructionArgument{
-                        .possible_address_modes = matched_modes,
-                        .argument_value = s_value,
-                    };
-                }
-            }
-
-            if (ia.possible_address_modes.empty()) {
-                ThrowCompilationError(CompilationError::InvalidOperandArgument, token);
-            }
-            return ia;
+    using AM = AddressMode;
+    auto [value, matched_modes] = *operand;
+    InstructionArgument ia;
+
+    if (value.starts_with("$")) {
+        std::vector<uint8_t> data = ParseImmediateValue(value, aliases);
+        auto possible_address_modes = *matched_modes;
+        possible_address_modes.erase(AM::REL);
+        ia = InstructionArgument{
+            .possible_address_modes =
+                FilterPossibleModes(possible_address_modes, data.size()),
+            .argument_value = data,
+        };
+    } else {
+        std::string s_value{value};
+        if (const auto *alias = aliases.Find(s_value); alias != nullptr) {
+            auto possible_address_modes = *matched_modes;
+            possible_address_modes.erase(AM::REL);
+            const auto &v = alias->value;
+            ia = InstructionArgument{
+                .possible_address_modes =
+                    FilterPossibleModes(possible_address_modes, v.size()),
+                .argument_value = v,
+            };
+        } else {
+            ia = InstructionArgument{
+                .possible_address_modes = *matched_modes,
+                .argument_value = std::move(s_value),
+            };
         }
     }
 
-    ThrowCompilationError(CompilationError::InvalidOperandArgument, token);
+    if (ia.possible_address_modes.empty()) {
+        ThrowCompilationError(CompilationError::InvalidOperandArgument, token);
+    }
+    return ia;
 }
 
 std::string to_string(TokenType tt) {
@@ -217,8 +252,8 @@ TokenType GetTokenType(const Token &value_token, const Program &program) {
     return GetTokenType(value_token, &program.aliases, &program.symbols);
 }
 
-TokenType GetTokenType(const Token &value_token, const AliasMap *aliases,
-                       const SymbolMap *symbols) {
+TokenType GetTokenType(const Token &value_token, const AliasTable *aliases,
+                       const SymbolTable *symbols) {
     auto sv = value_token.View();
     if (sv.starts_with("0x") || sv.starts_with("0X") || sv.starts_with("\"") ||
         sv.starts_with("$")) {
@@ -229,12 +264,11 @@ TokenType GetTokenType(const Token &value_token, const AliasMap *aliases,
         return TokenType::kValue;
     }
 
-    auto text = std::string(sv);
-    if (aliases != nullptr && aliases->contains(text)) {
+    if (aliases != nullptr && aliases->contains(sv)) {
         return TokenType::kAlias;
     }
 
-    if (symbols != nullptr && symbols->contains(text)) {
+    if (symbols != nullptr && symbols->contains(sv)) {
         return TokenType::kSymbol;
     }
 
@@ -29,9 +29,10 @@ struct InstructionArgument {
 
 std::string to_string(const InstructionArgument &ia);
 
-InstructionArgument ParseInstructionArgument(const Token &token, const AliasMap &aliases);
+InstructionArgument ParseInstructionArgument(const Token &token,
+                                             const AliasTable &aliases);
 
-ByteVector ParseImmediateValue(std::string_view data, const AliasMap &aliases,
+ByteVector ParseImmediateValue(std::string_view data, const AliasTable &aliases,
                                std::optional<size_t> expected_size = std::nullopt);
 ByteVector ParseTextValue(const Token &token, bool include_trailing_zero);
 
@@ -45,8 +46,8 @@ enum class TokenType {
 std::string to_string(TokenType tt);
 std::ostream &operator<<(std::ostream &o, TokenType tt);
 
-TokenType GetTokenType(const Token &value_token, const AliasMap *aliases,
-                       const SymbolMap *symbols);
+TokenType GetTokenType(const Token &value_token, const AliasTable *aliases,
+                       const SymbolTable *symbols);
 TokenType GetTokenType(const Token &value_token, const Program &program);
 
 } // namespace emu::emu6502::assembler
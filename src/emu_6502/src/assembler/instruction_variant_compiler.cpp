@@ -29,8 +29,8 @@ std::set<AddressMode> InstructionVariantSelector::Select(std::nullptr_t) const {
 
 std::set<AddressMode>
 InstructionVariantSelector::Select(const std::string &symbol) const {
-    if (const auto it = aliases.find(symbol); it != aliases.end()) {
-        return FilterPossibleModes(possible_address_modes, it->second->value.size());
+    if (const auto *alias = aliases.Find(symbol); alias != nullptr) {
+        return FilterPossibleModes(possible_address_modes, alias->value.size());
     } else {
         if (possible_address_modes.contains(AddressMode::REL)) {
             return possible_address_modes;
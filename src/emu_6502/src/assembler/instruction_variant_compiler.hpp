@@ -14,7 +14,7 @@ namespace emu::emu6502::assembler {
 struct InstructionVariantSelector {
     std::set<AddressMode> possible_address_modes;
     const Token &token;
-    const AliasMap &aliases;
+    const AliasTable &aliases;
 
     AddressMode DispatchSelect(const ArgumentValueVariant &arg_variant) const;
 
@@ -0,0 +1,89 @@
+#include "emu_6502/assembler/linker.hpp"
+#include "compilation_context.hpp"
+#include <fmt/format.h>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace emu::emu6502::assembler {
+
+void Linker::AddObject(std::unique_ptr<Program> object, std::string name) {
+    if (!object) {
+        throw std::invalid_argument(fmt::format("Object '{}' is empty", name));
+    }
+    objects.emplace_back(Object{std::move(object), std::move(name)});
+}
+
+std::unique_ptr<Program> Linker::Link() {
+    auto result = std::make_unique<Program>();
+    std::unordered_map<std::string, const std::string *> symbol_owner;
+
+    for (auto &[object, name] : objects) {
+        Log("Linking object '{}'", name);
+
+        auto &code = result->sparse_binary_code;
+        for (auto &[address, bytes] : object->sparse_binary_code.Ranges()) {
+            if (auto occupied = code.FindOccupied(address, bytes.size())) {
+                throw std::runtime_error(fmt::format(
+                    "Code of '{}' at {:04x} overlaps code of previous object", name,
+                    *occupied));
+            }
+            code.PutBytes(address, bytes);
+        }
+
+        // Ids of object symbols in the result
+        std::vector<SymbolId> resolved;
+        resolved.reserve(object->symbols.size());
+        for (auto &symbol : object->symbols) {
+            auto &symbol_name = symbol.name;
+            auto id = result->FindSymbolId(symbol_name);
+            if (!id.has_value()) {
+                id = result->AddSymbol(symbol);
+            } else if (auto &target = result->symbols[*id]; !symbol.imported) {
+                if (!target.imported) {
+                    throw std::runtime_error(
+                        fmt::format("Symbol '{}' defined in '{}' is already defined in '{}'",
+                                    symbol_name, name, *symbol_owner.at(symbol_name)));
+                }
+                Log("Resolving symbol '{}' with definition from '{}'", symbol_name, name);
+                target.offset = symbol.offset;
+                target.segment = symbol.segment;
+                target.imported = false;
+            } else if (!HasValue(target.offset) && HasValue(symbol.offset)) {
+                target.offset = symbol.offset;
+                target.segment = symbol.segment;
+            }
+            if (!symbol.imported) {
+                symbol_owner[symbol_name] = &name;
+            }
+            resolved.push_back(*id);
+        }
+
+        for (auto &alias : object->aliases) {
+            if (result->FindAlias(alias.name) == nullptr) {
+                result->AddAlias(alias);
+            }
+        }
+
+        auto &relocations = result->relocations;
+        relocations.reserve(relocations.size() + object->relocations.size());
+        for (auto &relocation : object->relocations) {
+            if (relocation.target_symbol >= resolved.size()) {
+                throw std::runtime_error(fmt::format(
+                    "Object '{}' has relocation at {:04x} to unknown symbol", name,
+                    relocation.position));
+            }
+            relocations.push_back(RelocationInfo{
+                .target_symbol = resolved[relocation.target_symbol],
+                .position = relocation.position,
+                .mode = relocation.mode,
+            });
+        }
+    }
+    objects.clear();
+
+    CompilationContext{*result, verbose_stream}.UpdateRelocations();
+    return result;
+}
+
+} // namespace emu::emu6502::assembler
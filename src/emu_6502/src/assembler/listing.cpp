@@ -0,0 +1,206 @@
+#include "emu_6502/assembler/listing.hpp"
+#include "emu_core/base16.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fmt/format.h>
+#include <limits>
+#include <map>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string_view>
+
+namespace emu::emu6502::assembler {
+
+namespace {
+
+struct Cycles {
+    unsigned min = 0;
+    unsigned max = 0;
+
+    Cycles &operator+=(const Cycles &other) {
+        min += other.min;
+        max += other.max;
+        return *this;
+    }
+};
+
+std::string to_string(const Cycles &cycles) {
+    if (cycles.min == cycles.max) {
+        return fmt::format("{}", cycles.min);
+    }
+    return fmt::format("{}-{}", cycles.min, cycles.max);
+}
+
+int Size(const ListingEntry &entry) {
+    return static_cast<int>(1 + ArgumentByteSize(entry.opcode.addres_mode));
+}
+
+int End(const ListingEntry &entry) {
+    return entry.position + Size(entry);
+}
+
+bool EndsBlock(const OpcodeInfo &opcode) {
+    return opcode.addres_mode == AddressMode::REL || opcode.mnemonic == "JMP" ||
+           opcode.mnemonic == "RTS" || opcode.mnemonic == "RTI" ||
+           opcode.mnemonic == "BRK";
+}
+
+std::optional<uint8_t> ByteAt(const Program &program, int address) {
+    if (address > std::numeric_limits<Address_t>::max()) {
+        return std::nullopt;
+    }
+    return program.sparse_binary_code.Get(static_cast<Address_t>(address));
+}
+
+// Target of branch or JMP by absolute address, if it is known from the operand
+std::optional<int> JumpTarget(const Program &program, const ListingEntry &entry) {
+    if (entry.opcode.addres_mode == AddressMode::REL) {
+        auto offset = ByteAt(program, entry.position + 1);
+        if (!offset.has_value()) {
+            return std::nullopt;
+        }
+        return End(entry) + static_cast<int8_t>(*offset);
+    }
+    if (entry.opcode.mnemonic == "JMP" && entry.opcode.addres_mode == AddressMode::ABS) {
+        auto low = ByteAt(program, entry.position + 1);
+        auto high = ByteAt(program, entry.position + 2);
+        if (!low.has_value() || !high.has_value()) {
+            return std::nullopt;
+        }
+        return *low | (*high << 8);
+    }
+    return std::nullopt;
+}
+
+// Extra cycles of taken branch
+unsigned BranchTakenCycles(const Program &program, const ListingEntry &entry) {
+    auto target = JumpTarget(program, entry);
+    if (!target.has_value()) {
+        return 2;
+    }
+    return (*target & 0xFF00) != (End(entry) & 0xFF00) ? 2 : 1;
+}
+
+Cycles EntryCycles(const Program &program, const ListingEntry &entry) {
+    auto timing = GetInstructionTiming(entry.opcode);
+    Cycles r{timing.cycles, timing.cycles};
+    if (timing.page_cross_penalty) {
+        ++r.max;
+    }
+    if (timing.branch) {
+        r.max += BranchTakenCycles(program, entry);
+    }
+    return r;
+}
+
+// Straight path from first entry to the last one, which is taken back to the first
+std::optional<Cycles> LoopCycles(const Program &program,
+                                 std::span<const ListingEntry> entries) {
+    Cycles r;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i > 0 && entries[i].position != End(entries[i - 1])) {
+            return std::nullopt;
+        }
+        auto timing = GetInstructionTiming(entries[i].opcode);
+        r += Cycles{timing.cycles, timing.cycles + (timing.page_cross_penalty ? 1u : 0u)};
+    }
+    if (GetInstructionTiming(entries.back().opcode).branch) {
+        auto taken = BranchTakenCycles(program, entries.back());
+        r += Cycles{taken, taken};
+    }
+    return r;
+}
+
+std::string_view Trimmed(std::string_view text) {
+    auto begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    auto end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+} // namespace
+
+std::string FormatListing(const Program &program, const Listing &listing) {
+    Listing entries = listing;
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](auto &a, auto &b) { return a.position < b.position; });
+
+    std::multimap<Address_t, std::string> labels;
+    for (auto &symbol : program.symbols) {
+        if (!symbol.imported && std::holds_alternative<uint16_t>(symbol.offset)) {
+            labels.emplace(std::get<uint16_t>(symbol.offset), symbol.name);
+        }
+    }
+
+    // Closing instruction index -> loop label and its cycles
+    std::multimap<size_t, std::pair<std::string, Cycles>> loops;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto [begin, end] = labels.equal_range(entries[i].position);
+        if (begin == end) {
+            continue;
+        }
+        for (size_t j = i; j < entries.size(); ++j) {
+            if (JumpTarget(program, entries[j]) != entries[i].position) {
+                continue;
+            }
+            auto span = std::span<const ListingEntry>{entries}.subspan(i, j - i + 1);
+            if (auto cycles = LoopCycles(program, span); cycles.has_value()) {
+                for (auto it = begin; it != end; ++it) {
+                    loops.emplace(j, std::pair{it->second, *cycles});
+                }
+            }
+            break;
+        }
+    }
+
+    std::stringstream ss;
+    std::string_view input_name;
+    Cycles block;
+    std::optional<Address_t> block_start;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto &entry = entries[i];
+        if (i == 0 || entry.location.InputName() != input_name) {
+            input_name = entry.location.InputName();
+            ss << fmt::format("; {}\n", input_name);
+        }
+
+        if (!block_start.has_value()) {
+            block_start = entry.position;
+        }
+        auto [label_begin, label_end] = labels.equal_range(entry.position);
+        for (auto it = label_begin; it != label_end; ++it) {
+            ss << it->second << ":\n";
+        }
+
+        ByteVector bytes;
+        for (int address = entry.position; address < End(entry); ++address) {
+            bytes.push_back(ByteAt(program, address).value_or(0));
+        }
+        auto cycles = EntryCycles(program, entry);
+        block += cycles;
+        ss << fmt::format("{:04x}  {:<9} {:<5} {}\n", entry.position, ToHex(bytes),
+                          to_string(cycles), Trimmed(entry.location.LineContent()));
+
+        auto [loop_begin, loop_end] = loops.equal_range(i);
+        for (auto it = loop_begin; it != loop_end; ++it) {
+            ss << fmt::format("; loop {}: {} cycles per iteration\n", it->second.first,
+                              to_string(it->second.second));
+        }
+
+        auto next = i + 1;
+        if (next == entries.size() || EndsBlock(entry.opcode) ||
+            entries[next].position != End(entry) ||
+            labels.contains(entries[next].position)) {
+            ss << fmt::format("; block {:04x}-{:04x}: {} cycles\n", *block_start,
+                              End(entry) - 1, to_string(block));
+            block = {};
+            block_start.reset();
+        }
+    }
+    return ss.str();
+}
+
+} // namespace emu::emu6502::assembler
@@ -0,0 +1,245 @@
+#include "macro_processor.hpp"
+#include "emu_6502/assembler/compilation_error.hpp"
+#include "emu_core/byte_utils.hpp"
+#include "emu_core/text_utils.hpp"
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+namespace emu::emu6502::assembler {
+
+namespace {
+
+bool IsIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_';
+}
+
+bool IsBlockStart(std::string_view command) {
+    return EqualsIgnoreCase(command, ".macro") || EqualsIgnoreCase(command, ".rept");
+}
+
+bool IsBlockEnd(std::string_view command) {
+    return EqualsIgnoreCase(command, ".endm") || EqualsIgnoreCase(command, ".endr");
+}
+
+bool IsRegisterName(std::string_view name) {
+    return EqualsIgnoreCase(name, "A") || EqualsIgnoreCase(name, "X") ||
+           EqualsIgnoreCase(name, "Y");
+}
+
+// Empty unique_id leaves \@ in place, it belongs to a nested block
+Token Substitute(const Token &token, const std::vector<std::string> &parameters,
+                 const std::vector<Token> &arguments, std::string_view unique_id) {
+    auto view = token.View();
+    if (view.starts_with('"')) {
+        return token;
+    }
+
+    std::string result;
+    bool substituted = false;
+    for (size_t pos = 0; pos < view.size();) {
+        if (!unique_id.empty() && view.substr(pos).starts_with("\\@")) {
+            result += unique_id;
+            substituted = true;
+            pos += 2;
+            continue;
+        }
+        if (!IsIdentifierChar(view[pos])) {
+            result += view[pos++];
+            continue;
+        }
+        auto end = pos;
+        while (end < view.size() && IsIdentifierChar(view[end])) {
+            ++end;
+        }
+        auto word = view.substr(pos, end - pos);
+        if (auto it = std::find(parameters.begin(), parameters.end(), word);
+            it != parameters.end()) {
+            auto &argument = arguments[static_cast<size_t>(it - parameters.begin())];
+            if (word.size() == view.size()) {
+                return argument;
+            }
+            result += argument.View();
+            substituted = true;
+        } else {
+            result += word;
+        }
+        pos = end;
+    }
+    return substituted ? Token{token.location, std::move(result)} : token;
+}
+
+} // namespace
+
+void MacroProcessor::Record(LineTokenizer &line) {
+    Line tokens;
+    while (line.HasInput()) {
+        auto &token = tokens.emplace_back(line.NextToken());
+        token.Detach();
+    }
+
+    // Labels may precede block commands
+    auto command = std::find_if(tokens.begin(), tokens.end(),
+                                [](auto &t) { return !t.View().ends_with(':'); });
+    if (command != tokens.end() && IsBlockStart(command->View())) {
+        ++recording->nesting;
+    } else if (command != tokens.end() && IsBlockEnd(command->View())) {
+        if (recording->nesting == 0) {
+            auto expected_end = recording->name.empty() ? ".endr" : ".endm";
+            if (!EqualsIgnoreCase(command->View(), expected_end)) {
+                ThrowCompilationError(CompilationError::InvalidToken, *command);
+            }
+            if (command != tokens.begin() || tokens.size() > 1) {
+                ThrowCompilationError(CompilationError::UnexpectedInput, tokens[1]);
+            }
+
+            auto finished = std::move(*recording);
+            recording.reset();
+            if (finished.name.empty()) {
+                for (size_t i = 0; i < finished.repeat; ++i) {
+                    Replay(finished.start, finished.macro, {});
+                }
+            } else if (!macros.emplace(finished.name, std::move(finished.macro)).second) {
+                ThrowCompilationError(CompilationError::MacroRedefinition,
+                                      finished.start);
+            }
+            return;
+        }
+        --recording->nesting;
+    }
+
+    if (!tokens.empty()) {
+        recording->macro.lines.emplace_back(std::move(tokens));
+    }
+}
+
+bool MacroProcessor::HandleCommand(const Token &command_token, LineTokenizer &line) {
+    auto command = command_token.View();
+    if (EqualsIgnoreCase(command, ".macro")) {
+        BeginMacro(command_token, line);
+        return true;
+    }
+    if (EqualsIgnoreCase(command, ".rept")) {
+        BeginRepeat(command_token, line);
+        return true;
+    }
+    if (IsBlockEnd(command)) {
+        ThrowCompilationError(CompilationError::UnexpectedInput, command_token);
+    }
+    return false;
+}
+
+bool MacroProcessor::Expand(const Token &name_token, LineTokenizer &line) {
+    auto it = macros.find(name_token.String());
+    if (it == macros.end()) {
+        return false;
+    }
+
+    auto &macro = it->second;
+    auto arguments = line.TokenList(",").Vector();
+    if (arguments.size() != macro.parameters.size()) {
+        ThrowCompilationError(CompilationError::InvalidCommandArgument, name_token,
+                              "Macro '{}' expects {} arguments, {} given",
+                              name_token.View(), macro.parameters.size(),
+                              arguments.size());
+    }
+    Replay(name_token, macro, arguments);
+    return true;
+}
+
+void MacroProcessor::EndOfInput() const {
+    if (recording.has_value()) {
+        ThrowCompilationError(CompilationError::UnterminatedBlock, recording->start);
+    }
+}
+
+void MacroProcessor::BeginMacro(const Token &command_token, LineTokenizer &line) {
+    auto name = line.NextToken();
+    if (!name) {
+        ThrowCompilationError(CompilationError::UnexpectedEndOfInput, command_token);
+    }
+    if (!std::all_of(name.value.begin(), name.value.end(), IsIdentifierChar) ||
+        is_reserved(name.View())) {
+        ThrowCompilationError(CompilationError::InvalidCommandArgument, name,
+                              "'{}' cannot be used as macro name", name.View());
+    }
+    if (macros.contains(name.String())) {
+        ThrowCompilationError(CompilationError::MacroRedefinition, name);
+    }
+
+    Macro macro;
+    for (auto tok : line.TokenList(",")) {
+        auto &parameters = macro.parameters;
+        if (!std::all_of(tok.value.begin(), tok.value.end(), IsIdentifierChar) ||
+            IsRegisterName(tok.View()) ||
+            std::find(parameters.begin(), parameters.end(), tok.View()) !=
+                parameters.end()) {
+            ThrowCompilationError(CompilationError::InvalidCommandArgument, tok,
+                                  "'{}' cannot be used as macro parameter", tok.View());
+        }
+        parameters.emplace_back(tok.String());
+    }
+
+    recording =
+        Recording{.start = name, .name = name.String(), .macro = std::move(macro)};
+    recording->start.Detach();
+}
+
+void MacroProcessor::BeginRepeat(const Token &command_token, LineTokenizer &line) {
+    auto count_token = line.NextToken();
+    size_t count = 0;
+    try {
+        count = ParseWord(count_token.View());
+    } catch (...) {
+        ThrowCompilationError(CompilationError::InvalidCommandArgument, count_token,
+                              "Cannot parse value");
+    }
+    if (line.HasInput()) {
+        ThrowCompilationError(CompilationError::UnexpectedInput, line.NextToken());
+    }
+
+    recording = Recording{.start = command_token, .repeat = count};
+    recording->start.Detach();
+}
+
+void MacroProcessor::Replay(const Token &origin, const Macro &macro,
+                            const std::vector<Token> &arguments) {
+    if (expansion_depth >= kMaxExpansionDepth) {
+        ThrowCompilationError(CompilationError::ExpansionTooDeep, origin);
+    }
+    struct DepthGuard {
+        size_t &depth;
+        ~DepthGuard() { --depth; }
+    } guard{++expansion_depth};
+
+    auto unique_id = std::to_string(++expansion_count);
+    size_t nesting = 0;
+    for (auto &recorded : macro.lines) {
+        auto command = std::find_if(recorded.begin(), recorded.end(),
+                                    [](auto &t) { return !t.View().ends_with(':'); });
+        bool block_end = command != recorded.end() && IsBlockEnd(command->View());
+        if (block_end) {
+            --nesting;
+        }
+        auto id = nesting == 0 ? std::string_view{unique_id} : std::string_view{};
+        if (command != recorded.end() && IsBlockStart(command->View())) {
+            ++nesting;
+        }
+
+        Line tokens;
+        tokens.reserve(recorded.size());
+        for (auto &token : recorded) {
+            tokens.emplace_back(Substitute(token, macro.parameters, arguments, id));
+        }
+        auto end_location = tokens.back().location;
+        LineTokenizer line{std::move(tokens), std::move(end_location)};
+        handler(line);
+    }
+
+    // Blocks opened by expanded lines have to be closed within them
+    if (recording.has_value()) {
+        ThrowCompilationError(CompilationError::UnterminatedBlock, recording->start);
+    }
+}
+
+} // namespace emu::emu6502::assembler
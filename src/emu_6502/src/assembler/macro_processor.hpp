@@ -0,0 +1,71 @@
+#pragma once
+
+#include "emu_6502/assembler/tokenizer.hpp"
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace emu::emu6502::assembler {
+
+// Handles .macro/.endm definitions and .rept/.endr blocks. Lines of a block are
+// recorded as tokens and expanded by replaying them through the line handler, so
+// source text is never read again. Parameters are substituted in place of
+// identifiers, also inside tokens like #PARAM or PARAM:. Register names A, X and Y
+// cannot be parameters. Each expansion, and each repetition of .rept, replaces \@ with
+// its own number, so labels like LOOP\@: stay unique. Labels without \@ are global and
+// defining them in a block expanded more than once fails as a redefinition.
+class MacroProcessor {
+public:
+    using LineHandler = std::function<void(LineTokenizer &)>;
+    using ReservedNamePredicate = std::function<bool(std::string_view)>;
+
+    static constexpr size_t kMaxExpansionDepth = 64;
+
+    MacroProcessor(LineHandler handler, ReservedNamePredicate is_reserved)
+        : handler(std::move(handler)), is_reserved(std::move(is_reserved)) {}
+
+    // Lines are recorded while block is open, they must not be processed otherwise
+    [[nodiscard]] bool IsRecording() const { return recording.has_value(); }
+    void Record(LineTokenizer &line);
+
+    // Returns false if command is not related to macros
+    bool HandleCommand(const Token &command_token, LineTokenizer &line);
+    // Returns false if there is no macro with such name
+    bool Expand(const Token &name_token, LineTokenizer &line);
+
+    // Throws if some block is not terminated
+    void EndOfInput() const;
+
+private:
+    using Line = std::vector<Token>;
+
+    struct Macro {
+        std::vector<std::string> parameters;
+        std::vector<Line> lines;
+    };
+
+    struct Recording {
+        Token start;
+        std::string name;
+        Macro macro;
+        size_t repeat = 0;
+        size_t nesting = 0;
+    };
+
+    const LineHandler handler;
+    const ReservedNamePredicate is_reserved;
+    std::unordered_map<std::string, Macro> macros;
+    std::optional<Recording> recording;
+    size_t expansion_depth = 0;
+    size_t expansion_count = 0;
+
+    void BeginMacro(const Token &command_token, LineTokenizer &line);
+    void BeginRepeat(const Token &command_token, LineTokenizer &line);
+    void Replay(const Token &origin, const Macro &macro,
+                const std::vector<Token> &arguments);
+};
+
+} // namespace emu::emu6502::assembler
@@ -0,0 +1,79 @@
+#include "emu_6502/assembler/object_cache.hpp"
+#include "emu_core/base16.hpp"
+#include "emu_core/byte_utils.hpp"
+#include <fmt/format.h>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+
+namespace emu::emu6502::assembler {
+
+namespace {
+
+// Change when assembler output for the same source changes
+constexpr uint64_t kObjectCacheVersion = 2;
+
+} // namespace
+
+ObjectCache::ObjectCache(std::filesystem::path directory)
+    : directory(std::move(directory)) {
+    std::filesystem::create_directories(this->directory);
+}
+
+uint64_t ObjectCache::Key(std::string_view source, InstructionSet instruction_set,
+                          const SymbolDefVector &definitions, bool optimize) {
+    auto hash = Fnv1aHash(fmt::format("{}:{}:{}:{}\n", kObjectCacheVersion,
+                                      static_cast<int>(instruction_set), optimize,
+                                      source.size()));
+    hash = Fnv1aHash(source, hash);
+    for (auto &def : definitions) {
+        auto segment = def.segment.has_value() ? static_cast<int>(*def.segment) : 0;
+        hash = Fnv1aHash(fmt::format("{}={}:{}\n", def.name,
+                                     ToHex(ToBytes(def.value, std::nullopt), ""), segment),
+                         hash);
+    }
+    return hash;
+}
+
+std::filesystem::path ObjectCache::ObjectPath(uint64_t key) const {
+    return directory / fmt::format("{:016x}{}", key, kObjectFileExtension);
+}
+
+std::unique_ptr<Program> ObjectCache::Load(uint64_t key) const {
+    std::ifstream input(ObjectPath(key), std::ios::binary);
+    if (!input) {
+        return nullptr;
+    }
+    ByteVector data{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    try {
+        return std::make_unique<Program>(LoadProgramFromBinary(data));
+    } catch (const std::runtime_error &) {
+        return nullptr;
+    }
+}
+
+void ObjectCache::Store(uint64_t key, const Program &object) const {
+    auto data = StoreProgramToBinary(object);
+    auto path = ObjectPath(key);
+    // Unique name, the same object may be stored concurrently by other job or process
+    auto temp_path = path;
+    temp_path += fmt::format(".{:08x}.tmp", std::random_device{}());
+    {
+        std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+        output.write(reinterpret_cast<const char *>(data.data()),
+                     static_cast<std::streamsize>(data.size()));
+        if (!output) {
+            std::error_code ec;
+            std::filesystem::remove(temp_path, ec);
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+    }
+}
+
+} // namespace emu::emu6502::assembler
@@ -0,0 +1,323 @@
+#include "peephole_optimizer.hpp"
+#include "emu_6502/cpu/opcode.hpp"
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <utility>
+
+namespace emu::emu6502::assembler {
+
+namespace {
+
+using namespace std::string_view_literals;
+
+// Instructions which neither change carry flag nor transfer control unconditionally
+constexpr std::array kCarryPreserving = {
+    "LDA"sv, "LDX"sv, "LDY"sv, "STA"sv, "STX"sv, "STY"sv, "TAX"sv, "TAY"sv,
+    "TXA"sv, "TYA"sv, "TSX"sv, "TXS"sv, "INC"sv, "DEC"sv, "INX"sv, "INY"sv,
+    "DEX"sv, "DEY"sv, "AND"sv, "ORA"sv, "EOR"sv, "BIT"sv, "BEQ"sv, "BNE"sv,
+    "BMI"sv, "BPL"sv, "BVC"sv, "BVS"sv, "PHA"sv, "PLA"sv, "PHP"sv, "NOP"sv,
+    "CLI"sv, "SEI"sv, "CLD"sv, "SED"sv, "CLV"sv,
+};
+
+constexpr std::array kLoadStorePairs = {
+    std::pair{"LDA"sv, "STA"sv},
+    std::pair{"LDX"sv, "STX"sv},
+    std::pair{"LDY"sv, "STY"sv},
+};
+
+bool PreservesCarry(std::string_view mnemonic) {
+    return std::find(kCarryPreserving.begin(), kCarryPreserving.end(), mnemonic) !=
+           kCarryPreserving.end();
+}
+
+} // namespace
+
+size_t PeepholeOptimizer::Optimize(std::vector<EmittedInstruction> &instructions) {
+    labels.clear();
+    for (auto &symbol : program.symbols) {
+        if (!symbol.imported && std::holds_alternative<uint16_t>(symbol.offset)) {
+            labels.insert(std::get<uint16_t>(symbol.offset));
+        }
+    }
+    relocations = MapRelocations(program);
+
+    using Pass = bool (PeepholeOptimizer::*)(Block &, const std::vector<size_t> &);
+    constexpr std::array<Pass, 4> kPasses = {
+        &PeepholeOptimizer::OptimizeTailCalls,
+        &PeepholeOptimizer::OptimizeJumpsToNext,
+        &PeepholeOptimizer::OptimizeReloads,
+        &PeepholeOptimizer::OptimizeCarry,
+    };
+
+    size_t removed = 0;
+    std::vector<EmittedInstruction> result;
+    for (auto instruction_block : SplitBlocks(instructions)) {
+        if (!CanMoveBlock(program, relocations, instruction_block)) {
+            result.insert(result.end(), instruction_block.begin(), instruction_block.end());
+            continue;
+        }
+
+        Block block;
+        for (auto &instruction : instruction_block) {
+            block.push_back(Item{.instruction = instruction});
+        }
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto pass : kPasses) {
+                std::vector<size_t> live;
+                for (size_t i = 0; i < block.size(); ++i) {
+                    if (!block[i].removed) {
+                        live.push_back(i);
+                    }
+                }
+                changed = (this->*pass)(block, live) || changed;
+            }
+        }
+        removed += Relayout(block, result);
+    }
+    instructions = std::move(result);
+
+    return removed;
+}
+
+bool PeepholeOptimizer::OptimizeTailCalls(Block &block, const std::vector<size_t> &live) {
+    bool changed = false;
+    for (size_t k = 0; k + 1 < live.size(); ++k) {
+        auto &call = block[live[k]];
+        auto &ret = block[live[k + 1]];
+        if (call.removed || ret.removed || call.new_opcode.has_value()) {
+            continue;
+        }
+        if (call.instruction.opcode.mnemonic == "JSR" &&
+            ret.instruction.opcode.mnemonic == "RTS" && !IsLabel(ret)) {
+            Log("Replacing JSR at {:04x} with JMP", call.instruction.position);
+            call.new_opcode = cpu::opcode::INS_JMP_ABS;
+            Remove(ret, "tail call");
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool PeepholeOptimizer::OptimizeJumpsToNext(Block &block, const std::vector<size_t> &live) {
+    bool changed = false;
+    for (size_t k = 0; k + 1 < live.size(); ++k) {
+        auto &jump = block[live[k]];
+        auto is_jump = jump.new_opcode == cpu::opcode::INS_JMP_ABS ||
+                       jump.instruction.opcode.opcode == cpu::opcode::INS_JMP_ABS;
+        if (jump.removed || !is_jump) {
+            continue;
+        }
+        auto next = k + 1;
+        while (next < live.size() && block[live[next]].removed) {
+            ++next;
+        }
+        if (next == live.size()) {
+            continue;
+        }
+        if (AbsoluteTarget(jump) == block[live[next]].instruction.position) {
+            Remove(jump, "jump to next instruction");
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool PeepholeOptimizer::OptimizeReloads(Block &block, const std::vector<size_t> &live) {
+    auto same_operand = [&](const Item &a, const Item &b) {
+        if (a.instruction.opcode.addres_mode != b.instruction.opcode.addres_mode) {
+            return false;
+        }
+        auto target_a = RelocationTarget(a);
+        auto target_b = RelocationTarget(b);
+        if (target_a || target_b) {
+            return target_a == target_b;
+        }
+        return OperandBytes(a) == OperandBytes(b);
+    };
+
+    bool changed = false;
+    for (size_t k = 0; k + 2 < live.size(); ++k) {
+        auto &load = block[live[k]];
+        auto &store = block[live[k + 1]];
+        auto &reload = block[live[k + 2]];
+        if (load.removed || store.removed || reload.removed || IsLabel(store) ||
+            IsLabel(reload)) {
+            continue;
+        }
+        for (auto [load_mnemonic, store_mnemonic] : kLoadStorePairs) {
+            if (load.instruction.opcode.mnemonic == load_mnemonic &&
+                store.instruction.opcode.mnemonic == store_mnemonic &&
+                reload.instruction.opcode.mnemonic == load_mnemonic &&
+                same_operand(load, store) && same_operand(load, reload) &&
+                IsPlainMemory(load)) {
+                Remove(reload, "value is already loaded");
+                changed = true;
+                break;
+            }
+        }
+    }
+    return changed;
+}
+
+bool PeepholeOptimizer::OptimizeCarry(Block &block, const std::vector<size_t> &live) {
+    bool changed = false;
+    std::optional<bool> carry;
+    for (auto index : live) {
+        auto &item = block[index];
+        if (item.removed) {
+            continue;
+        }
+        if (IsLabel(item)) {
+            carry.reset();
+        }
+
+        auto mnemonic = item.new_opcode.has_value() ? "JMP"sv : item.instruction.opcode.mnemonic;
+        if (mnemonic == "CLC" || mnemonic == "SEC") {
+            auto value = mnemonic == "SEC";
+            if (carry == value) {
+                Remove(item, value ? "carry is already set" : "carry is already clear");
+                changed = true;
+            }
+            carry = value;
+        } else if (mnemonic == "BCS") {
+            carry = false;
+        } else if (mnemonic == "BCC") {
+            carry = true;
+        } else if (!PreservesCarry(mnemonic)) {
+            carry.reset();
+        }
+    }
+    return changed;
+}
+
+size_t PeepholeOptimizer::Relayout(const Block &block,
+                                   std::vector<EmittedInstruction> &output) {
+    auto &binary_code = program.sparse_binary_code;
+    auto start = block.front().instruction.position;
+    auto end = block.back().instruction.End();
+
+    // Bytes removed before each instruction, sorted by position
+    std::vector<std::pair<Address_t, Address_t>> shifts;
+    std::vector<std::pair<Address_t, ByteVector>> code;
+    Address_t removed_bytes = 0;
+    size_t removed_count = 0;
+    for (auto &item : block) {
+        auto &instruction = item.instruction;
+        shifts.emplace_back(instruction.position, removed_bytes);
+        if (item.removed) {
+            removed_bytes = static_cast<Address_t>(removed_bytes + instruction.Size());
+            ++removed_count;
+            continue;
+        }
+        auto bytes = binary_code.ReadBytes(instruction.position, instruction.Size());
+        auto &moved = output.emplace_back(instruction);
+        moved.position = static_cast<Address_t>(instruction.position - shifts.back().second);
+        if (item.new_opcode.has_value()) {
+            bytes[0] = *item.new_opcode;
+            moved.opcode = OpcodeInfo{*item.new_opcode, "JMP"sv, AddressMode::ABS};
+            moved.variants = nullptr;
+        }
+        code.emplace_back(moved.position, std::move(bytes));
+    }
+    if (removed_count == 0) {
+        return 0;
+    }
+
+    auto containing = [&](Address_t address) {
+        auto it = std::upper_bound(shifts.begin(), shifts.end(), address,
+                                   [](Address_t a, auto &s) { return a < s.first; });
+        return static_cast<size_t>(std::prev(it) - shifts.begin());
+    };
+    auto in_block = [&](Address_t address) { return address >= start && address < end; };
+
+    binary_code.Erase(start, end - start);
+    for (auto &[position, bytes] : code) {
+        binary_code.PutBytes(position, bytes);
+    }
+
+    for (auto &symbol : program.symbols) {
+        if (symbol.imported || !std::holds_alternative<uint16_t>(symbol.offset)) {
+            continue;
+        }
+        auto offset = std::get<uint16_t>(symbol.offset);
+        if (in_block(offset)) {
+            auto shift = shifts[containing(offset)].second;
+            Log("Moving symbol '{}' {:04x} -> {:04x}", symbol.name, offset,
+                offset - shift);
+            symbol.offset = static_cast<uint16_t>(offset - shift);
+        }
+    }
+
+    std::erase_if(program.relocations, [&](RelocationInfo &relocation) {
+        if (!in_block(relocation.position)) {
+            return false;
+        }
+        auto index = containing(relocation.position);
+        if (block[index].removed) {
+            return true;
+        }
+        relocation.position =
+            static_cast<Address_t>(relocation.position - shifts[index].second);
+        return false;
+    });
+    // Relocations were moved in memory and shifted
+    relocations = MapRelocations(program);
+
+    return removed_count;
+}
+
+void PeepholeOptimizer::Remove(Item &item, std::string_view reason) {
+    Log("Removing {} at {:04x}: {}", item.instruction.opcode.mnemonic,
+        item.instruction.position, reason);
+    item.removed = true;
+}
+
+const SymbolInfo *PeepholeOptimizer::RelocationTarget(const Item &item) const {
+    auto it = relocations.find(static_cast<Address_t>(item.instruction.position + 1));
+    if (it == relocations.end()) {
+        return nullptr;
+    }
+    return &program.Target(*it->second);
+}
+
+std::optional<Address_t> PeepholeOptimizer::AbsoluteTarget(const Item &item) const {
+    if (item.instruction.opcode.addres_mode != AddressMode::ABS) {
+        return std::nullopt;
+    }
+    if (relocations.contains(static_cast<Address_t>(item.instruction.position + 1))) {
+        const auto *symbol = RelocationTarget(item);
+        if (!symbol || symbol->imported || !std::holds_alternative<uint16_t>(symbol->offset)) {
+            return std::nullopt;
+        }
+        return std::get<uint16_t>(symbol->offset);
+    }
+    auto bytes = OperandBytes(item);
+    return static_cast<Address_t>(bytes[0] | (bytes[1] << 8));
+}
+
+ByteVector PeepholeOptimizer::OperandBytes(const Item &item) const {
+    auto &instruction = item.instruction;
+    return program.sparse_binary_code.ReadBytes(
+        static_cast<Address_t>(instruction.position + 1), instruction.Size() - 1u);
+}
+
+bool PeepholeOptimizer::IsPlainMemory(const Item &item) const {
+    switch (item.instruction.opcode.addres_mode) {
+    case AddressMode::ZP:
+    case AddressMode::ZPX:
+    case AddressMode::ZPY:
+        return true;
+    case AddressMode::ABS:
+    case AddressMode::ABSX:
+    case AddressMode::ABSY: {
+        const auto *symbol = RelocationTarget(item);
+        return symbol && !symbol->imported;
+    }
+    default:
+        return false;
+    }
+}
+
+} // namespace emu::emu6502::assembler
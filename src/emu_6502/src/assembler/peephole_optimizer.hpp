@@ -0,0 +1,66 @@
+#pragma once
+
+#include "emitted_instruction.hpp"
+#include "emu_core/program.hpp"
+#include <fmt/format.h>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace emu::emu6502::assembler {
+
+// Removes redundant instructions from blocks of consecutive instructions and moves
+// remaining code of the block down, together with labels and relocations. Labels
+// are barriers: no pattern spans instruction which is a jump target.
+//  - JSR x / RTS           -> JMP x
+//  - JMP to next instruction is removed
+//  - LDr x / STr x / LDr x -> LDr x / STr x, for zero page or labels only
+//  - CLC/SEC when carry state is already known (e.g. CLC / ... / CLC, BCS / CLC)
+// Code which refers to its own addresses by value (not by label) is not supported.
+class PeepholeOptimizer {
+public:
+    PeepholeOptimizer(Program &program, std::ostream *verbose_stream = nullptr)
+        : program(program), verbose_stream(verbose_stream) {}
+
+    // Returns number of removed instructions, instructions are updated to the new layout
+    size_t Optimize(std::vector<EmittedInstruction> &instructions);
+
+private:
+    struct Item {
+        EmittedInstruction instruction;
+        bool removed = false;
+        std::optional<Opcode> new_opcode = std::nullopt;
+    };
+    using Block = std::vector<Item>;
+
+    Program &program;
+    std::ostream *const verbose_stream;
+
+    std::set<Address_t> labels;
+    RelocationMap relocations;
+
+    template <typename... ARGS>
+    void Log(ARGS &&...args) {
+        if (verbose_stream != nullptr) {
+            (*verbose_stream) << "PeepholeOptimizer: "
+                              << fmt::format(std::forward<ARGS>(args)...) << "\n";
+        }
+    }
+
+    bool OptimizeTailCalls(Block &block, const std::vector<size_t> &live);
+    bool OptimizeJumpsToNext(Block &block, const std::vector<size_t> &live);
+    bool OptimizeReloads(Block &block, const std::vector<size_t> &live);
+    bool OptimizeCarry(Block &block, const std::vector<size_t> &live);
+    size_t Relayout(const Block &block, std::vector<EmittedInstruction> &output);
+
+    void Remove(Item &item, std::string_view reason);
+    bool IsLabel(const Item &item) const { return labels.contains(item.instruction.position); }
+    const SymbolInfo *RelocationTarget(const Item &item) const;
+    std::optional<Address_t> AbsoluteTarget(const Item &item) const;
+    ByteVector OperandBytes(const Item &item) const;
+    bool IsPlainMemory(const Item &item) const;
+};
+
+} // namespace emu::emu6502::assembler
@@ -0,0 +1,293 @@
+#include "relaxer.hpp"
+#include "emu_6502/cpu/opcode.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+namespace emu::emu6502::assembler {
+
+namespace {
+
+using namespace std::string_view_literals;
+using namespace cpu::opcode;
+
+constexpr std::array kInvertedBranches = {
+    std::pair{INS_BCC, OpcodeInfo{INS_BCS, "BCS"sv, AddressMode::REL}},
+    std::pair{INS_BCS, OpcodeInfo{INS_BCC, "BCC"sv, AddressMode::REL}},
+    std::pair{INS_BEQ, OpcodeInfo{INS_BNE, "BNE"sv, AddressMode::REL}},
+    std::pair{INS_BNE, OpcodeInfo{INS_BEQ, "BEQ"sv, AddressMode::REL}},
+    std::pair{INS_BMI, OpcodeInfo{INS_BPL, "BPL"sv, AddressMode::REL}},
+    std::pair{INS_BPL, OpcodeInfo{INS_BMI, "BMI"sv, AddressMode::REL}},
+    std::pair{INS_BVC, OpcodeInfo{INS_BVS, "BVS"sv, AddressMode::REL}},
+    std::pair{INS_BVS, OpcodeInfo{INS_BVC, "BVC"sv, AddressMode::REL}},
+};
+
+// Long branch is the inverted branch skipping JMP which follows it
+constexpr OpcodeInfo kJump{INS_JMP_ABS, "JMP"sv, AddressMode::ABS};
+constexpr Address_t kBranchSize = 2;
+constexpr Address_t kJumpSize = 3;
+
+constexpr std::array kZeroPageModes = {
+    std::pair{AddressMode::ABS, AddressMode::ZP},
+    std::pair{AddressMode::ABSX, AddressMode::ZPX},
+    std::pair{AddressMode::ABSY, AddressMode::ZPY},
+};
+
+std::optional<OpcodeInfo> InvertedBranch(Opcode opcode) {
+    for (auto &[branch, inverted] : kInvertedBranches) {
+        if (branch == opcode) {
+            return inverted;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<AddressMode> ZeroPageMode(AddressMode mode) {
+    for (auto [absolute, zero_page] : kZeroPageModes) {
+        if (absolute == mode) {
+            return zero_page;
+        }
+    }
+    return std::nullopt;
+}
+
+AddressMode AbsoluteMode(AddressMode mode) {
+    for (auto [absolute, zero_page] : kZeroPageModes) {
+        if (zero_page == mode) {
+            return absolute;
+        }
+    }
+    return mode;
+}
+
+} // namespace
+
+Relaxer::Result Relaxer::Relax(std::vector<EmittedInstruction> &instructions,
+                               bool select_zero_page) {
+    auto relocations = MapRelocations(program);
+
+    std::vector<SymbolInfo *> labels;
+    for (auto &symbol : program.symbols) {
+        if (!symbol.imported && std::holds_alternative<uint16_t>(symbol.offset)) {
+            labels.push_back(&symbol);
+        }
+    }
+    auto label_offset = [](auto &symbol) { return std::get<uint16_t>(symbol->offset); };
+    std::sort(labels.begin(), labels.end(),
+              [&](auto &a, auto &b) { return label_offset(a) < label_offset(b); });
+
+    // Blocks which cannot be moved are kept only to preserve order of instructions
+    std::vector<std::pair<Block, bool>> blocks;
+    for (auto instruction_block : SplitBlocks(instructions)) {
+        auto &[block, movable] = blocks.emplace_back();
+        movable = CanMoveBlock(program, relocations, instruction_block);
+        for (auto &instruction : instruction_block) {
+            auto it = relocations.find(static_cast<Address_t>(instruction.position + 1));
+            block.items.push_back(Item{
+                .instruction = instruction,
+                .relocation = it != relocations.end() ? it->second : nullptr,
+                .size = instruction.Size(),
+            });
+        }
+        auto it = std::lower_bound(labels.begin(), labels.end(),
+                                   instruction_block.front().position,
+                                   [&](auto &symbol, Address_t address) {
+                                       return label_offset(symbol) < address;
+                                   });
+        for (; it != labels.end() && label_offset(*it) < block.End(); ++it) {
+            block.labels.push_back(*it);
+        }
+    }
+
+    using Step = bool (Relaxer::*)(Block &, size_t);
+    auto run_phase = [&](std::initializer_list<Step> steps) {
+        bool any_change = false;
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto &[block, movable] : blocks) {
+                for (size_t i = 0; movable && i < block.items.size(); ++i) {
+                    for (auto step : steps) {
+                        changed = (this->*step)(block, i) || changed;
+                    }
+                }
+            }
+            any_change = any_change || changed;
+        }
+        return any_change;
+    };
+
+    // Relocations are moved in place
+    auto changed = select_zero_page && run_phase({&Relaxer::ShrinkToZeroPage});
+    changed = run_phase({&Relaxer::GrowFromZeroPage, &Relaxer::GrowBranch}) || changed;
+    if (!changed) {
+        return {};
+    }
+
+    Result result;
+    instructions.clear();
+    for (auto &[block, movable] : blocks) {
+        for (auto &item : block.items) {
+            result.zero_page += item.form == Form::ZeroPage ? 1 : 0;
+            result.long_branches += item.form == Form::LongBranch ? 1 : 0;
+            Output(item, instructions);
+        }
+    }
+    return result;
+}
+
+bool Relaxer::ShrinkToZeroPage(Block &block, size_t index) {
+    auto &item = block.items[index];
+    if (item.form != Form::Original || !item.relocation ||
+        item.relocation->mode != RelocationMode::Absolute ||
+        item.instruction.variants == nullptr) {
+        return false;
+    }
+    auto mode = ZeroPageMode(item.instruction.opcode.addres_mode);
+    if (!mode.has_value()) {
+        return false;
+    }
+    auto variant = item.instruction.variants->variants.find(*mode);
+    auto value = TargetValue(item);
+    if (variant == item.instruction.variants->variants.end() || !value.has_value() ||
+        *value > std::numeric_limits<uint8_t>::max()) {
+        return false;
+    }
+
+    auto &opcode = variant->second;
+    if (!Resize(block, index, {opcode.opcode, 0}, 1, RelocationMode::ZeroPage)) {
+        return false;
+    }
+    Log("Using zero page {} at {:04x}", opcode.mnemonic, item.instruction.position);
+    item.instruction.opcode = opcode;
+    item.form = Form::ZeroPage;
+    return true;
+}
+
+bool Relaxer::GrowFromZeroPage(Block &block, size_t index) {
+    auto &item = block.items[index];
+    auto value = TargetValue(item);
+    if (item.form != Form::ZeroPage || !value.has_value() ||
+        *value <= std::numeric_limits<uint8_t>::max()) {
+        return false;
+    }
+
+    auto mode = AbsoluteMode(item.instruction.opcode.addres_mode);
+    auto &opcode = item.instruction.variants->variants.at(mode);
+    if (!Resize(block, index, {opcode.opcode, 0, 0}, 1, RelocationMode::Absolute)) {
+        return false;
+    }
+    Log("Restoring absolute {} at {:04x}", opcode.mnemonic, item.instruction.position);
+    item.instruction.opcode = opcode;
+    item.form = Form::Original;
+    return true;
+}
+
+bool Relaxer::GrowBranch(Block &block, size_t index) {
+    auto &item = block.items[index];
+    if (item.form != Form::Original || !item.relocation ||
+        item.relocation->mode != RelocationMode::Relative) {
+        return false;
+    }
+    auto value = TargetValue(item);
+    auto inverted = InvertedBranch(item.instruction.opcode.opcode);
+    if (!value.has_value() || !inverted.has_value()) {
+        return false;
+    }
+    auto offset = *value - (item.instruction.position + item.size);
+    using Limit = std::numeric_limits<NearOffset_t>;
+    if (offset >= Limit::min() && offset <= Limit::max()) {
+        return false;
+    }
+
+    ByteVector bytes{inverted->opcode, kJumpSize, kJump.opcode, 0, 0};
+    if (!Resize(block, index, bytes, kBranchSize + 1, RelocationMode::Absolute)) {
+        Log("No space to extend {} at {:04x}", item.instruction.opcode.mnemonic,
+            item.instruction.position);
+        return false;
+    }
+    Log("Extending {} at {:04x} to {} over JMP", item.instruction.opcode.mnemonic,
+        item.instruction.position, inverted->mnemonic);
+    item.form = Form::LongBranch;
+    return true;
+}
+
+bool Relaxer::Resize(Block &block, size_t index, const ByteVector &bytes,
+                     Address_t relocation_offset, RelocationMode relocation_mode) {
+    auto &binary_code = program.sparse_binary_code;
+    auto &item = block.items[index];
+    int position = item.instruction.position;
+    int tail = position + item.size;
+    int end = block.End();
+    int delta = static_cast<int>(bytes.size()) - item.size;
+
+    if (delta > 0 && (end + delta > std::numeric_limits<Address_t>::max() + 1 ||
+                      binary_code.FindOccupied(static_cast<Address_t>(end),
+                                               static_cast<size_t>(delta)))) {
+        return false;
+    }
+
+    auto moved = binary_code.ReadBytes(static_cast<Address_t>(tail), end - tail);
+    binary_code.Erase(static_cast<Address_t>(position), end - position);
+    binary_code.PutBytes(static_cast<Address_t>(position), bytes);
+    binary_code.PutBytes(static_cast<Address_t>(position + bytes.size()), moved);
+
+    for (auto &label : block.labels) {
+        auto offset = std::get<uint16_t>(label->offset);
+        if (offset >= tail && offset < end) {
+            label->offset = static_cast<uint16_t>(offset + delta);
+        }
+    }
+    for (size_t i = index + 1; i < block.items.size(); ++i) {
+        auto &next = block.items[i];
+        auto &position = next.instruction.position;
+        position = static_cast<Address_t>(position + delta);
+        if (next.relocation) {
+            next.relocation->position =
+                static_cast<Address_t>(next.relocation->position + delta);
+        }
+    }
+
+    item.size = static_cast<Address_t>(bytes.size());
+    item.relocation->position = static_cast<Address_t>(position + relocation_offset);
+    item.relocation->mode = relocation_mode;
+    return true;
+}
+
+std::optional<int> Relaxer::TargetValue(const Item &item) const {
+    if (item.relocation == nullptr) {
+        return std::nullopt;
+    }
+    auto &offset = program.Target(*item.relocation).offset;
+    if (!HasValue(offset)) {
+        return std::nullopt;
+    }
+    if (std::holds_alternative<uint8_t>(offset)) {
+        return std::get<uint8_t>(offset);
+    }
+    return std::get<uint16_t>(offset);
+}
+
+void Relaxer::Output(const Item &item, std::vector<EmittedInstruction> &output) {
+    if (item.form != Form::LongBranch) {
+        output.push_back(item.instruction);
+        return;
+    }
+
+    auto &branch = item.instruction;
+    output.push_back(EmittedInstruction{
+        .position = branch.position,
+        .opcode = *InvertedBranch(branch.opcode.opcode),
+        .region = branch.region,
+        .location = branch.location,
+    });
+    output.push_back(EmittedInstruction{
+        .position = static_cast<Address_t>(branch.position + kBranchSize),
+        .opcode = kJump,
+        .region = branch.region,
+        .location = branch.location,
+    });
+}
+
+} // namespace emu::emu6502::assembler
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "emitted_instruction.hpp"
+#include "emu_core/program.hpp"
+#include <fmt/format.h>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace emu::emu6502::assembler {
+
+// Re-encodes instructions once symbol values are known, repeating until layout is
+// stable:
+//  - ABS/ABSX/ABSY referring to symbol in page zero -> ZP/ZPX/ZPY (optional)
+//  - conditional branch out of range                 -> inverted branch over JMP
+// All instructions are shrunk first and grown afterwards, so each phase converges.
+// Code following re-encoded instruction is moved with its labels and relocations;
+// blocks which cannot be moved (see CanMoveBlock) are left as they are.
+class Relaxer {
+public:
+    Relaxer(Program &program, std::ostream *verbose_stream = nullptr)
+        : program(program), verbose_stream(verbose_stream) {}
+
+    struct Result {
+        size_t zero_page = 0;
+        size_t long_branches = 0;
+    };
+
+    // Instructions are updated to the new layout
+    Result Relax(std::vector<EmittedInstruction> &instructions, bool select_zero_page);
+
+private:
+    enum class Form {
+        Original,
+        ZeroPage,
+        LongBranch,
+    };
+
+    struct Item {
+        EmittedInstruction instruction;
+        RelocationInfo *relocation;
+        Form form = Form::Original;
+        Address_t size;
+    };
+
+    struct Block {
+        std::vector<Item> items;
+        std::vector<SymbolInfo *> labels;
+
+        [[nodiscard]] int End() const {
+            return items.back().instruction.position + items.back().size;
+        }
+    };
+
+    Program &program;
+    std::ostream *const verbose_stream;
+
+    template <typename... ARGS>
+    void Log(ARGS &&...args) {
+        if (verbose_stream != nullptr) {
+            (*verbose_stream) << "Relaxer: " << fmt::format(std::forward<ARGS>(args)...)
+                              << "\n";
+        }
+    }
+
+    bool ShrinkToZeroPage(Block &block, size_t index);
+    bool GrowFromZeroPage(Block &block, size_t index);
+    bool GrowBranch(Block &block, size_t index);
+    bool Resize(Block &block, size_t index, const ByteVector &bytes,
+                Address_t relocation_offset, RelocationMode relocation_mode);
+
+    std::optional<int> TargetValue(const Item &item) const;
+    static void Output(const Item &item, std::vector<EmittedInstruction> &output);
+};
+
+} // namespace emu::emu6502::assembler
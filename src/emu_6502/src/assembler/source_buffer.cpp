@@ -0,0 +1,77 @@
+#include "emu_6502/assembler/source_buffer.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <iterator>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace emu::emu6502::assembler {
+
+SourceBuffer::SourceBuffer(PrivateTag, std::string name) : name(std::move(name)) {
+}
+
+SourceBuffer::~SourceBuffer() {
+    if (mapped != nullptr) {
+        ::munmap(mapped, mapped_size);
+    }
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::FromString(std::string text,
+                                                             std::string name) {
+    auto r = std::make_shared<SourceBuffer>(PrivateTag{}, std::move(name));
+    r->owned_text = std::move(text);
+    r->text = r->owned_text;
+    return r;
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::FromStream(std::istream &input,
+                                                             std::string name) {
+    std::string text{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    return FromString(std::move(text), std::move(name));
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::MapFile(const std::string &path) {
+    auto Error = [&](const char *msg) {
+        throw std::runtime_error(
+            fmt::format("Failed to {} '{}': {}", msg, path, std::strerror(errno)));
+    };
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        Error("open");
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        Error("stat");
+    }
+
+    auto r = std::make_shared<SourceBuffer>(PrivateTag{}, path);
+    auto size = static_cast<size_t>(st.st_size);
+    if (size > 0) {
+        void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            Error("map");
+        }
+        r->mapped = p;
+        r->mapped_size = size;
+        r->text = std::string_view{static_cast<const char *>(p), size};
+    }
+    ::close(fd);
+    return r;
+}
+
+std::string_view SourceBuffer::LineAt(size_t offset) const {
+    if (offset > text.size()) {
+        return {};
+    }
+    auto line = text.substr(offset);
+    return line.substr(0, line.find('\n'));
+}
+
+} // namespace emu::emu6502::assembler
@@ -101,28 +101,48 @@ std::tuple<std::string, size_t> ParseQuotedString(std::string_view input) {
 
 //-----------------------------------------------------------------------------
 
+void TokenLocation::Detach() {
+    if (source != nullptr && owner == nullptr) {
+        owner = source->shared_from_this();
+    }
+}
+
+std::string_view TokenLocation::InputName() const {
+    return source != nullptr ? std::string_view{source->Name()} : std::string_view{};
+}
+
+std::string_view TokenLocation::LineContent() const {
+    return source != nullptr ? source->LineAt(line_offset) : std::string_view{};
+}
+
 std::string TokenLocation::GetDescription() const {
     std::string s;
     s += fmt::format("{:04}: ", line);
-    if (line_content != nullptr) {
-        s += *line_content;
-    }
+    s += LineContent();
     s += "\n";
     s += fmt::format("{}^\n", std::string(column + 6, ' '));
     return s;
 }
 
 std::string to_string(const TokenLocation &location) {
-    if (location.input_name == nullptr) {
+    if (location.source == nullptr) {
         return "?";
     } else {
-        return fmt::format("{}:{}:{}", *location.input_name, location.line,
+        return fmt::format("{}:{}:{}", location.InputName(), location.line,
                            location.column);
     }
 }
 
 //-----------------------------------------------------------------------------
 
+void Token::Detach() {
+    if (storage == nullptr) {
+        storage = std::make_shared<const std::string>(value);
+        value = *storage;
+    }
+    location.Detach();
+}
+
 std::string Token::Upper() const {
     std::string r;
     transform(value.begin(), value.end(), std::back_inserter(r),
@@ -190,11 +210,21 @@ TokenListIterator LineTokenizer::TokenList(std::string separator) {
 }
 
 bool LineTokenizer::HasInput() {
+    if (tokenizer == nullptr) {
+        return replay_position < replayed_tokens.size();
+    }
     ConsumeUntilNextToken();
     return !line.empty();
 }
 
 Token LineTokenizer::NextToken() {
+    if (tokenizer == nullptr) {
+        if (replay_position < replayed_tokens.size()) {
+            return replayed_tokens[replay_position++];
+        }
+        return Token{Location(), std::string_view{}};
+    }
+
     ConsumeUntilNextToken();
 
     if (line.empty()) {
@@ -220,7 +250,7 @@ Token LineTokenizer::NextToken() {
             column += consumed;
             line.remove_prefix(consumed);
             ConsumeUntilNextToken();
-            return Token{Location(), token};
+            return Token{Location(), std::move(token)};
         }
         case ',':
         case '=':
@@ -247,9 +277,12 @@ Token LineTokenizer::NextToken() {
 }
 
 TokenLocation LineTokenizer::Location() const {
+    if (tokenizer == nullptr) {
+        return end_location;
+    }
     return TokenLocation{
-        tokenizer.GetInputName(),
-        line_storage,
+        tokenizer->GetSource(),
+        line_offset,
         line_number,
         column,
     };
@@ -278,7 +311,7 @@ void LineTokenizer::ConsumeUntilNextToken() {
 //-----------------------------------------------------------------------------
 
 bool Tokenizer::HasInput() {
-    return !input.eof();
+    return !finished;
 }
 
 LineTokenizer Tokenizer::NextLine() {
@@ -287,21 +320,26 @@ LineTokenizer Tokenizer::NextLine() {
             "No more input", CompilationError::UnexpectedEndOfInput, Token{Location()});
     }
 
-    std::string raw_line;
-    std::getline(input, raw_line);
+    auto text = source->Text();
+    auto end = text.find('\n', position);
+    if (end == std::string_view::npos) {
+        end = text.size();
+        finished = true;
+    }
 
-    current_line = std::make_shared<std::string>(std::move(raw_line));
+    line_offset = position;
+    position = end + 1;
     ++line;
 
-    return LineTokenizer(*this, line, current_line);
+    return LineTokenizer(*this, line, line_offset, text.substr(line_offset, end - line_offset));
 }
 
 TokenLocation Tokenizer::Location() const {
     return TokenLocation{
-        GetInputName(),
-        current_line,
+        source.get(),
+        line_offset,
         line,
-        current_line->size(),
+        source->LineAt(line_offset).size(),
     };
 }
 
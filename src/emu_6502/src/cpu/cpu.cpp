@@ -3,6 +3,7 @@
 #include "emu_6502/instruction_set.hpp"
 #include "instruction_functors.hpp"
 #include "memory_addressing.hpp"
+#include <algorithm>
 #include <fmt/format.h>
 
 namespace emu::emu6502::cpu {
@@ -273,15 +274,40 @@ void Cpu::Reset() {
 void Cpu::Execute() {
     Reset();
     for (;;) {
-        ExecuteNextInstruction();
+        ExecuteInstructionBatch(kDeadlineCheckInterval);
     }
 }
 
 void Cpu::ExecuteUntil(std::chrono::steady_clock::time_point deadline) {
     Reset();
-    while (deadline > std::chrono::steady_clock::now()) {
+    for (auto now = std::chrono::steady_clock::now(); deadline > now;
+         now = std::chrono::steady_clock::now()) {
+        ExecuteInstructionBatch(BatchSize(deadline - now));
+    }
+}
+
+uint32_t Cpu::BatchSize(std::chrono::steady_clock::duration remaining) const {
+    // Every instruction takes at least 2 cycles
+    constexpr double kMinInstructionCycles = 2.0;
+    if (clock == nullptr || clock->Frequency() == 0) {
+        return kDeadlineCheckInterval;
+    }
+    auto cycles = std::chrono::duration<double>(remaining).count() *
+                  static_cast<double>(clock->Frequency());
+    auto instructions = cycles / kMinInstructionCycles;
+    if (instructions >= kDeadlineCheckInterval) {
+        return kDeadlineCheckInterval;
+    }
+    return std::max(1u, static_cast<uint32_t>(instructions));
+}
+
+void Cpu::ExecuteInstructionBatch(uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
         ExecuteNextInstruction();
     }
+    if (clock != nullptr && clock->WatchdogExpired()) {
+        throw WatchdogExpired(reg, clock->CurrentCycle());
+    }
 }
 
 void Cpu::ExecuteFor(std::chrono::nanoseconds timeout) {
@@ -308,6 +334,9 @@ void Cpu::ExecuteNextInstruction() {
     }
 
     handler(this);
+    if (clock != nullptr) {
+        clock->RetireInstruction();
+    }
 
     if (pending_interrupt != Interrupt::None) {
         if (verbose_stream != nullptr) {
@@ -1,6 +1,9 @@
 #include "emu_6502/instruction_set.hpp"
 #include "emu_6502/cpu/opcode.hpp"
+#include <algorithm>
+#include <array>
 #include <fmt/format.h>
+#include <optional>
 #include <stdexcept>
 
 namespace emu::emu6502 {
@@ -10,6 +13,102 @@ namespace {
 using namespace std::string_view_literals;
 using namespace cpu::opcode;
 
+constexpr std::array kStoreMnemonics = {"STA"sv, "STX"sv, "STY"sv};
+constexpr std::array kReadModifyWriteMnemonics = {
+    "ASL"sv, "LSR"sv, "ROL"sv, "ROR"sv, "INC"sv, "DEC"sv,
+};
+
+std::optional<InstructionTiming> StoreTiming(AddressMode mode) {
+    switch (mode) {
+    case AddressMode::ZP:
+        return InstructionTiming{3};
+    case AddressMode::ZPX:
+    case AddressMode::ZPY:
+    case AddressMode::ABS:
+        return InstructionTiming{4};
+    case AddressMode::ABSX:
+    case AddressMode::ABSY:
+        return InstructionTiming{5};
+    case AddressMode::INDX:
+    case AddressMode::INDY:
+        return InstructionTiming{6};
+    default:
+        return std::nullopt;
+    }
+}
+
+std::optional<InstructionTiming> ReadModifyWriteTiming(AddressMode mode) {
+    switch (mode) {
+    case AddressMode::ACC:
+    case AddressMode::Immediate:
+        return InstructionTiming{2};
+    case AddressMode::ZP:
+        return InstructionTiming{5};
+    case AddressMode::ZPX:
+    case AddressMode::ABS:
+        return InstructionTiming{6};
+    case AddressMode::ABSX:
+        return InstructionTiming{7};
+    default:
+        return std::nullopt;
+    }
+}
+
+std::optional<InstructionTiming> ReadTiming(AddressMode mode) {
+    switch (mode) {
+    case AddressMode::Immediate:
+    case AddressMode::Implied:
+    case AddressMode::ACC:
+        return InstructionTiming{2};
+    case AddressMode::ZP:
+        return InstructionTiming{3};
+    case AddressMode::ZPX:
+    case AddressMode::ZPY:
+    case AddressMode::ABS:
+        return InstructionTiming{4};
+    case AddressMode::ABSX:
+    case AddressMode::ABSY:
+        return InstructionTiming{4, true};
+    case AddressMode::INDX:
+        return InstructionTiming{6};
+    case AddressMode::INDY:
+        return InstructionTiming{5, true};
+    default:
+        return std::nullopt;
+    }
+}
+
+std::optional<InstructionTiming> FindTiming(const OpcodeInfo &info) {
+    auto mnemonic = info.mnemonic;
+    if (info.addres_mode == AddressMode::REL) {
+        return InstructionTiming{2, false, true};
+    }
+    if (mnemonic == "JMP") {
+        return InstructionTiming{info.addres_mode == AddressMode::ABS_IND ? uint8_t{5}
+                                                                          : uint8_t{3}};
+    }
+    if (mnemonic == "JSR" || mnemonic == "RTS" || mnemonic == "RTI") {
+        return InstructionTiming{6};
+    }
+    if (mnemonic == "BRK") {
+        return InstructionTiming{7};
+    }
+    if (mnemonic == "PHA" || mnemonic == "PHP") {
+        return InstructionTiming{3};
+    }
+    if (mnemonic == "PLA" || mnemonic == "PLP") {
+        return InstructionTiming{4};
+    }
+    if (std::ranges::find(kStoreMnemonics, mnemonic) != kStoreMnemonics.end()) {
+        return StoreTiming(info.addres_mode);
+    }
+    if (std::ranges::find(kReadModifyWriteMnemonics, mnemonic) !=
+        kReadModifyWriteMnemonics.end()) {
+        return ReadModifyWriteTiming(info.addres_mode);
+    }
+    return ReadTiming(info.addres_mode);
+}
+
 void MergeInstructionMap(OpcodeInstructionMap &out, OpcodeInstructionMap source) {
     out.merge(source);
     if (!source.empty()) {
@@ -335,6 +434,14 @@ std::string to_string(AddressMode mode) {
         fmt::format("Invalid address mode: {}", static_cast<int>(mode)));
 }
 
+InstructionTiming GetInstructionTiming(const OpcodeInfo &info) {
+    if (auto timing = FindTiming(info); timing.has_value()) {
+        return *timing;
+    }
+    throw std::runtime_error(fmt::format("Unknown timing of {} in {} mode", info.mnemonic,
+                                         to_string(info.addres_mode)));
+}
+
 size_t ArgumentByteSize(AddressMode mode) {
     switch (mode) {
     case AddressMode::ACC:
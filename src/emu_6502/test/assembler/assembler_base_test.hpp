@@ -0,0 +1,18 @@
+#pragma once
+#include <gtest/gtest.h>
+
+#include "emu_6502/assembler/compiler.hpp"
+#include "emu_core/program.hpp"
+#include <memory>
+#include <string>
+
+namespace emu::emu6502::test {
+
+inline std::unique_ptr<Program> Compile(const std::string &code, bool optimize) {
+    assembler::Compiler6502 c{InstructionSet::Default, nullptr};
+    c.SetOptimize(optimize);
+    c.CompileString(code);
+    return c.GetProgram();
+}
+
+} // namespace emu::emu6502::test
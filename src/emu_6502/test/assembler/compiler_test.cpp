@@ -55,17 +55,14 @@ TEST_P(CompilerTest, ) {
 }
 
 AssemblerTestArg GetJumpTest() {
-    auto LABEL =
-        std::make_shared<SymbolInfo>(SymbolInfo{"LABEL", 10_addr, std::nullopt, false});
+    SymbolId LABEL = 0;
     Program expected = {
         .sparse_binary_code =
             SparseBinaryCode(1_addr, {0xaa, INS_JMP_ABS, 0x0a, 0x00, 0x55, INS_JMP_IND,
                                       0x0a, 0x00, 0x55, INS_NOP}),
-        .symbols = {{"LABEL", LABEL}},
-        .relocations = {std::make_shared<RelocationInfo>(
-                            RelocationInfo{LABEL, 3_addr, RelocationMode::Absolute}),
-                        std::make_shared<RelocationInfo>(
-                            RelocationInfo{LABEL, 7_addr, RelocationMode::Absolute})},
+        .symbols = {SymbolInfo{"LABEL", 10_addr, std::nullopt, false}},
+        .relocations = {RelocationInfo{LABEL, 3_addr, RelocationMode::Absolute},
+                        RelocationInfo{LABEL, 7_addr, RelocationMode::Absolute}},
     };
     auto code = R"==(
 .org 0x01
@@ -168,18 +165,20 @@ AssemblerTestArg GetPageAlignCommandTest() {
 }
 
 AssemblerTestArg GetBranchTest() {
-    auto L1 = std::make_shared<SymbolInfo>(SymbolInfo{"L1", 1_addr, std::nullopt, false});
-    auto L2 = std::make_shared<SymbolInfo>(SymbolInfo{"L2", 6_addr, std::nullopt, false});
+    SymbolId L1 = 0;
+    SymbolId L2 = 1;
     Program expected = {
         .sparse_binary_code = SparseBinaryCode(
             {INS_NOP, INS_BEQ, 0x03_u8, INS_NOP, INS_BPL, 0xfb_u8, INS_NOP}),
-        .symbols = {{"L1", L1}, {"L2", L2}},
+        .symbols =
+            {
+                SymbolInfo{"L1", 1_addr, std::nullopt, false},
+                SymbolInfo{"L2", 6_addr, std::nullopt, false},
+            },
         .relocations =
             {
-                std::make_shared<RelocationInfo>(
-                    RelocationInfo{L2, 2_addr, RelocationMode::Relative}),
-                std::make_shared<RelocationInfo>(
-                    RelocationInfo{L1, 5_addr, RelocationMode::Relative}),
+                RelocationInfo{L2, 2_addr, RelocationMode::Relative},
+                RelocationInfo{L1, 5_addr, RelocationMode::Relative},
             },
     };
     auto code = R"==(
@@ -227,11 +226,10 @@ LDX $ff,Y
 }
 
 AssemblerTestArg GetAliasTest() {
-    auto ALIAS = std::make_shared<ValueAlias>(ValueAlias{"ALIAS", {0x10_u8}});
     Program expected = {
         .sparse_binary_code =
             SparseBinaryCode(0_addr, {0x10, INS_LDA_ZP, 0x10, INS_LDA_IM, 0x10}),
-        .aliases = {{"ALIAS", ALIAS}},
+        .aliases = {ValueAlias{"ALIAS", {0x10_u8}}},
     };
     auto code = R"==(
 ALIAS=0x10
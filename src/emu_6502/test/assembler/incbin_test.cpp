@@ -0,0 +1,93 @@
+#include "emu_6502/assembler/compilation_error.hpp"
+#include "emu_6502/assembler/compiler.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <unistd.h>
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace emu::emu6502::assembler;
+namespace fs = std::filesystem;
+
+class IncbinTest : public testing::Test {
+protected:
+    fs::path directory;
+    ByteVector data = ByteVector(0x300);
+
+    void SetUp() override {
+        auto test = testing::UnitTest::GetInstance()->current_test_info();
+        directory = fs::temp_directory_path() /
+                    fmt::format("emu_incbin_test_{}_{}", ::getpid(), test->name());
+        fs::create_directories(directory);
+        std::iota(data.begin(), data.end(), uint8_t{0});
+        std::ofstream file(directory / "table.bin", std::ios::binary);
+        file.write(reinterpret_cast<const char *>(data.data()),
+                   static_cast<std::streamsize>(data.size()));
+    }
+    void TearDown() override { fs::remove_all(directory); }
+
+    std::unique_ptr<Program> CompileSource(const std::string &code,
+                                           Compiler6502 *compiler = nullptr) {
+        auto path = (directory / "test.asm").string();
+        std::ofstream(path) << code;
+        Compiler6502 c{InstructionSet::Default, nullptr};
+        compiler = compiler != nullptr ? compiler : &c;
+        compiler->CompileFile(path);
+        return compiler->GetProgram();
+    }
+};
+
+TEST_F(IncbinTest, WholeFile) {
+    Compiler6502 compiler{InstructionSet::Default, nullptr};
+    auto program = CompileSource(R"(
+.org 0x1000
+    LDA TABLE
+TABLE:
+.incbin "table.bin"
+END:
+)",
+                                 &compiler);
+    auto &code = program->sparse_binary_code;
+    EXPECT_EQ(code.ReadBytes(0x1003, data.size()), data);
+    EXPECT_EQ(code.ByteCount(), 3 + data.size());
+    EXPECT_EQ(program->FindSymbol("END")->offset, SymbolAddress{uint16_t{0x1303}});
+    EXPECT_EQ(compiler.GetIncludedFiles(),
+              std::vector<std::string>{(directory / "table.bin").string()});
+}
+
+TEST_F(IncbinTest, Range) {
+    auto program = CompileSource(R"(
+.org 0x2000
+.incbin "table.bin", $10, 4
+.incbin "table.bin", $2FE
+)");
+    EXPECT_EQ(program->sparse_binary_code.ReadBytes(0x2000, 6),
+              (ByteVector{0x10, 0x11, 0x12, 0x13, 0xFE, 0xFF}));
+    EXPECT_EQ(program->sparse_binary_code.ByteCount(), 6u);
+}
+
+TEST_F(IncbinTest, Errors) {
+    EXPECT_THROW(CompileSource(".incbin table.bin"), CompilationException);
+    EXPECT_THROW(CompileSource(".incbin \"missing.bin\""), CompilationException);
+    EXPECT_THROW(CompileSource(".incbin \"table.bin\", $300, 1"), CompilationException);
+    EXPECT_THROW(CompileSource(".incbin \"table.bin\", 0,"), CompilationException);
+}
+
+TEST_F(IncbinTest, AddressSpaceEnd) {
+    auto program = CompileSource(".org 0xFD00\n.incbin \"table.bin\"\n");
+    EXPECT_EQ(program->sparse_binary_code.ReadBytes(0xFD00, data.size()), data);
+
+    try {
+        CompileSource(".org 0xFD01\n.incbin \"table.bin\"\n");
+        FAIL() << "Compilation succeeded";
+    } catch (const CompilationException &e) {
+        EXPECT_EQ(e.Error(), CompilationError::InvalidCommandArgument);
+        EXPECT_NE(e.Message().find("exceeds address space"), std::string::npos);
+    }
+}
+
+} // namespace
+} // namespace emu::emu6502::test
@@ -14,14 +14,14 @@ using namespace emu::emu6502::assembler;
 
 using u8v = std::vector<uint8_t>;
 
-const AliasMap kTestAliases = {
-    {"byte", std::make_shared<ValueAlias>(ValueAlias{"byte", {1}})},
-    {"word", std::make_shared<ValueAlias>(ValueAlias{"word", {1, 2}})},
+const AliasTable kTestAliases = {
+    ValueAlias{"byte", {1}},
+    ValueAlias{"word", {1, 2}},
 };
 
-const SymbolMap kTestSymbolMap = {
-    {"L1", std::make_shared<SymbolInfo>(SymbolInfo{"L1", 1_u8, std::nullopt, false})},
-    {"L2", std::make_shared<SymbolInfo>(SymbolInfo{"L2", 2_u8, std::nullopt, false})},
+const SymbolTable kTestSymbolMap = {
+    SymbolInfo{"L1", 1_u8, std::nullopt, false},
+    SymbolInfo{"L2", 2_u8, std::nullopt, false},
 };
 
 using ArgumentParseTestArg = std::tuple<std::string, std::optional<InstructionArgument>>;
@@ -131,6 +131,16 @@ std::vector<ArgumentParseTestArg> GetTestCases() {
         ArgumentParseTestArg{""s, InstructionArgument{{AM::Implied}, nullptr}}, //
         // | Accumulator         |          A               |
         ArgumentParseTestArg{"A"s, InstructionArgument{{AM::ACC}, nullptr}}, //
+
+        // malformed
+        ArgumentParseTestArg{"#"s, std::nullopt},         //
+        ArgumentParseTestArg{"()"s, std::nullopt},        //
+        ArgumentParseTestArg{"$55,x"s, std::nullopt},     //
+        ArgumentParseTestArg{"($55,X"s, std::nullopt},    //
+        ArgumentParseTestArg{"($55),X"s, std::nullopt},   //
+        ArgumentParseTestArg{"#($55)"s, std::nullopt},    //
+        ArgumentParseTestArg{"$55,Y "s, std::nullopt},    //
+        ArgumentParseTestArg{"LABEL-1"s, std::nullopt},   //
     };
 }
 
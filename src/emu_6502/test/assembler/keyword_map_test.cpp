@@ -0,0 +1,61 @@
+#include "emu_6502/assembler/keyword_map.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace emu::emu6502::assembler;
+
+constexpr KeywordMap<int, 4> kDirectives = {
+    {"org", 1}, {"byte", 2}, {"word", 3}, {"asciiz", 4}, {"text", 5},
+};
+
+static_assert(kDirectives.size() == 5);
+static_assert(*kDirectives.Find("org") == 1);
+static_assert(*kDirectives.Find("ASCIIZ") == 4);
+static_assert(kDirectives.Find("org2") == nullptr);
+
+TEST(KeywordMapTest, CaseInsensitiveLookup) {
+    EXPECT_EQ(*kDirectives.Find("Byte"), 2);
+    EXPECT_EQ(*kDirectives.Find("WORD"), 3);
+    EXPECT_EQ(*kDirectives.Find("text"), 5);
+    EXPECT_EQ(kDirectives.Find(""), nullptr);
+    EXPECT_EQ(kDirectives.Find("byt"), nullptr);
+    EXPECT_EQ(kDirectives.Find("bytes"), nullptr);
+    EXPECT_EQ(kDirectives.Find("verylongkeyword"), nullptr);
+    EXPECT_EQ(kDirectives.Find(std::string_view("org\0", 4)), nullptr);
+}
+
+TEST(KeywordMapTest, RuntimeBuild) {
+    std::vector<std::string> names;
+    std::vector<std::pair<std::string_view, size_t>> items;
+    for (char a = 'A'; a <= 'Z'; ++a) {
+        for (char b = 'A'; b <= 'C'; ++b) {
+            names.emplace_back(std::string{a, b, 'X'});
+        }
+    }
+    for (size_t i = 0; i < names.size(); ++i) {
+        items.emplace_back(names[i], i);
+    }
+
+    KeywordMap<size_t, 10> map{items};
+    EXPECT_EQ(map.size(), names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        auto *v = map.Find(names[i]);
+        ASSERT_NE(v, nullptr) << names[i];
+        EXPECT_EQ(*v, i);
+    }
+    EXPECT_EQ(map.Find("ADX"), nullptr);
+}
+
+TEST(KeywordMapTest, InvalidKeywords) {
+    using Map = KeywordMap<int, 4>;
+    EXPECT_THROW(Map({{"org", 1}, {"ORG", 2}}), std::invalid_argument);
+    EXPECT_THROW(Map({{"", 1}}), std::invalid_argument);
+    EXPECT_THROW(Map({{"toolongname", 1}}), std::invalid_argument);
+}
+
+} // namespace
+} // namespace emu::emu6502::test
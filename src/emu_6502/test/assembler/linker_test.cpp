@@ -0,0 +1,82 @@
+#include "emu_6502/assembler/compiler.hpp"
+#include "emu_6502/assembler/linker.hpp"
+#include "emu_core/program.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace emu::emu6502::assembler;
+
+std::unique_ptr<Program> CompileObject(const std::string &code) {
+    Compiler6502 c{InstructionSet::Default, nullptr};
+    c.CompileString(code);
+    return c.GetObject();
+}
+
+const std::string kMain = R"==(
+.isr reset ENTRY
+.org 0x2000
+ENTRY:
+    JSR FUNC
+    LDA VALUE
+LOOP:
+    BNE FUNC_END
+    JMP LOOP
+)==";
+
+const std::string kFunc = R"==(
+COUNT = $10
+.org 0x2010
+FUNC:
+    LDX #COUNT
+FUNC_END:
+    RTS
+VALUE:
+.byte $AA
+)==";
+
+TEST(LinkerTest, MatchesSingleCompilation) {
+    auto expected = CompileString(kMain + kFunc);
+
+    Linker linker;
+    linker.AddObject(CompileObject(kMain), "main");
+    linker.AddObject(CompileObject(kFunc), "func");
+    auto linked = linker.Link();
+
+    EXPECT_EQ(expected->sparse_binary_code, linked->sparse_binary_code);
+    ASSERT_NE(linked->FindSymbol("FUNC"), nullptr);
+    EXPECT_FALSE(linked->FindSymbol("FUNC")->imported);
+    EXPECT_EQ(GetOr<uint16_t>(linked->FindSymbol("FUNC")->offset, 0), 0x2010);
+    EXPECT_EQ(linked->relocations.size(), expected->relocations.size());
+}
+
+TEST(LinkerTest, OrderIndependent) {
+    Linker a;
+    a.AddObject(CompileObject(kMain), "main");
+    a.AddObject(CompileObject(kFunc), "func");
+
+    Linker b;
+    b.AddObject(CompileObject(kFunc), "func");
+    b.AddObject(CompileObject(kMain), "main");
+
+    EXPECT_EQ(a.Link()->sparse_binary_code, b.Link()->sparse_binary_code);
+}
+
+TEST(LinkerTest, DuplicateSymbol) {
+    Linker linker;
+    linker.AddObject(CompileObject(".org 0x1000\nLABEL:\nNOP\n"), "a");
+    linker.AddObject(CompileObject(".org 0x2000\nLABEL:\nNOP\n"), "b");
+    EXPECT_THROW(linker.Link(), std::runtime_error);
+}
+
+TEST(LinkerTest, OverlappingCode) {
+    Linker linker;
+    linker.AddObject(CompileObject(".org 0x1000\nNOP\nNOP\n"), "a");
+    linker.AddObject(CompileObject(".org 0x1001\nNOP\n"), "b");
+    EXPECT_THROW(linker.Link(), std::runtime_error);
+}
+
+} // namespace
+} // namespace emu::emu6502::test
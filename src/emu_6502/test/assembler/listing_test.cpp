@@ -0,0 +1,86 @@
+#include "emu_6502/assembler/compiler.hpp"
+#include "emu_6502/assembler/listing.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace emu::emu6502::assembler;
+
+std::string CompileListing(const std::string &code, bool optimize = false) {
+    Compiler6502 c{InstructionSet::Default, nullptr};
+    c.SetOptimize(optimize);
+    c.SetListing(true);
+    c.CompileString(code, "test.asm");
+    auto program = c.GetProgram();
+    return FormatListing(*program, c.GetListing());
+}
+
+TEST(ListingTest, Loop) {
+    auto code = R"(
+.org 0x1000
+    LDX #$0A
+LOOP:
+    LDA DATA,X
+    STA $20,X
+    DEX
+    BNE LOOP
+    RTS
+DATA:
+.byte 1
+)";
+    auto expected = R"(; test.asm
+1000  a2 0a     2     LDX #$0A
+; block 1000-1001: 2 cycles
+LOOP:
+1002  bd 0b 10  4-5   LDA DATA,X
+1005  95 20     4     STA $20,X
+1007  ca        2     DEX
+1008  d0 f8     2-3   BNE LOOP
+; loop LOOP: 13-14 cycles per iteration
+; block 1002-1009: 12-14 cycles
+100a  60        6     RTS
+; block 100a-100a: 6 cycles
+)";
+    EXPECT_EQ(CompileListing(code), expected);
+}
+
+TEST(ListingTest, BranchAcrossPage) {
+    auto code = R"(
+.org 0x10fc
+    CLC
+    BCC NEXT
+    NOP
+NEXT:
+    JMP NEXT
+)";
+    auto expected = R"(; test.asm
+10fc  18        2     CLC
+10fd  90 01     2-4   BCC NEXT
+; block 10fc-10fe: 4-6 cycles
+10ff  ea        2     NOP
+; block 10ff-10ff: 2 cycles
+NEXT:
+1100  4c 00 11  3     JMP NEXT
+; loop NEXT: 3 cycles per iteration
+; block 1100-1102: 3 cycles
+)";
+    EXPECT_EQ(CompileListing(code), expected);
+}
+
+TEST(ListingTest, LongBranchKeepsSource) {
+    auto listing = CompileListing(".org 0x1000\nBEQ FAR\nRTS\n.org 0x1100\nFAR:\nRTS\n");
+    EXPECT_NE(listing.find("1000  d0 03     2-3   BEQ FAR\n"), std::string::npos) << listing;
+    EXPECT_NE(listing.find("1002  4c 00 11  3     BEQ FAR\n"), std::string::npos) << listing;
+}
+
+TEST(ListingTest, DisabledByDefault) {
+    Compiler6502 c{InstructionSet::Default, nullptr};
+    c.CompileString("NOP\n");
+    c.GetProgram();
+    EXPECT_TRUE(c.GetListing().empty());
+}
+
+} // namespace
+} // namespace emu::emu6502::test
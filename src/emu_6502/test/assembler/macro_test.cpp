@@ -0,0 +1,100 @@
+#include "emu_6502/assembler/compilation_error.hpp"
+#include "emu_6502/assembler/compiler.hpp"
+#include "emu_6502/cpu/opcode.hpp"
+#include <gtest/gtest.h>
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace emu::emu6502::cpu::opcode;
+using namespace emu::emu6502::assembler;
+
+CompilationError CompileError(const std::string &code) {
+    try {
+        CompileString(code);
+    } catch (const CompilationException &e) {
+        return e.Error();
+    }
+    ADD_FAILURE() << "Compilation succeeded";
+    return {};
+}
+
+TEST(MacroTest, Parameters) {
+    auto program = CompileString(R"(
+.macro STORE VALUE, TARGET
+    LDA #VALUE
+    STA TARGET
+.endm
+.org 0x1000
+    STORE $10, $20
+    STORE $30, DATA
+DATA:
+    .byte 0
+)");
+    EXPECT_EQ(program->sparse_binary_code.ReadBytes(0x1000, 10),
+              (ByteVector{INS_LDA_IM, 0x10, INS_STA_ZP, 0x20, INS_LDA_IM, 0x30,
+                          INS_STA_ABS, 0x09, 0x10, 0x00}));
+}
+
+TEST(MacroTest, Repeat) {
+    auto program = CompileString(R"(
+.macro SHIFT COUNT
+    .rept COUNT
+        INY
+    .endr
+.endm
+    SHIFT 3
+.rept 2
+    INX
+.endr
+)");
+    EXPECT_EQ(program->sparse_binary_code.ReadBytes(0, 5),
+              (ByteVector{INS_INY, INS_INY, INS_INY, INS_INX, INS_INX}));
+    EXPECT_EQ(program->sparse_binary_code.ByteCount(), 5u);
+}
+
+TEST(MacroTest, UniqueLabels) {
+    auto program = CompileString(R"(
+.macro WAIT COUNT
+    LDX #COUNT
+LOOP\@:
+    .rept 2
+        DEX
+    NEXT\@:
+    .endr
+    BNE LOOP\@
+.endm
+    WAIT $01
+.rept 2
+    WAIT $02
+.endr
+)");
+    EXPECT_EQ(program->sparse_binary_code.ReadBytes(0, 6),
+              (ByteVector{INS_LDX_IM, 0x01, INS_DEX, INS_DEX, INS_BNE, 0xfc}));
+    EXPECT_EQ(program->sparse_binary_code.ReadBytes(12, 6),
+              (ByteVector{INS_LDX_IM, 0x02, INS_DEX, INS_DEX, INS_BNE, 0xfc}));
+    EXPECT_EQ(program->sparse_binary_code.ByteCount(), 18u);
+    EXPECT_EQ(program->symbols.size(), 9u);
+}
+
+TEST(MacroTest, Errors) {
+    EXPECT_EQ(CompileError(".rept 2\nNOP\n"), CompilationError::UnterminatedBlock);
+    EXPECT_EQ(CompileError(".macro M\n.endm\n.macro M\n.endm\n"),
+              CompilationError::MacroRedefinition);
+    EXPECT_EQ(CompileError(".macro M P\nNOP\n.endm\nM 1, 2\n"),
+              CompilationError::InvalidCommandArgument);
+    EXPECT_EQ(CompileError(".macro LDA\n.endm\n"),
+              CompilationError::InvalidCommandArgument);
+    EXPECT_EQ(CompileError(".macro M\nM\n.endm\nM\n"),
+              CompilationError::ExpansionTooDeep);
+    EXPECT_EQ(CompileError(".endr\n"), CompilationError::UnexpectedInput);
+    EXPECT_EQ(CompileError(".macro M X\nLDA X,X\n.endm\n"),
+              CompilationError::InvalidCommandArgument);
+    EXPECT_EQ(CompileError(".macro M V, a\n.endm\n"),
+              CompilationError::InvalidCommandArgument);
+    EXPECT_EQ(CompileError(".rept 2\nLOOP:\nNOP\n.endr\n"),
+              CompilationError::SymbolRedefinition);
+}
+
+} // namespace
+} // namespace emu::emu6502::test
@@ -0,0 +1,68 @@
+#include "emu_6502/assembler/compiler.hpp"
+#include "emu_6502/assembler/object_cache.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace emu::emu6502::assembler;
+namespace fs = std::filesystem;
+
+class ObjectCacheTest : public testing::Test {
+protected:
+    fs::path directory;
+
+    void SetUp() override {
+        directory = fs::temp_directory_path() /
+                    fmt::format("emu_object_cache_test_{}",
+                                testing::UnitTest::GetInstance()->random_seed());
+        fs::remove_all(directory);
+    }
+    void TearDown() override { fs::remove_all(directory); }
+};
+
+const std::string kSource = R"==(
+.org 0x1000
+ENTRY:
+    JSR FUNC
+    JMP ENTRY
+)==";
+
+TEST_F(ObjectCacheTest, StoreAndLoad) {
+    ObjectCache cache{directory};
+    auto key = ObjectCache::Key(kSource, InstructionSet::Default, {});
+    EXPECT_EQ(cache.Load(key), nullptr);
+
+    Compiler6502 compiler{InstructionSet::Default, nullptr};
+    compiler.CompileString(kSource);
+    auto object = compiler.GetObject();
+    cache.Store(key, *object);
+
+    auto loaded = cache.Load(key);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(*object, *loaded);
+    EXPECT_EQ(std::distance(fs::directory_iterator(directory), fs::directory_iterator()), 1);
+}
+
+TEST_F(ObjectCacheTest, KeyDependsOnInputs) {
+    auto key = ObjectCache::Key(kSource, InstructionSet::Default, {});
+    EXPECT_EQ(key, ObjectCache::Key(kSource, InstructionSet::Default, {}));
+    EXPECT_NE(key, ObjectCache::Key(kSource + " ", InstructionSet::Default, {}));
+    EXPECT_NE(key, ObjectCache::Key(kSource, InstructionSet::NMOS6502Emu, {}));
+    EXPECT_NE(key, ObjectCache::Key(kSource, InstructionSet::Default, {}, true));
+    EXPECT_NE(key, ObjectCache::Key(kSource, InstructionSet::Default,
+                                    {SymbolDefinition{.name = "FUNC", .value = uint16_t{0x2000}}}));
+}
+
+TEST_F(ObjectCacheTest, CorruptedEntryIsMiss) {
+    ObjectCache cache{directory};
+    auto key = ObjectCache::Key(kSource, InstructionSet::Default, {});
+    std::ofstream(directory / fmt::format("{:016x}{}", key, kObjectFileExtension))
+        << "garbage";
+    EXPECT_EQ(cache.Load(key), nullptr);
+}
+
+} // namespace
+} // namespace emu::emu6502::test
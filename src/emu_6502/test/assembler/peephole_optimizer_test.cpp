@@ -0,0 +1,68 @@
+#include "assembler_base_test.hpp"
+#include <string>
+#include <tuple>
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace emu::emu6502::assembler;
+using namespace std::string_literals;
+
+// name, input, expected code after optimization
+using PeepholeTestArg = std::tuple<std::string, std::string, std::string>;
+class PeepholeOptimizerTest : public testing::TestWithParam<PeepholeTestArg> {};
+
+TEST_P(PeepholeOptimizerTest, ) {
+    auto &[name, code, expected_code] = GetParam();
+    auto expected = Compile(".org 0x1000\n" + expected_code, false);
+    auto result = Compile(".org 0x1000\n" + code, true);
+    EXPECT_EQ(*expected, *result) << "RESULT:\n"
+                                  << to_string(*result) << "\nEXPECTED:\n"
+                                  << to_string(*expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    , PeepholeOptimizerTest,
+    ::testing::ValuesIn(std::vector<PeepholeTestArg>{
+        {"tail_call", "MAIN:\nJSR FUNC\nRTS\nOTHER:\nRTS\nFUNC:\nRTS\n",
+         "MAIN:\nJMP FUNC\nOTHER:\nRTS\nFUNC:\nRTS\n"},
+        {"tail_call_to_next", "MAIN:\nJSR FUNC\nRTS\nFUNC:\nRTS\n", "MAIN:\nFUNC:\nRTS\n"},
+        {"tail_call_label", "JSR FUNC\nLBL:\nRTS\nFUNC:\nRTS\n",
+         "JSR FUNC\nLBL:\nRTS\nFUNC:\nRTS\n"},
+        {"jump_to_next", "NOP\nJMP NEXT\nNEXT:\nRTS\n", "NOP\nNEXT:\nRTS\n"},
+        {"jump_over", "JMP NEXT\nNOP\nNEXT:\nRTS\n", "JMP NEXT\nNOP\nNEXT:\nRTS\n"},
+        {"reload_zp", "LDA $10\nSTA $10\nLDA $10\nRTS\n", "LDA $10\nSTA $10\nRTS\n"},
+        {"reload_x", "LDX $10,Y\nSTX $10,Y\nLDX $10,Y\nRTS\n", "LDX $10,Y\nSTX $10,Y\nRTS\n"},
+        {"reload_label", "LDA VAR\nSTA VAR\nLDA VAR\nRTS\nVAR:\n.byte 0\n",
+         "LDA VAR\nSTA VAR\nRTS\n.org 0x100a\nVAR:\n.byte 0\n"},
+        {"reload_barrier", "LDA $10\nSTA $10\nLBL:\nLDA $10\nRTS\n",
+         "LDA $10\nSTA $10\nLBL:\nLDA $10\nRTS\n"},
+        {"reload_absolute", "LDA $1234\nSTA $1234\nLDA $1234\nRTS\n",
+         "LDA $1234\nSTA $1234\nLDA $1234\nRTS\n"},
+        {"reload_other", "LDA $10\nSTA $11\nLDA $10\nRTS\n", "LDA $10\nSTA $11\nLDA $10\nRTS\n"},
+        {"carry", "CLC\nLDA #$01\nCLC\nADC #$01\nCLC\nRTS\n", "CLC\nLDA #$01\nADC #$01\nCLC\nRTS\n"},
+        {"carry_set", "SEC\nSEC\nSBC #$01\nRTS\n", "SEC\nSBC #$01\nRTS\n"},
+        {"carry_branch", "BCS LBL\nCLC\nADC #$01\nLBL:\nRTS\n", "BCS LBL\nADC #$01\nLBL:\nRTS\n"},
+        {"carry_label", "CLC\nLBL:\nCLC\nBNE LBL\nRTS\n", "CLC\nLBL:\nCLC\nBNE LBL\nRTS\n"},
+        {"loop", "LOOP:\nCLC\nCLC\nBNE LOOP\nJMP END\nEND:\nRTS\n",
+         "LOOP:\nCLC\nBNE LOOP\nEND:\nRTS\n"},
+        {"fall_through_data", "CLC\nCLC\n.byte 1\n", "CLC\nCLC\n.byte 1\n"},
+        {"data_after_block", "CLC\nCLC\nRTS\nDATA:\n.byte 1\n",
+         "CLC\nRTS\n.org 0x1003\nDATA:\n.byte 1\n"},
+        {"numeric_jump", "CLC\nCLC\nJMP $1003\nRTS\n", "CLC\nCLC\nJMP $1003\nRTS\n"},
+        {"org_boundary", "JMP NEXT\n.org 0x1003\nNEXT:\nRTS\n",
+         "JMP NEXT\n.org 0x1003\nNEXT:\nRTS\n"},
+    }),
+    [](const auto &info) { return std::get<0>(info.param); });
+
+TEST(PeepholeOptimizerIsrTest, VectorFollowsMovedLabel) {
+    auto code = ".isr reset ENTRY\n.org 0x1000\nCLC\nCLC\nENTRY:\nRTS\n"s;
+    auto program = Compile(code, true);
+    EXPECT_EQ(GetOr<uint16_t>(program->FindSymbol("ENTRY")->offset, 0), 0x1001);
+    auto &binary_code = program->sparse_binary_code;
+    EXPECT_EQ(binary_code.At(0xFFFC), 0x01);
+    EXPECT_EQ(binary_code.At(0xFFFD), 0x10);
+}
+
+} // namespace
+} // namespace emu::emu6502::test
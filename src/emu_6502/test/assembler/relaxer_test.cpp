@@ -0,0 +1,78 @@
+#include "assembler_base_test.hpp"
+#include <string>
+#include <tuple>
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace emu::emu6502::assembler;
+
+std::string NopBlock(size_t count) {
+    std::string r;
+    for (size_t i = 0; i < count; ++i) {
+        r += "NOP\n";
+    }
+    return r;
+}
+
+// name, input, expected code, optimize
+using RelaxerTestArg = std::tuple<std::string, std::string, std::string, bool>;
+class RelaxerTest : public testing::TestWithParam<RelaxerTestArg> {};
+
+TEST_P(RelaxerTest, ) {
+    auto &[name, code, expected_code, optimize] = GetParam();
+    auto expected = Compile(".org 0x1000\n" + expected_code, false);
+    auto result = Compile(".org 0x1000\n" + code, optimize);
+    EXPECT_EQ(expected->sparse_binary_code, result->sparse_binary_code)
+        << "RESULT:\n"
+        << result->sparse_binary_code.HexDump() << "\nEXPECTED:\n"
+        << expected->sparse_binary_code.HexDump();
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    , RelaxerTest,
+    ::testing::ValuesIn(std::vector<RelaxerTestArg>{
+        {"zero_page", "LDA VAR\nSTA VAR,X\nLDX VAR,Y\nRTS\n.org 0x10\nVAR:\n.byte 0\n",
+         "LDA $10\nSTA $10,X\nLDX $10,Y\nRTS\n.org 0x10\n.byte 0\n", true},
+        {"zero_page_disabled", "LDA VAR\nRTS\n.org 0x10\nVAR:\n.byte 0\n",
+         ".byte $AD, $10, $00\nRTS\n.org 0x10\n.byte 0\n", false},
+        {"zero_page_absolute", "LDA VAR\nJMP VAR\n.org 0x2000\nVAR:\n.byte 0\n",
+         "LDA $2000\nJMP $2000\n.org 0x2000\n.byte 0\n", true},
+        {"zero_page_no_variant", "LDA VAR,Y\nRTS\n.org 0x10\nVAR:\n.byte 0\n",
+         ".byte $B9, $10, $00\nRTS\n.org 0x10\n.byte 0\n", true},
+        {"zero_page_moves_labels",
+         "LDA VAR\nLOOP:\nDEX\nBNE LOOP\nJMP LOOP\n.org 0x10\nVAR:\n.byte 0\n",
+         "LDA $10\nLOOP:\nDEX\nBNE LOOP\nJMP LOOP\n.org 0x10\n.byte 0\n", true},
+        {"long_branch", "BEQ FAR\nRTS\n.org 0x1100\nFAR:\nRTS\n",
+         "BNE SKIP\nJMP FAR\nSKIP:\nRTS\n.org 0x1100\nFAR:\nRTS\n", false},
+        {"long_branch_backward", "LOOP:\n" + NopBlock(200) + "BCC LOOP\nRTS\n",
+         "LOOP:\n" + NopBlock(200) + "BCS SKIP\nJMP LOOP\nSKIP:\nRTS\n", false},
+        {"long_branch_chain",
+         "NEAR:\n" + NopBlock(123) + "BEQ FAR\nBNE NEAR\nRTS\n.org 0x1100\nFAR:\nRTS\n",
+         "NEAR:\n" + NopBlock(123) +
+             "BNE SKIP1\nJMP FAR\nSKIP1:\nBEQ SKIP2\nJMP NEAR\nSKIP2:\nRTS\n"
+             ".org 0x1100\nFAR:\nRTS\n",
+         false},
+        {"short_branch", "BEQ NEAR\nNOP\nNEAR:\nRTS\n", "BEQ NEAR\nNOP\nNEAR:\nRTS\n",
+         true},
+    }),
+    [](const auto &info) { return std::get<0>(info.param); });
+
+TEST(LongBranchTest, NoSpace) {
+    auto code = ".org 0x1000\nBEQ FAR\nRTS\n.byte 0\n.org 0x1100\nFAR:\nRTS\n";
+    EXPECT_THROW(Compile(code, false), std::exception);
+}
+
+TEST(LongBranchTest, MovesIsrVector) {
+    auto program = Compile(".isr reset ENTRY\n.org 0x1000\nBEQ FAR\nENTRY:\nRTS\n"
+                           ".org 0x1100\nFAR:\nRTS\n",
+                           false);
+    ASSERT_NE(program->FindSymbol("ENTRY"), nullptr);
+    EXPECT_EQ(GetOr<uint16_t>(program->FindSymbol("ENTRY")->offset, 0), 0x1005);
+    auto &code = program->sparse_binary_code;
+    EXPECT_EQ(code.At(kResetVector), 0x05);
+    EXPECT_EQ(code.At(kResetVector + 1), 0x10);
+}
+
+} // namespace
+} // namespace emu::emu6502::test
@@ -2,6 +2,7 @@
 #include "emu_6502/assembler/tokenizer.hpp"
 #include <algorithm>
 #include <gtest/gtest.h>
+#include <optional>
 #include <sstream>
 
 namespace emu::emu6502::test {
@@ -125,5 +126,45 @@ INSTANTIATE_TEST_SUITE_P(, TokenizerListTest,
                              TokenizerTestArg{true, "a,,"s, {}},             //
                          }));
 
+TEST(TokenizerSourceTest, TokensReferToSourceBuffer) {
+    auto source = SourceBuffer::FromString("lda #$10 ; comment\n  sta $20\n", "src");
+    Tokenizer t{source};
+
+    auto l1 = t.NextLine();
+    auto lda = l1.NextToken();
+    EXPECT_EQ(lda, "lda");
+    EXPECT_EQ(lda.View().data(), source->Text().data());
+    EXPECT_EQ(to_string(lda.location), "src:1:3");
+
+    auto l2 = t.NextLine();
+    auto sta = l2.NextToken();
+    auto arg = l2.NextToken();
+    EXPECT_EQ(arg, "$20");
+    EXPECT_EQ(arg.View().data(), source->Text().data() + 25);
+    EXPECT_EQ(to_string(arg.location), "src:2:9");
+    EXPECT_EQ(arg.location.LineContent(), "  sta $20");
+
+    ASSERT_TRUE(t.HasInput());
+    EXPECT_FALSE(t.NextLine().HasInput());
+    EXPECT_FALSE(t.HasInput());
+}
+
+TEST(TokenizerSourceTest, ExceptionOutlivesSource) {
+    std::optional<CompilationException> error;
+    {
+        Tokenizer t{SourceBuffer::FromString("  \"abc", "src")};
+        auto line = t.NextLine();
+        try {
+            line.NextToken();
+        } catch (const CompilationException &e) {
+            error.emplace(e);
+        }
+    }
+    ASSERT_TRUE(error.has_value());
+    EXPECT_EQ(error->Error(), CompilationError::UnfinishedQuotedString);
+    EXPECT_EQ(to_string(error->Location()), "src:1:6");
+    EXPECT_EQ(error->Location().GetDescription(), "0001:   \"abc\n            ^\n");
+}
+
 } // namespace
 } // namespace emu::emu6502::test
@@ -0,0 +1,54 @@
+#include "emu_6502/assembler/compiler.hpp"
+#include "emu_core/program.hpp"
+#include <chrono>
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace emu::emu6502::assembler;
+
+constexpr size_t kBlockCount = 2000;
+constexpr size_t kLinesPerBlock = 9;
+constexpr size_t kBytesPerBlock = 19;
+constexpr Address_t kOrigin = 0x0200;
+
+// Block covering every operand form accepted by ParseInstructionArgument
+std::string GenerateSource() {
+    std::string code = fmt::format(".org {:#06x}\n", kOrigin);
+    for (size_t i = 0; i < kBlockCount; ++i) {
+        code += fmt::format("LABEL_{}:\n", i);
+        code += "    LDA #$10\n"
+                "    LDA $20\n"
+                "    LDA $2000,X\n"
+                "    LDA ($20),Y\n"
+                "    LDA ($20,X)\n"
+                "    STA $3000,Y\n"
+                "    JMP ($4000)\n";
+        code += fmt::format("    BNE LABEL_{}\n", i);
+    }
+    return code;
+}
+
+TEST(AssemblerThroughput, LinesPerSecond) {
+    auto code = GenerateSource();
+
+    auto start = std::chrono::steady_clock::now();
+    auto program = CompileString(code);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    auto lines = kBlockCount * kLinesPerBlock;
+    std::cout << fmt::format("Assembled {} lines in {:.3f}s: {:.0f} lines/s\n", lines,
+                             elapsed.count(), lines / elapsed.count());
+
+    auto [begin, end] = program->sparse_binary_code.CodeRange();
+    EXPECT_EQ(begin, kOrigin);
+    EXPECT_EQ(end - begin + 1u, kBlockCount * kBytesPerBlock);
+    EXPECT_EQ(program->sparse_binary_code.ByteCount(), kBlockCount * kBytesPerBlock);
+    EXPECT_EQ(program->symbols.size(), kBlockCount);
+}
+
+} // namespace
+} // namespace emu::emu6502::test
@@ -0,0 +1,29 @@
+#include <chrono>
+#include <emu_6502/cpu/cpu.hpp>
+#include <emu_6502/cpu/opcode.hpp>
+#include <emu_core/clock_steady.hpp>
+#include <emu_core/memory/memory_sparse.hpp>
+#include <gtest/gtest.h>
+
+namespace emu::emu6502::test {
+namespace {
+
+TEST(DeadlineTest, SlowClockStopsNearDeadline) {
+    ClockSteady clock{k1KhzFrequency};
+    memory::MemorySparse16 memory{&clock, true};
+    cpu::Cpu cpu{&clock, &memory, nullptr, InstructionSet::NMOS6502Emu};
+
+    // Endless loop: JMP $2000
+    memory.WriteRange(kResetVector, {0x00, 0x20});
+    memory.WriteRange(0x2000, {cpu::opcode::INS_JMP_ABS, 0x00, 0x20});
+
+    // Full batch would take at least 2 seconds at 1 kHz
+    auto start = std::chrono::steady_clock::now();
+    cpu.ExecuteFor(std::chrono::milliseconds{50});
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::milliseconds{500});
+    EXPECT_GT(clock.CurrentCycle(), 0u);
+}
+
+} // namespace
+} // namespace emu::emu6502::test
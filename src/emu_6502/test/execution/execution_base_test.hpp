@@ -53,7 +53,7 @@ public:
             emu::emu6502::assembler::CompileString(code, InstructionSet::NMOS6502Emu);
         std::cout << "-----------PROGRAM---------------------\n"
                   << to_string(*program) << "\n";
-        memory.WriteSparse(program->sparse_binary_code.sparse_map);
+        memory.WriteSparse(program->sparse_binary_code.Ranges());
         std::cout << "-----------EXECUTION---------------------\n";
         auto start = std::chrono::steady_clock::now();
         try {
@@ -0,0 +1,27 @@
+#include "execution_base_test.hpp"
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace std::string_literals;
+
+class WatchdogTest : public ExecutionTest {};
+
+TEST_F(WatchdogTest, StopsRunawayLoop) {
+    auto code = R"==(
+.isr reset TEST_ENTRY
+
+.org 0x2000
+
+TEST_ENTRY:
+    JMP TEST_ENTRY
+)=="s;
+
+    clock.ArmWatchdog(1000);
+    EXPECT_THROW(RunCode(code), cpu::WatchdogExpired);
+    EXPECT_GE(clock.CurrentCycle(), 1000u);
+    EXPECT_LT(clock.CurrentCycle(), 1000u + 3 * cpu::Cpu::kDeadlineCheckInterval);
+}
+
+} // namespace
+} // namespace emu::emu6502::test
@@ -178,21 +178,15 @@ std::vector<AssemblerTestArg> GenTestCases(AddressMode filter) {
             if (variant.mode != filter) {
                 continue;
             }
-            auto LABEL_BEFORE = std::make_shared<SymbolInfo>(
-                SymbolInfo{"LABEL_BEFORE", 1_addr, std::nullopt, false});
-            auto LABEL = std::make_shared<SymbolInfo>(
-                SymbolInfo{"LABEL", 0x0010_addr, std::nullopt, false});
-            auto LABEL_AFTER = std::make_shared<SymbolInfo>(
-                SymbolInfo{"LABEL_AFTER", 0x0020_addr, std::nullopt, false});
-
-            auto ALIAS_BEFORE =
-                std::make_shared<ValueAlias>(ValueAlias{"ALIAS_BEFORE", {0x55}});
-            auto ALIAS_BEFORE_LONG = std::make_shared<ValueAlias>(
-                ValueAlias{"ALIAS_BEFORE_LONG", {0x34, 0x12}});
-            auto ALIAS_AFTER =
-                std::make_shared<ValueAlias>(ValueAlias{"ALIAS_AFTER", {0xaa}});
-            auto ALIAS_AFTER_LONG = std::make_shared<ValueAlias>(
-                ValueAlias{"ALIAS_AFTER_LONG", {0x67, 0x89}});
+            auto LABEL_BEFORE = SymbolInfo{"LABEL_BEFORE", 1_addr, std::nullopt, false};
+            auto LABEL = SymbolInfo{"LABEL", 0x0010_addr, std::nullopt, false};
+            auto LABEL_AFTER =
+                SymbolInfo{"LABEL_AFTER", 0x0020_addr, std::nullopt, false};
+
+            auto ALIAS_BEFORE = ValueAlias{"ALIAS_BEFORE", {0x55}};
+            auto ALIAS_BEFORE_LONG = ValueAlias{"ALIAS_BEFORE_LONG", {0x34, 0x12}};
+            auto ALIAS_AFTER = ValueAlias{"ALIAS_AFTER", {0xaa}};
+            auto ALIAS_AFTER_LONG = ValueAlias{"ALIAS_AFTER_LONG", {0x67, 0x89}};
 
             std::string name = fmt::format("{}_{}_{}", instruction.first,
                                            to_string(variant.mode), variant.name);
@@ -255,32 +249,19 @@ ALIAS_AFTER_LONG=0x6789
 
                 expected = Program{
                     .sparse_binary_code = bin_code,
-                    .symbols =
-                        {
-                            {"LABEL_BEFORE", LABEL_BEFORE},
-                            {"LABEL", LABEL},
-                            {"LABEL_AFTER", LABEL_AFTER},
-                        },
-                    .aliases =
-                        {
-                            {"ALIAS_BEFORE", ALIAS_BEFORE},
-                            {"ALIAS_BEFORE_LONG", ALIAS_BEFORE_LONG},
-                            {"ALIAS_AFTER", ALIAS_AFTER},
-                            {"ALIAS_AFTER_LONG", ALIAS_AFTER_LONG},
-                        },
+                    .symbols = {LABEL_BEFORE, LABEL, LABEL_AFTER},
+                    .aliases = {ALIAS_BEFORE, ALIAS_BEFORE_LONG, ALIAS_AFTER,
+                                ALIAS_AFTER_LONG},
                     .relocations = {},
                 };
                 if (!variant.relocation.empty()) {
-                    auto l = expected->symbols[variant.relocation];
-                    auto ri = RelocationInfo{
-                        .target_symbol = l,
+                    expected->relocations.push_back(RelocationInfo{
+                        .target_symbol = *expected->FindSymbolId(variant.relocation),
                         .position = 0x0012,
                         .mode = variant.mode == AddressMode::REL
                                     ? RelocationMode::Relative
                                     : RelocationMode::Absolute,
-                    };
-                    auto sri = std::make_shared<RelocationInfo>(ri);
-                    expected->relocations.insert(sri);
+                    });
                 }
             }
 
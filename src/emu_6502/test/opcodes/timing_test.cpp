@@ -0,0 +1,71 @@
+#include "emu_6502/cpu/cpu.hpp"
+#include "emu_6502/cpu/opcode.hpp"
+#include "emu_6502/instruction_set.hpp"
+#include "emu_core/clock.hpp"
+#include "emu_core/memory/memory_sparse.hpp"
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace emu::emu6502::test {
+namespace {
+
+using namespace emu::emu6502::cpu;
+using namespace emu::emu6502::cpu::opcode;
+
+constexpr MemPtr kCodeAddress = 0x1000;
+
+// With all flags cleared these branches are taken
+bool IsTakenBranch(const OpcodeInfo &info) {
+    return info.mnemonic == "BCC" || info.mnemonic == "BNE" || info.mnemonic == "BPL" ||
+           info.mnemonic == "BVC";
+}
+
+uint64_t ExecuteCycles(const OpcodeInfo &info) {
+    ClockSimple clock;
+    memory::MemorySparse16 memory{&clock};
+    Cpu cpu{&clock, &memory, nullptr, InstructionSet::NMOS6502};
+
+    std::vector<uint8_t> code(1 + ArgumentByteSize(info.addres_mode), 0);
+    code[0] = info.opcode;
+    memory.WriteRange(kCodeAddress, code);
+
+    cpu.reg.program_counter = kCodeAddress;
+    cpu.reg.a = cpu.reg.x = cpu.reg.y = 0;
+    cpu.reg.stack_pointer = kStackResetValue;
+    cpu.reg.flags = 0;
+    cpu.ExecuteNextInstruction();
+    return clock.CurrentCycle();
+}
+
+// Static timing metadata has to agree with the emulated CPU. Operands are zero, so
+// indexed addressing never crosses a page and branches jump to the next instruction.
+TEST(InstructionTimingTest, MatchesExecution) {
+    for (auto &[opcode, info] : GetInstructionSet(InstructionSet::NMOS6502)) {
+        auto timing = GetInstructionTiming(info);
+        uint64_t expected = timing.cycles;
+        if (timing.branch && IsTakenBranch(info)) {
+            ++expected;
+        }
+        EXPECT_EQ(ExecuteCycles(info), expected)
+            << fmt::format("{:02x} {} {}", opcode, info.mnemonic,
+                           to_string(info.addres_mode));
+    }
+}
+
+TEST(InstructionTimingTest, Penalties) {
+    auto &instruction_set = GetInstructionSet(InstructionSet::NMOS6502);
+    auto timing = [&](Opcode opcode) {
+        return GetInstructionTiming(instruction_set.at(opcode));
+    };
+    EXPECT_TRUE(timing(INS_LDA_ABSX).page_cross_penalty);
+    EXPECT_TRUE(timing(INS_LDA_INDY).page_cross_penalty);
+    EXPECT_FALSE(timing(INS_STA_ABSX).page_cross_penalty);
+    EXPECT_FALSE(timing(INS_LDA_ZPX).page_cross_penalty);
+    EXPECT_TRUE(timing(INS_BNE).branch);
+    EXPECT_FALSE(timing(INS_JMP_ABS).branch);
+}
+
+} // namespace
+} // namespace emu::emu6502::test
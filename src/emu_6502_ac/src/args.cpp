@@ -1,10 +1,12 @@
 #include "args.hpp"
+#include <algorithm>
 #include <emu_core/boost_po_utils.hpp>
 #include <emu_core/file_search.hpp>
 #include <filesystem>
 #include <fmt/format.h>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
 
 namespace emu::emu6502::assembler {
 
@@ -36,6 +38,11 @@ struct Options {
         all_options.add_options()
             ("help", "Produce help message")
             ("verbose,v", "Print diagnostic logs during compilation")
+            ("optimize,O", "Run peephole optimizer and select zero page addressing for symbols")
+            ("separate", "Assemble each input as separate object and link them. Unlike default mode, inputs do not share macros or aliases and each input without .org starts at address 0.")
+            ("jobs,j", po::value<unsigned>()->default_value(1), "Number of threads assembling inputs with --separate, 0 uses all cores. Does not change the output.")
+            ("object-cache", po::value<std::string>(), "Directory with cache of assembled inputs, requires --separate")
+            ("watch", "Keep running and update outputs when inputs are modified. Only modified inputs are assembled again with --separate, all of them otherwise.")
             ;
 
         cpu_options.add_options()
@@ -56,6 +63,7 @@ struct Options {
             ("bin-output", po::value<std::string>(), "Store binary image")
             ("hex-dump", po::value<std::string>(), "Write hex dump")
             ("symbol-dump", po::value<std::string>(), "Write symbols")
+            ("listing", po::value<std::string>(), "Write listing with cycle counts of instructions, basic blocks and loops")
             ;
 
         // clang-format on
@@ -93,9 +101,24 @@ struct Options {
 protected:
     void ReadVariableMap(const po::variables_map &vm, ExecArguments &args) {
         args.verbose = vm.count("verbose") > 0;
+        args.optimize = vm.count("optimize") > 0;
+        args.separate = vm.count("separate") > 0;
+        args.jobs = vm["jobs"].as<unsigned>();
+        if (args.jobs == 0) {
+            args.jobs = std::max(1u, std::thread::hardware_concurrency());
+        }
+        if (vm.count("object-cache") > 0) {
+            // Cache stores objects, using it must not change how inputs are assembled
+            if (!args.separate) {
+                throw std::logic_error("--object-cache requires --separate");
+            }
+            args.object_cache = vm["object-cache"].as<std::string>();
+        }
+        args.watch = vm.count("watch") > 0;
 
         ReadInputOptions(args.streams, args.input_options, vm);
-        ReadOutputOptions(args.streams, args.output_options, vm);
+        ReadOutputOptions(args.output_files, vm);
+        args.output_options = OpenOutputs(args.streams, args.output_files);
         ReadMemoryOptions(args.streams, args.memory_options, vm);
     }
 
@@ -105,6 +128,9 @@ protected:
         opts.clear();
         if (vm.count("input") > 0) {
             for (auto &input_file : vm["input"].as<std::vector<std::string>>()) {
+                if (input_file == "-" && vm.count("watch") > 0) {
+                    throw std::logic_error("--watch cannot be used with stdin input");
+                }
                 auto input_name = input_file == "-" ? "stdin"s : input_file;
                 auto input = streams.OpenTextInput(input_file);
                 opts.emplace_back(ExecArguments::Input{input_name, input});
@@ -112,18 +138,19 @@ protected:
         }
     }
 
-    void ReadOutputOptions(StreamContainer &streams, ExecArguments::Output &opts,
+    void ReadOutputOptions(ExecArguments::OutputFiles &opts,
                            const po::variables_map &vm) {
         if (vm.count("bin-output") > 0) {
-            opts.binary_output =
-                streams.OpenBinaryOutput(vm["bin-output"].as<std::string>());
+            opts.binary_output = vm["bin-output"].as<std::string>();
         }
         if (vm.count("hex-dump") > 0) {
-            opts.hex_dump = streams.OpenTextOutput(vm["hex-dump"].as<std::string>());
+            opts.hex_dump = vm["hex-dump"].as<std::string>();
         }
         if (vm.count("symbol-dump") > 0) {
-            opts.symbol_dump =
-                streams.OpenTextOutput(vm["symbol-dump"].as<std::string>());
+            opts.symbol_dump = vm["symbol-dump"].as<std::string>();
+        }
+        if (vm.count("listing") > 0) {
+            opts.listing = vm["listing"].as<std::string>();
         }
     }
 
@@ -154,4 +181,22 @@ ExecArguments ParseComandline(int argc, char **argv) {
     return Options().ParseComandline(argc, argv);
 }
 
+ExecArguments::Output OpenOutputs(StreamContainer &streams,
+                                  const ExecArguments::OutputFiles &files) {
+    ExecArguments::Output output;
+    if (files.binary_output.has_value()) {
+        output.binary_output = streams.OpenBinaryOutput(*files.binary_output);
+    }
+    if (files.hex_dump.has_value()) {
+        output.hex_dump = streams.OpenTextOutput(*files.hex_dump);
+    }
+    if (files.symbol_dump.has_value()) {
+        output.symbol_dump = streams.OpenTextOutput(*files.symbol_dump);
+    }
+    if (files.listing.has_value()) {
+        output.listing = streams.OpenTextOutput(*files.listing);
+    }
+    return output;
+}
+
 } // namespace emu::emu6502::assembler
@@ -5,6 +5,7 @@
 #include <emu_core/stream_container.hpp>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -26,18 +27,39 @@ struct ExecArguments {
         std::ostream *binary_output = nullptr;
         std::ostream *hex_dump = nullptr;
         std::ostream *symbol_dump = nullptr;
+        std::ostream *listing = nullptr;
+    };
+
+    // Names of outputs, in watch mode they are opened again for every update
+    struct OutputFiles {
+        std::optional<std::string> binary_output;
+        std::optional<std::string> hex_dump;
+        std::optional<std::string> symbol_dump;
+        std::optional<std::string> listing;
     };
 
     bool verbose = false;
+    bool optimize = false;
+    // Each input is compiled as separate object and linked, otherwise all inputs are
+    // compiled as one program
+    bool separate = false;
+    // Threads used for separate compilation
+    unsigned jobs = 1;
+    std::optional<std::string> object_cache;
+    // Keep running and update outputs whenever some input file is modified
+    bool watch = false;
 
     Cpu cpu_options;
     std::vector<Input> input_options;
     Output output_options;
+    OutputFiles output_files;
     MemoryConfig memory_options;
 
     StreamContainer streams;
 };
 
 ExecArguments ParseComandline(int argc, char **argv);
+ExecArguments::Output OpenOutputs(StreamContainer &streams,
+                                  const ExecArguments::OutputFiles &files);
 
 } // namespace emu::emu6502::assembler
@@ -0,0 +1,90 @@
+#include "file_watcher.hpp"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fmt/format.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace emu::emu6502::assembler {
+
+namespace fs = std::filesystem;
+
+FileWatcher::FileWatcher() {
+    fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        Error("inotify_init1 failed");
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    ::close(fd);
+}
+
+size_t FileWatcher::Add(const fs::path &file) {
+    auto path = fs::weakly_canonical(file);
+    auto directory = path.parent_path();
+    auto wd = ::inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) {
+        Error("inotify_add_watch failed");
+    }
+    directories[wd] = directory;
+
+    auto id = next_id++;
+    files[path].push_back(id);
+    return id;
+}
+
+std::set<size_t> FileWatcher::Wait() {
+    std::set<size_t> changed;
+    while (changed.empty()) {
+        ReadEvents(changed, -1);
+    }
+    while (ReadEvents(changed, static_cast<int>(kSettleTime.count()))) {
+    }
+    return changed;
+}
+
+bool FileWatcher::ReadEvents(std::set<size_t> &changed, int timeout_ms) {
+    pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+    auto r = ::poll(&pfd, 1, timeout_ms);
+    if (r < 0 && errno != EINTR) {
+        Error("poll failed");
+    }
+    if (r <= 0) {
+        return false;
+    }
+
+    alignas(inotify_event) std::array<char, 4096> buffer;
+    for (;;) {
+        auto length = ::read(fd, buffer.data(), buffer.size());
+        if (length < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                break;
+            }
+            Error("read failed");
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(&buffer[offset]);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            auto directory = directories.find(event->wd);
+            if (event->len == 0 || directory == directories.end()) {
+                continue;
+            }
+            auto it = files.find(directory->second / event->name);
+            if (it != files.end()) {
+                changed.insert(it->second.begin(), it->second.end());
+            }
+        }
+    }
+    return true;
+}
+
+void FileWatcher::Error(const char *msg) {
+    throw std::runtime_error(
+        fmt::format("FileWatcher: {}: {}", msg, std::strerror(errno)));
+}
+
+} // namespace emu::emu6502::assembler
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace emu::emu6502::assembler {
+
+// Reports modified files using inotify. Parent directories are watched, so files
+// replaced by editors (written to temporary file and renamed) are detected as well.
+class FileWatcher {
+public:
+    static constexpr auto kSettleTime = std::chrono::milliseconds(50);
+
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    // Returns id of the file, ids are assigned in order of addition
+    size_t Add(const std::filesystem::path &file);
+
+    // Blocks until some file is modified. Events arriving within kSettleTime are
+    // reported together, so single save is not reported multiple times.
+    std::set<size_t> Wait();
+
+private:
+    int fd = -1;
+    std::map<int, std::filesystem::path> directories;
+    std::map<std::filesystem::path, std::vector<size_t>> files;
+    size_t next_id = 0;
+
+    bool ReadEvents(std::set<size_t> &changed, int timeout_ms);
+    [[noreturn]] static void Error(const char *msg);
+};
+
+} // namespace emu::emu6502::assembler
@@ -1,25 +1,27 @@
 #include "runner.hpp"
 #include "emu_6502/assembler/compilation_error.hpp"
+#include "emu_6502/assembler/linker.hpp"
+#include "emu_6502/assembler/object_cache.hpp"
 #include "emu_core/text_utils.hpp"
+#include "file_watcher.hpp"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <set>
 #include <sstream>
 
 namespace emu::emu6502::assembler {
 
-int Runner::Start(const ExecArguments &exec_args) {
-    verbose = exec_args.verbose;
+namespace {
 
+int ReportError(std::exception_ptr error) {
     try {
-        auto compiler = InitCompiler(exec_args);
-
-        for (auto &input : exec_args.input_options) {
-            compiler->Compile(*input.stream, input.name);
-        }
-
-        auto program = compiler->GetProgram();
-
-        StoreOutput(exec_args.output_options, *program);
-        return 0;
+        std::rethrow_exception(error);
     } catch (const CompilationException &e) {
         std::cout << "Error: " << e.Message() << "\n";
         std::cout << e.Location().GetDescription();
@@ -30,16 +32,260 @@ int Runner::Start(const ExecArguments &exec_args) {
     }
 }
 
+std::string ReadSource(const std::string &file) {
+    std::ifstream input(file);
+    if (!input) {
+        throw std::runtime_error(fmt::format("Input file '{}' is not valid", file));
+    }
+    return {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+int Runner::Start(const ExecArguments &exec_args) {
+    verbose = exec_args.verbose;
+    if (exec_args.watch) {
+        return Watch(exec_args);
+    }
+
+    try {
+        std::unique_ptr<Program> program;
+        if (exec_args.separate) {
+            program = CompileAndLink(exec_args);
+        } else {
+            auto compiler = InitCompiler(exec_args);
+            for (auto &input : exec_args.input_options) {
+                compiler->Compile(*input.stream, input.name);
+            }
+            program = compiler->GetProgram();
+            listing = compiler->GetListing();
+        }
+
+        StoreOutput(exec_args.output_options, *program);
+        return 0;
+    } catch (...) {
+        return ReportError(std::current_exception());
+    }
+}
+
 std::unique_ptr<Compiler6502> Runner::InitCompiler(const ExecArguments &exec_args) {
     auto compiler = std::make_unique<Compiler6502>(exec_args.cpu_options.instruction_set,
                                                    verbose ? &std::cout : nullptr);
 
     auto symbols = symbol_factory->GetSymbols(exec_args.memory_options);
     compiler->AddDefinitions(symbols);
+    compiler->SetOptimize(exec_args.optimize);
+    compiler->SetListing(exec_args.output_options.listing != nullptr);
 
     return compiler;
 }
 
+std::unique_ptr<Program> Runner::CompileAndLink(const ExecArguments &exec_args) {
+    auto &inputs = exec_args.input_options;
+    auto symbols = symbol_factory->GetSymbols(exec_args.memory_options);
+    std::vector<Job> jobs(inputs.size());
+    std::optional<ObjectCache> cache;
+    if (exec_args.object_cache.has_value()) {
+        cache.emplace(*exec_args.object_cache);
+    }
+    std::atomic<size_t> next_input = 0;
+
+    auto worker = [&] {
+        for (auto index = next_input++; index < inputs.size(); index = next_input++) {
+            auto &job = jobs[index];
+            try {
+                auto &input = inputs[index];
+                std::string source{std::istreambuf_iterator<char>(*input.stream),
+                                   std::istreambuf_iterator<char>()};
+                CompileObject(exec_args, symbols, cache ? &*cache : nullptr, input.name,
+                              std::move(source), job);
+            } catch (...) {
+                job.error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    auto worker_count = std::min<size_t>(exec_args.jobs, inputs.size());
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.emplace_back(std::async(std::launch::async, worker));
+    }
+    for (auto &w : workers) {
+        w.get();
+    }
+
+    return Link(exec_args, jobs, false);
+}
+
+void Runner::CompileObject(const ExecArguments &exec_args, const SymbolDefVector &symbols,
+                           const ObjectCache *cache, const std::string &name,
+                           std::string source, Job &job) const {
+    auto with_listing = exec_args.output_options.listing != nullptr;
+    uint64_t key = 0;
+    if (cache != nullptr) {
+        key = ObjectCache::Key(source, exec_args.cpu_options.instruction_set, symbols,
+                               exec_args.optimize);
+        // Cached objects carry no listing, such inputs are assembled again
+        if (!with_listing) {
+            job.object = cache->Load(key);
+        }
+    }
+    if (job.object) {
+        if (verbose) {
+            job.log << fmt::format("Loaded '{}' from object cache {:016x}\n", name, key);
+        }
+        return;
+    }
+
+    Compiler6502 compiler{exec_args.cpu_options.instruction_set,
+                          verbose ? &job.log : nullptr};
+    compiler.AddDefinitions(symbols);
+    compiler.SetOptimize(exec_args.optimize);
+    compiler.SetListing(with_listing);
+    compiler.CompileString(std::move(source), name);
+    job.object = compiler.GetObject();
+    job.listing = compiler.GetListing();
+    job.included_files = compiler.GetIncludedFiles();
+    // Key covers only source text, objects depending on included files are not cached
+    if (cache != nullptr && job.included_files.empty()) {
+        cache->Store(key, *job.object);
+    }
+}
+
+std::unique_ptr<Program> Runner::Link(const ExecArguments &exec_args,
+                                      std::vector<Job> &jobs, bool keep_objects) {
+    auto &inputs = exec_args.input_options;
+    listing.clear();
+    Linker linker{verbose ? &std::cout : nullptr};
+    for (size_t index = 0; index < inputs.size(); ++index) {
+        auto &job = jobs[index];
+        std::cout << job.log.str();
+        job.log.str({});
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+        // Linker consumes objects, watch mode links the same objects again later
+        linker.AddObject(keep_objects ? std::make_unique<Program>(*job.object)
+                                      : std::move(job.object),
+                         inputs[index].name);
+        listing.insert(listing.end(), job.listing.begin(), job.listing.end());
+    }
+    return linker.Link();
+}
+
+int Runner::Watch(const ExecArguments &exec_args) {
+    auto &inputs = exec_args.input_options;
+    std::vector<Job> jobs(inputs.size());
+    std::vector<std::string> sources(inputs.size());
+    bool built = false;
+    int result = 0;
+    try {
+        auto symbols = symbol_factory->GetSymbols(exec_args.memory_options);
+        std::optional<ObjectCache> cache;
+        if (exec_args.object_cache.has_value()) {
+            cache.emplace(*exec_args.object_cache);
+        }
+
+        // Watches are added before inputs are read, so no modification is missed
+        FileWatcher watcher;
+        std::set<size_t> modified;
+        for (auto &input : inputs) {
+            modified.insert(watcher.Add(input.name));
+        }
+        // Watch id of included file -> input including it. Without --separate every
+        // input is assembled again, included files are assigned to the first input.
+        std::map<size_t, size_t> included_by;
+        std::set<std::pair<std::string, size_t>> watched_includes;
+        auto watch_includes = [&](const std::vector<std::string> &files, size_t index) {
+            for (auto &file : files) {
+                if (watched_includes.emplace(file, index).second) {
+                    included_by[watcher.Add(file)] = index;
+                }
+            }
+        };
+
+        for (;; modified = watcher.Wait()) {
+            auto start = std::chrono::steady_clock::now();
+            std::set<size_t> to_assemble;
+            std::set<size_t> include_modified;
+            for (auto id : modified) {
+                if (id < inputs.size()) {
+                    to_assemble.insert(id);
+                } else {
+                    to_assemble.insert(included_by.at(id));
+                    include_modified.insert(included_by.at(id));
+                }
+            }
+
+            size_t assembled = 0;
+            try {
+                std::unique_ptr<Program> program;
+                if (exec_args.separate) {
+                    for (auto index : to_assemble) {
+                        auto &job = jobs[index];
+                        try {
+                            auto source = ReadSource(inputs[index].name);
+                            if (job.object && source == sources[index] &&
+                                !include_modified.contains(index)) {
+                                continue;
+                            }
+                            sources[index] = source;
+                            job = Job{};
+                            CompileObject(exec_args, symbols, cache ? &*cache : nullptr,
+                                          inputs[index].name, std::move(source), job);
+                        } catch (...) {
+                            job = Job{};
+                            job.error = std::current_exception();
+                        }
+                        watch_includes(job.included_files, index);
+                        ++assembled;
+                    }
+                    if (assembled == 0) {
+                        continue;
+                    }
+                    program = Link(exec_args, jobs, true);
+                } else {
+                    bool changed = !built || !include_modified.empty();
+                    for (auto index : to_assemble) {
+                        auto source = ReadSource(inputs[index].name);
+                        if (source != sources[index]) {
+                            sources[index] = std::move(source);
+                            changed = true;
+                        }
+                    }
+                    if (!changed) {
+                        continue;
+                    }
+                    // Inputs share macros, aliases and position, all of them are
+                    // assembled again as without --watch
+                    built = true;
+                    assembled = inputs.size();
+                    auto compiler = InitCompiler(exec_args);
+                    for (size_t index = 0; index < inputs.size(); ++index) {
+                        compiler->CompileString(sources[index], inputs[index].name);
+                    }
+                    program = compiler->GetProgram();
+                    listing = compiler->GetListing();
+                    watch_includes(compiler->GetIncludedFiles(), 0);
+                }
+
+                StreamContainer streams;
+                StoreOutput(OpenOutputs(streams, exec_args.output_files), *program);
+                auto elapsed = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start);
+                std::cout << fmt::format("Assembled {} of {} inputs in {:.1f} ms\n",
+                                         assembled, inputs.size(), elapsed.count());
+            } catch (...) {
+                result = ReportError(std::current_exception());
+            }
+            std::cout.flush();
+        }
+    } catch (...) {
+        result = ReportError(std::current_exception());
+    }
+    return result;
+}
+
 void Runner::StoreOutput(const ExecArguments::Output &output_options, Program &program) {
     if (output_options.binary_output != nullptr) {
         auto bin_data = program.sparse_binary_code.DumpMemory();
@@ -56,6 +302,9 @@ void Runner::StoreOutput(const ExecArguments::Output &output_options, Program &p
         auto out = GenerateSymbolDump(program);
         *output_options.symbol_dump << out;
     }
+    if (output_options.listing != nullptr) {
+        *output_options.listing << FormatListing(program, listing);
+    }
 }
 
 } // namespace emu::emu6502::assembler
@@ -2,8 +2,11 @@
 
 #include "args.hpp"
 #include "emu_6502/assembler/compiler.hpp"
+#include "emu_6502/assembler/object_cache.hpp"
 #include "emu_core/symbol_factory.hpp"
+#include <exception>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -20,9 +23,27 @@ protected:
     const std::shared_ptr<SymbolFactory> symbol_factory;
     bool verbose = false;
 
+    // Separately assembled input
+    struct Job {
+        std::unique_ptr<Program> object;
+        Listing listing;
+        std::vector<std::string> included_files;
+        std::stringstream log;
+        std::exception_ptr error;
+    };
+
     std::unique_ptr<Compiler6502> InitCompiler(const ExecArguments &exec_args);
+    std::unique_ptr<Program> CompileAndLink(const ExecArguments &exec_args);
+    void CompileObject(const ExecArguments &exec_args, const SymbolDefVector &symbols,
+                       const ObjectCache *cache, const std::string &name,
+                       std::string source, Job &job) const;
+    std::unique_ptr<Program> Link(const ExecArguments &exec_args, std::vector<Job> &jobs,
+                                  bool keep_objects);
+    int Watch(const ExecArguments &exec_args);
 
     void StoreOutput(const ExecArguments::Output &output_options, Program &program);
+
+    Listing listing;
 };
 
 } // namespace emu::emu6502::assembler
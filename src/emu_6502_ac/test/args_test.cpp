@@ -0,0 +1,23 @@
+#include "args.hpp"
+#include <array>
+#include <gtest/gtest.h>
+
+namespace emu::emu6502::assembler::test {
+namespace {
+
+TEST(ArgsTest, ObjectCacheRequiresSeparate) {
+    std::array<const char *, 3> argv = {"emu_6502_ac", "--object-cache", "cache"};
+    EXPECT_EXIT(ParseComandline(static_cast<int>(argv.size()),
+                                const_cast<char **>(argv.data())),
+                testing::ExitedWithCode(1), "");
+
+    std::array<const char *, 4> separate = {"emu_6502_ac", "--separate", "--object-cache",
+                                            "cache"};
+    auto args = ParseComandline(static_cast<int>(separate.size()),
+                                const_cast<char **>(separate.data()));
+    EXPECT_TRUE(args.separate);
+    EXPECT_EQ(args.object_cache, "cache");
+}
+
+} // namespace
+} // namespace emu::emu6502::assembler::test
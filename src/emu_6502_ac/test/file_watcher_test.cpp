@@ -0,0 +1,59 @@
+#include "file_watcher.hpp"
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+namespace emu::emu6502::assembler::test {
+namespace {
+
+namespace fs = std::filesystem;
+
+class FileWatcherTest : public testing::Test {
+protected:
+    fs::path directory;
+
+    void SetUp() override {
+        auto test = testing::UnitTest::GetInstance()->current_test_info();
+        directory = fs::temp_directory_path() /
+                    fmt::format("emu_file_watcher_test_{}_{}", ::getpid(), test->name());
+        fs::create_directories(directory);
+        Write("a.asm", "NOP\n");
+        Write("b.asm", "NOP\n");
+    }
+    void TearDown() override { fs::remove_all(directory); }
+
+    void Write(const std::string &name, const std::string &content) {
+        std::ofstream(directory / name) << content;
+    }
+};
+
+TEST_F(FileWatcherTest, ReportsModifiedFile) {
+    FileWatcher watcher;
+    auto a = watcher.Add(directory / "a.asm");
+    auto b = watcher.Add(directory / "b.asm");
+    EXPECT_EQ(b, a + 1);
+
+    // Events are queued, so modifications made before Wait are reported
+    Write("b.asm", "INX\n");
+    Write("unrelated.txt", "");
+    EXPECT_EQ(watcher.Wait(), std::set<size_t>{b});
+
+    Write("a.asm", "INY\n");
+    Write("a.asm", "INX\n");
+    EXPECT_EQ(watcher.Wait(), std::set<size_t>{a});
+}
+
+TEST_F(FileWatcherTest, ReportsReplacedFile) {
+    FileWatcher watcher;
+    auto a = watcher.Add(directory / "a.asm");
+
+    // Editors often save to temporary file and rename it
+    Write("a.asm.tmp", "INX\n");
+    fs::rename(directory / "a.asm.tmp", directory / "a.asm");
+    EXPECT_EQ(watcher.Wait(), std::set<size_t>{a});
+}
+
+} // namespace
+} // namespace emu::emu6502::assembler::test
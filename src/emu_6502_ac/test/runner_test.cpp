@@ -0,0 +1,72 @@
+#include "runner.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace emu::emu6502::assembler::test {
+namespace {
+
+struct NoSymbolFactory : public SymbolFactory {
+    SymbolDefVector GetSymbols(const MemoryConfigEntry &,
+                               const MemoryConfigEntry::MappedDevice &) const override {
+        return {};
+    }
+};
+
+class RunnerTest : public testing::Test {
+protected:
+    const std::vector<std::string> sources = {
+        ".org 0x1000\nSTART:\n    JSR FUNC\n    RTS\n.macro M\n    NOP\n.endm\n",
+        "FUNC:\n    LDA #$01\n    RTS\n",
+    };
+
+    // Returns hex dump of the result, or nullopt when assembly failed
+    std::optional<std::string> Assemble(bool separate, unsigned jobs,
+                                        const std::vector<std::string> &inputs) {
+        std::vector<std::stringstream> streams;
+        for (auto &source : inputs) {
+            streams.emplace_back(source);
+        }
+        std::stringstream hex_dump;
+        ExecArguments args;
+        args.separate = separate;
+        args.jobs = jobs;
+        for (size_t i = 0; i < streams.size(); ++i) {
+            args.input_options.push_back({fmt::format("input{}.asm", i), &streams[i]});
+        }
+        args.output_options.hex_dump = &hex_dump;
+
+        Runner runner{std::make_shared<NoSymbolFactory>()};
+        if (runner.Start(args) != 0) {
+            return std::nullopt;
+        }
+        return hex_dump.str();
+    }
+};
+
+TEST_F(RunnerTest, JobsDoNotChangeOutput) {
+    auto sequential = Assemble(false, 1, sources);
+    ASSERT_TRUE(sequential.has_value());
+    EXPECT_EQ(Assemble(false, 4, sources), sequential);
+
+    auto separate = Assemble(true, 1, sources);
+    ASSERT_TRUE(separate.has_value());
+    EXPECT_EQ(Assemble(true, 4, sources), separate);
+}
+
+TEST_F(RunnerTest, SeparateAssembly) {
+    // Second input continues after the first one only when compiled together
+    auto combined = Assemble(false, 1, sources);
+    auto separate = Assemble(true, 1, sources);
+    ASSERT_TRUE(combined.has_value());
+    ASSERT_TRUE(separate.has_value());
+    EXPECT_NE(*combined, *separate);
+
+    // Macros are visible only within their input in separate mode
+    auto with_macro = sources;
+    with_macro[1] += "    M\n";
+    EXPECT_TRUE(Assemble(false, 1, with_macro).has_value());
+    EXPECT_FALSE(Assemble(true, 1, with_macro).has_value());
+}
+
+} // namespace
+} // namespace emu::emu6502::assembler::test
@@ -4,10 +4,13 @@
 #include "emu_core/file_search.hpp"
 #include "emu_core/package/package_builder.hpp"
 #include "emu_core/package/package_fs.hpp"
+#include "emu_core/package/package_mapped.hpp"
 #include "emu_core/package/package_zip.hpp"
 #include "emu_core/string_file.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/string_file.hpp>
+#include <algorithm>
+#include <array>
 #include <boost/program_options.hpp>
 #include <filesystem>
 #include <fmt/format.h>
@@ -33,6 +36,7 @@ const std::unordered_map<std::string, std::set<Verbose>> kVerboseAreas = {
             Verbose::Cpu,
             Verbose::Clock,
             Verbose::Device,
+            Verbose::Assembler,
         },
     },
     {"base", {Verbose::Result, Verbose::Cpu, Verbose::Clock, Verbose::Device}},
@@ -42,14 +46,24 @@ const std::unordered_map<std::string, std::set<Verbose>> kVerboseAreas = {
     {"clock", {Verbose::Clock}},
     {"memory", {Verbose::Memory}},
     {"memorymapper", {Verbose::MemoryMapper}},
+    {"assembler", {Verbose::Assembler}},
 };
 
+constexpr std::array kAssemblySourceExtensions = {".asm", ".s"};
+
+bool IsAssemblySource(const std::filesystem::path &path) {
+    auto ext = path.extension().generic_string();
+    return std::find(kAssemblySourceExtensions.begin(), kAssemblySourceExtensions.end(),
+                     ext) != kAssemblySourceExtensions.end();
+}
+
 const ConflictingOptionsVec kConflictingOptions = {};
 
 struct Options {
     po::options_description all_options;
     po::options_description cpu_options{"Cpu options"};
     po::options_description image_options{"Image load options"};
+    po::options_description assembly_options{"Assembly options"};
     po::positional_options_description image_positional_opt;
 
     std::shared_ptr<FileSearch> file_search = FileSearch::CreateDefault();
@@ -71,14 +85,22 @@ struct Options {
 
         image_positional_opt.add("image", -1);
         image_options.add_options()
-            ("image", po::value<std::string>()->required(), "Image to run")
+            ("image", po::value<std::vector<std::string>>()->required(), "Image to run or assembly sources")
+            ("lazy-load", "Load ram images page by page on first access")
+            ("prefetch", "Load remaining pages of lazy loaded images in background")
+            ;
+
+        assembly_options.add_options()
+            ("config", po::value<std::string>(), "Memory configuration for assembly sources. Assembled image is referenced as $image_file")
+            ("optimize,O", "Run peephole optimizer and select zero page addressing for symbols")
             ;
 
         // clang-format on
 
-        all_options             //
-            .add(cpu_options)   //
-            .add(image_options) //
+        all_options                //
+            .add(cpu_options)      //
+            .add(image_options)    //
+            .add(assembly_options) //
             ;
     }
 
@@ -130,9 +152,10 @@ protected:
         }
 
         ReadCpuOptions(args.streams, args.cpu_options, vm);
+        ReadImageOptions(args.image_options, vm);
         OpenPackage(args, vm);
 
-        if (!args.package) {
+        if (!args.package && args.assembly_options.sources.empty()) {
             throw std::logic_error("Image/config to run was not provided");
         }
     }
@@ -142,12 +165,53 @@ protected:
         opts.frequency = vm["frequency"].as<uint64_t>();
     }
 
+    void ReadImageOptions(ExecArguments::ImageOptions &opts, const po::variables_map &vm) {
+        opts.lazy_load = vm.count("lazy-load") > 0;
+        opts.prefetch = vm.count("prefetch") > 0;
+        if (opts.prefetch && !opts.lazy_load) {
+            throw std::logic_error("--prefetch requires --lazy-load");
+        }
+    }
+
+    void ReadAssemblyOptions(ExecArguments::AssemblyOptions &opts,
+                             const std::vector<std::string> &sources,
+                             const po::variables_map &vm) {
+        if (vm.count("config") == 0) {
+            throw std::logic_error("Assembly sources require --config");
+        }
+        for (auto &source : sources) {
+            if (!std::filesystem::is_regular_file(source)) {
+                throw std::runtime_error(fmt::format("file {} is not valid", source));
+            }
+        }
+        auto config = vm["config"].as<std::string>();
+        auto searcher = file_search->PrependPath(
+            std::filesystem::path(config).parent_path().generic_string());
+        opts.sources = sources;
+        opts.memory_config = LoadMemoryConfigurationFromFile(
+            config, searcher.get(), {{"image_file", std::string{kAssembledImageName}}});
+        opts.optimize = vm.count("optimize") > 0;
+    }
+
     void OpenPackage(ExecArguments &args, const po::variables_map &vm) {
         if (vm.count("image") != 1) {
             throw std::runtime_error("image path is not correct");
         }
 
-        auto config = vm["image"].as<std::string>();
+        auto images = vm["image"].as<std::vector<std::string>>();
+        if (std::all_of(images.begin(), images.end(), IsAssemblySource)) {
+            ReadAssemblyOptions(args.assembly_options, images, vm);
+            return;
+        }
+        if (images.size() != 1) {
+            throw std::logic_error(
+                "Multiple images are allowed only for assembly sources");
+        }
+        if (vm.count("config") > 0 || vm.count("optimize") > 0) {
+            throw std::logic_error("--config and --optimize require assembly sources");
+        }
+
+        auto config = images.front();
 
         auto path = std::filesystem::path(config);
         if (!std::filesystem::is_regular_file(path)) {
@@ -164,6 +228,9 @@ protected:
         } else if (ext == package::kEmuImageExtension) {
             args.package = std::make_unique<package::ZipPackage>(config);
             return;
+        } else if (ext == package::kEmuMappedImageExtension) {
+            args.package = std::make_unique<package::MappedPackage>(config);
+            return;
         } else {
             auto config_name = path.filename().generic_string();
             MemoryConfigEntry area;
@@ -19,19 +19,38 @@ enum class Verbose {
     Device,
     Memory,
     MemoryMapper,
+    Assembler,
 };
 
+// Name of image assembled from sources, as seen by memory configuration
+constexpr std::string_view kAssembledImageName = "assembled.bin";
+
 struct ExecArguments {
     struct CpuOptions {
         uint64_t frequency = 0;
         emu6502::InstructionSet instruction_set = emu6502::InstructionSet::NMOS6502Emu;
     };
 
+    struct ImageOptions {
+        bool lazy_load = false;
+        bool prefetch = false;
+    };
+
+    // Sources assembled in memory and run without intermediate image
+    struct AssemblyOptions {
+        std::vector<std::string> sources;
+        MemoryConfig memory_config;
+        bool optimize = false;
+    };
+
     std::set<Verbose> verbose;
     std::ostream *verbose_stream = &std::cout;
     std::ostream *GetVerboseStream(Verbose v) const;
 
     CpuOptions cpu_options;
+    ImageOptions image_options;
+    AssemblyOptions assembly_options;
+    // Not set when image is assembled from sources
     std::unique_ptr<package::IPackage> package;
 
     StreamContainer streams;
@@ -1,4 +1,5 @@
 #include "args.hpp"
+#include "emu_6502/assembler/compilation_error.hpp"
 #include "emu_6502/assembler/compiler.hpp"
 #include "emu_6502/cpu/cpu.hpp"
 #include "emu_core/plugins/plugin_loader.hpp"
@@ -13,12 +14,19 @@ int main(int argc, char **argv) {
     namespace fs = std::filesystem;
 
     try {
+        // Package in args must outlive the simulation held by runner
+        auto args = ParseComandline(argc, argv);
         auto plugin_loader =
             PluginLoader::CreateDynamic(fs::absolute(fs::path(*argv)).parent_path());
-        auto runner = std::make_shared<Runner>(plugin_loader->GetDeviceFactory());
-        auto args = ParseComandline(argc, argv);
+        auto runner = std::make_shared<Runner>(plugin_loader->GetDeviceFactory(),
+                                               plugin_loader->GetSymbolFactory());
         runner->Setup(args);
         return runner->Start();
+    } catch (const emu::emu6502::assembler::CompilationException &e) {
+        std::cerr << "ERROR: " << e.Message() << "\n";
+        if (e.HasToken()) {
+            std::cerr << e.Location().GetDescription();
+        }
     } catch (const std::exception &e) {
         std::cerr << "ERROR: " << e.what() << "\n";
     }
@@ -1,7 +1,9 @@
 #include "runner.hpp"
+#include "emu_6502/assembler/compiler.hpp"
 #include "emu_6502/cpu/verbose_debugger.hpp"
 #include "emu_core/clock_steady.hpp"
 #include "emu_core/memory/memory_block.hpp"
+#include "emu_core/package/package_memory.hpp"
 #include "emu_core/simulation/simulation_builder.hpp"
 #include "emu_core/string_file.hpp"
 
@@ -23,7 +25,37 @@ void Runner::Setup(const ExecArguments &exec_args) {
         .instruction_set = exec_args.cpu_options.instruction_set,
     };
 
-    simulation = BuildEmuSimulation(device_factory, exec_args.package.get(), cpu, vc);
+    auto mc = SimulationBuildMemoryConfig{
+        .lazy_images = exec_args.image_options.lazy_load,
+        .prefetch_images = exec_args.image_options.prefetch,
+    };
+
+    auto *package = exec_args.package.get();
+    if (!exec_args.assembly_options.sources.empty()) {
+        assembled_package = Assemble(exec_args);
+        package = assembled_package.get();
+    }
+
+    simulation = BuildEmuSimulation(device_factory, package, cpu, vc, mc);
+}
+
+std::unique_ptr<package::IPackage> Runner::Assemble(const ExecArguments &exec_args) {
+    auto &opts = exec_args.assembly_options;
+    emu6502::assembler::Compiler6502 compiler{
+        exec_args.cpu_options.instruction_set,
+        exec_args.GetVerboseStream(Verbose::Assembler),
+    };
+    compiler.AddDefinitions(symbol_factory->GetSymbols(opts.memory_config));
+    compiler.SetOptimize(opts.optimize);
+    for (auto &source : opts.sources) {
+        compiler.CompileFile(source);
+    }
+    auto program = compiler.GetProgram();
+
+    auto package = std::make_unique<package::MemoryPackage>(opts.memory_config);
+    package->AddFile(std::string{kAssembledImageName},
+                     program->sparse_binary_code.DumpMemory());
+    return package;
 }
 
 int Runner::Start() {
@@ -52,11 +84,18 @@ int Runner::Start() {
             halt_code = std::to_string(r.halt_code.value_or(0));
         }
         (*result_verbose) << fmt::format("Halt code {}\n", halt_code);
+        if (r.stop_reason == EmuSimulation::StopReason::kWatchdog) {
+            (*result_verbose) << "Watchdog expired\n";
+        }
         (*result_verbose) << fmt::format("Took {:.6f} seconds\n", r.duration);
         (*result_verbose) << fmt::format("Cpu cycles: {} ({:.3f} Hz)\n", r.cpu_cycles,
                                          static_cast<double>(r.cpu_cycles) / r.duration);
+        (*result_verbose) << fmt::format("Cpu instructions: {}\n", r.cpu_instructions);
     }
 
+    if (r.stop_reason == EmuSimulation::StopReason::kWatchdog) {
+        return kWatchdogExitCode;
+    }
     return r.halt_code.value_or(0);
 }
 
@@ -8,6 +8,7 @@
 #include "emu_core/memory/memory_mapper.hpp"
 #include "emu_core/memory_configuration_file.hpp"
 #include "emu_core/simulation/simulation.hpp"
+#include "emu_core/symbol_factory.hpp"
 #include <memory>
 #include <string>
 #include <string_view>
@@ -17,17 +18,26 @@
 namespace emu::runner {
 
 struct Runner {
-    Runner(std::shared_ptr<DeviceFactory> _device_factory)
-        : device_factory(_device_factory) {}
+    static constexpr int kWatchdogExitCode = -2;
+
+    Runner(std::shared_ptr<DeviceFactory> _device_factory,
+           std::shared_ptr<SymbolFactory> _symbol_factory)
+        : device_factory(std::move(_device_factory)),
+          symbol_factory(std::move(_symbol_factory)) {}
 
     void Setup(const ExecArguments &exec_args);
     int Start();
 
 protected:
     const std::shared_ptr<DeviceFactory> device_factory;
+    const std::shared_ptr<SymbolFactory> symbol_factory;
     std::ostream *result_verbose = nullptr;
 
+    // Must outlive the simulation
+    std::unique_ptr<package::IPackage> assembled_package;
     std::unique_ptr<EmuSimulation> simulation;
+
+    std::unique_ptr<package::IPackage> Assemble(const ExecArguments &exec_args);
 };
 
 } // namespace emu::runner
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -23,6 +24,18 @@ constexpr int16_t operator"" _416(unsigned long long n) {
     return static_cast<int16_t>(n);
 }
 
+constexpr uint64_t kFnv1aOffsetBasis = 0xcbf29ce484222325ull;
+
+// 64 bit FNV-1a of bytes or chars, pass previous result as hash to continue hashing
+template <typename Range>
+constexpr uint64_t Fnv1aHash(const Range &data, uint64_t hash = kFnv1aOffsetBasis) {
+    for (auto item : data) {
+        hash ^= static_cast<uint8_t>(item);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
 uint8_t ParseByte(std::string_view text, int base = 0);
 uint16_t ParseWord(std::string_view text, int base = 0);
 std::vector<uint8_t>
@@ -21,11 +21,45 @@ struct Clock {
     [[nodiscard]] virtual uint64_t LostCycles() const { return 0; };
 
     [[nodiscard]] virtual double Time() const { return 0.0; };
+
+    // Updated by cpu after each instruction, cleared by Reset
+    [[nodiscard]] uint64_t RetiredInstructions() const { return retired_instructions; }
+    void RetireInstruction() { ++retired_instructions; }
+
+    // Simulation is stopped when timeout cycles pass without arming watchdog again;
+    // polled by cpu every few instructions. Reset starts the timeout from cycle 0.
+    void ArmWatchdog(uint64_t timeout) {
+        watchdog_timeout = timeout;
+        watchdog_cycle = CurrentCycle() + timeout;
+    }
+    void DisarmWatchdog() {
+        watchdog_timeout = kWatchdogDisarmed;
+        watchdog_cycle = kWatchdogDisarmed;
+    }
+    [[nodiscard]] bool WatchdogExpired() const {
+        return watchdog_cycle != kWatchdogDisarmed && CurrentCycle() >= watchdog_cycle;
+    }
+
+protected:
+    static constexpr uint64_t kWatchdogDisarmed = UINT64_MAX;
+
+    uint64_t retired_instructions = 0;
+    uint64_t watchdog_timeout = kWatchdogDisarmed;
+    uint64_t watchdog_cycle = kWatchdogDisarmed;
+
+    // Clears state of previous run, has to be called when cycle counter is reset
+    void ResetCounters() {
+        retired_instructions = 0;
+        watchdog_cycle = watchdog_timeout;
+    }
 };
 
 struct ClockSimple : public Clock {
     void WaitForNextCycle() override { ++current_cycle; }
-    void Reset() override { current_cycle = 0; }
+    void Reset() override {
+        current_cycle = 0;
+        ResetCounters();
+    }
     [[nodiscard]] uint64_t CurrentCycle() const override { return current_cycle; }
     [[nodiscard]] double Time() const override {
         return static_cast<double>(current_cycle);
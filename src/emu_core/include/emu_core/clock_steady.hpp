@@ -57,6 +57,7 @@ struct ClockSteady final : public Clock {
 
     void Reset() override {
         current_cycle = 0;
+        ResetCounters();
         start_time = steady_clock::now();
         next_cycle = start_time + tick;
     }
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace emu {
+
+// Entries with unique `name` member, identified by index of insertion. Entries are
+// allocated in chunks and never moved nor freed before the table, so references and
+// interned names stay valid while entries are added. Iteration follows insertion order.
+template <typename T>
+class InternedTable {
+public:
+    using Id = uint32_t;
+    using value_type = T;
+    using Storage = std::deque<T>;
+
+    InternedTable() = default;
+    InternedTable(std::initializer_list<T> init) {
+        for (auto &entry : init) {
+            Add(entry);
+        }
+    }
+    InternedTable(const InternedTable &other) { *this = other; }
+    InternedTable(InternedTable &&other) noexcept = default;
+
+    InternedTable &operator=(const InternedTable &other) {
+        if (this != &other) {
+            clear();
+            for (auto &entry : other) {
+                Add(entry);
+            }
+        }
+        return *this;
+    }
+    InternedTable &operator=(InternedTable &&other) noexcept = default;
+
+    // Entry with the same name must not exist
+    Id Add(T entry) {
+        auto id = static_cast<Id>(entries.size());
+        auto &stored = entries.emplace_back(std::move(entry));
+        index.emplace(std::string_view{stored.name}, id);
+        return id;
+    }
+
+    [[nodiscard]] std::optional<Id> FindId(std::string_view name) const {
+        auto it = index.find(name);
+        return it == index.end() ? std::nullopt : std::optional<Id>{it->second};
+    }
+    [[nodiscard]] T *Find(std::string_view name) {
+        auto it = index.find(name);
+        return it == index.end() ? nullptr : &entries[it->second];
+    }
+    [[nodiscard]] const T *Find(std::string_view name) const {
+        auto it = index.find(name);
+        return it == index.end() ? nullptr : &entries[it->second];
+    }
+    [[nodiscard]] bool contains(std::string_view name) const {
+        return index.contains(name);
+    }
+
+    T &operator[](Id id) { return entries[id]; }
+    const T &operator[](Id id) const { return entries[id]; }
+
+    [[nodiscard]] size_t size() const { return entries.size(); }
+    [[nodiscard]] bool empty() const { return entries.empty(); }
+    void clear() {
+        index.clear();
+        entries.clear();
+    }
+
+    auto begin() { return entries.begin(); }
+    auto end() { return entries.end(); }
+    auto begin() const { return entries.begin(); }
+    auto end() const { return entries.end(); }
+
+private:
+    Storage entries;
+    std::unordered_map<std::string_view, Id> index;
+};
+
+// Read-only view of a table in the shape of a map from name to entry pointer. Iteration
+// follows insertion order, the view is valid as long as the table is.
+template <typename T>
+class InternedTableMapView {
+public:
+    using key_type = std::string_view;
+    using mapped_type = const T *;
+    using value_type = std::pair<const std::string_view, const T *>;
+
+    class const_iterator {
+    public:
+        using Base = typename InternedTable<T>::Storage::const_iterator;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = InternedTableMapView::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        const_iterator() = default;
+        explicit const_iterator(Base it) : it(it) {}
+
+        reference operator*() const {
+            current.emplace(it->name, &*it);
+            return *current;
+        }
+        pointer operator->() const { return &**this; }
+        const_iterator &operator++() {
+            ++it;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto r = *this;
+            ++it;
+            return r;
+        }
+        bool operator==(const const_iterator &other) const { return it == other.it; }
+
+    private:
+        Base it;
+        mutable std::optional<value_type> current;
+    };
+
+    explicit InternedTableMapView(const InternedTable<T> &table) : table(&table) {}
+
+    [[nodiscard]] const T *at(std::string_view name) const {
+        if (auto *entry = table->Find(name); entry != nullptr) {
+            return entry;
+        }
+        throw std::out_of_range("InternedTableMapView::at");
+    }
+    [[nodiscard]] bool contains(std::string_view name) const {
+        return table->contains(name);
+    }
+    [[nodiscard]] size_t count(std::string_view name) const {
+        return table->contains(name) ? 1 : 0;
+    }
+    [[nodiscard]] size_t size() const { return table->size(); }
+    [[nodiscard]] bool empty() const { return table->empty(); }
+
+    const_iterator begin() const { return const_iterator{table->begin()}; }
+    const_iterator end() const { return const_iterator{table->end()}; }
+
+private:
+    const InternedTable<T> *table;
+};
+
+} // namespace emu
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "emu_core/clock.hpp"
+#include "emu_core/memory.hpp"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace emu::memory {
+
+// Memory initialized from external image (e.g. package entry) page by page, on first
+// access. Untouched pages are never fetched nor allocated. Optional prefetch thread
+// fetches remaining pages in background.
+template <std::unsigned_integral _Address_t>
+struct MemoryLazy : public MemoryInterface<_Address_t> {
+    using Address_t = _Address_t;
+    using Iface = MemoryInterface<_Address_t>;
+
+    using VectorType = std::vector<uint8_t>;
+    // Returns [offset, offset + length) of the image. Shorter result is zero filled.
+    // Called under lock, from cpu or prefetch thread.
+    using PageLoader = std::function<VectorType(size_t offset, size_t length)>;
+
+    static constexpr size_t kPageSize = 4096;
+
+    Clock *const clock;
+    std::ostream *const verbose_stream;
+    const MemoryMode mode;
+    const size_t size;
+    std::string name;
+
+    MemoryLazy(Clock *clock, size_t size, PageLoader loader,
+               MemoryMode mode = MemoryMode::kReadWrite, bool prefetch = false,
+               std::ostream *verbose_stream = nullptr, std::string name = "")
+        : clock(clock), verbose_stream(verbose_stream), mode(mode), size(size),
+          name(std::move(name)), loader(std::move(loader)),
+          pages(std::make_unique<std::atomic<uint8_t *>[]>(PageCount())) {
+        if (prefetch) {
+            prefetch_thread = std::thread([this] { PrefetchMain(); });
+        }
+    }
+
+    ~MemoryLazy() override {
+        stopping = true;
+        if (prefetch_thread.joinable()) {
+            prefetch_thread.join();
+        }
+    }
+
+    uint8_t Load(Address_t address) const override {
+        if (address >= size) {
+            throw MemoryOutOfBoundAccessException(address, size, "MemoryLazy");
+        }
+        WaitForNextCycle();
+        auto v = Page(address)[address % kPageSize];
+        AccessLog(address, v, false);
+        return v;
+    }
+
+    void Store(Address_t address, uint8_t value) override {
+        WaitForNextCycle();
+        AccessLog(address, value, true);
+        if (CanWrite(address)) {
+            Page(address)[address % kPageSize] = value;
+        }
+    }
+
+    [[nodiscard]] MemoryMode Mode() const override { return mode; }
+
+    [[nodiscard]] std::optional<uint8_t> DebugRead(Address_t address) const override {
+        if (address >= size) {
+            return std::nullopt;
+        }
+        return Page(address)[address % kPageSize];
+    }
+
+    [[nodiscard]] size_t PageCount() const { return (size + kPageSize - 1) / kPageSize; }
+    [[nodiscard]] size_t LoadedPageCount() const {
+        std::lock_guard<std::mutex> lock{load_mutex};
+        return loaded_pages.size();
+    }
+
+private:
+    PageLoader loader;
+    std::unique_ptr<std::atomic<uint8_t *>[]> pages;
+
+    mutable std::mutex load_mutex;
+    mutable std::vector<std::unique_ptr<uint8_t[]>> loaded_pages;
+
+    std::atomic<bool> stopping = false;
+    std::thread prefetch_thread;
+
+    uint8_t *Page(Address_t address) const {
+        auto index = address / kPageSize;
+        if (auto *page = pages[index].load(std::memory_order_acquire); page != nullptr) {
+            return page;
+        }
+        return FetchPage(index);
+    }
+
+    uint8_t *FetchPage(size_t index) const {
+        std::lock_guard<std::mutex> lock{load_mutex};
+        if (auto *page = pages[index].load(std::memory_order_relaxed); page != nullptr) {
+            return page;
+        }
+
+        auto offset = index * kPageSize;
+        auto length = std::min(kPageSize, size - offset);
+        auto data = loader(offset, length);
+
+        auto page = std::make_unique<uint8_t[]>(length);
+        std::copy_n(data.begin(), std::min(data.size(), length), page.get());
+        auto *ptr = loaded_pages.emplace_back(std::move(page)).get();
+        pages[index].store(ptr, std::memory_order_release);
+        return ptr;
+    }
+
+    void PrefetchMain() {
+        try {
+            for (size_t index = 0; index < PageCount() && !stopping; ++index) {
+                if (pages[index].load(std::memory_order_acquire) == nullptr) {
+                    FetchPage(index);
+                }
+            }
+        } catch (const std::exception &e) {
+            // Failed page stays unloaded, so the error is reported to cpu on access
+            if (verbose_stream != nullptr) {
+                (*verbose_stream) << "MemoryLazy " << name
+                                  << ": prefetch stopped: " << e.what() << "\n";
+            }
+        }
+    }
+
+    [[nodiscard]] bool CanWrite(Address_t address) const {
+        if (address >= size) {
+            throw MemoryOutOfBoundAccessException(address, size, "MemoryLazy");
+        }
+
+        switch (mode) {
+        case MemoryMode::kReadOnly:
+            return false;
+        case MemoryMode::kThrowOnWrite:
+            throw MemoryWriteAttemptException(address, size, "MemoryLazy");
+        case MemoryMode::kReadWrite:
+            break;
+        }
+        return true;
+    }
+
+    void AccessLog(Address_t address, uint8_t value, bool write) const {
+        if (verbose_stream != nullptr) {
+            Iface::WriteAccessLog(*verbose_stream, "LAZY", name, write, address, value,
+                                  "");
+        }
+    }
+
+    void WaitForNextCycle() const {
+        if (clock != nullptr) {
+            clock->WaitForNextCycle();
+        }
+    }
+};
+
+using MemoryLazy16 = MemoryLazy<uint16_t>;
+
+} // namespace emu::memory
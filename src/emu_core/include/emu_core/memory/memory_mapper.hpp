@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <fmt/format.h>
 #include <iostream>
+#include <limits>
 #include <optional>
 #include <set>
 #include <stdexcept>
@@ -56,6 +57,8 @@ struct MemoryMapper : public MemoryInterface<_Address_t> {
     MemoryMapper(Clock *clock, bool strict_access = false,
                  std::ostream *verbose_stream = nullptr)
         : MemoryMapper(clock, {}, strict_access, verbose_stream) {}
+    MemoryMapper(const MemoryMapper &) = delete;
+    MemoryMapper &operator=(const MemoryMapper &) = delete;
 
     void MapArea(Address_t offset, Address_t size, AreaInterface mem_iface) {
         auto end_addr = static_cast<Address_t>(offset + size - 1);
@@ -64,13 +67,23 @@ struct MemoryMapper : public MemoryInterface<_Address_t> {
 
     void MapArea(RangePair range, AreaInterface mem_iface) {
         if (mem_iface == nullptr) {
-            //TODO
+            throw std::runtime_error(fmt::format(
+                "MemoryMapper: Attempt to map null area at {:04x}:{:04x}", range.first,
+                range.second));
         }
         if (range.first > range.second) {
-            //TODO
+            throw std::runtime_error(fmt::format("MemoryMapper: Invalid range {:04x}:{:04x}",
+                                                 range.first, range.second));
         }
-        //TODO: verify overlapping ranges
-        areas.emplace(range, std::move(mem_iface));
+        for (auto &[other, ptr] : areas) {
+            if (range.first <= other.second && other.first <= range.second) {
+                throw std::runtime_error(fmt::format(
+                    "MemoryMapper: Range {:04x}:{:04x} overlaps mapped {:04x}:{:04x}",
+                    range.first, range.second, other.first, other.second));
+            }
+        }
+        auto it = areas.emplace(range, std::move(mem_iface)).first;
+        UpdatePageTable(*it);
     }
 
     uint8_t Load(Address_t address) const override {
@@ -115,9 +128,37 @@ struct MemoryMapper : public MemoryInterface<_Address_t> {
     }
 
 private:
+    // Pages fully covered by a single area are resolved with single table lookup.
+    // Pages shared by several areas (e.g. small devices) fall back to area search.
+    static constexpr unsigned kPageBits = 8;
+    static constexpr bool kUsePageTable = sizeof(Address_t) <= 2;
+    static constexpr size_t kPageCount =
+        kUsePageTable ? (size_t{std::numeric_limits<Address_t>::max()} >> kPageBits) + 1
+                      : 0;
+
     AreaSet areas;
+    std::array<const Area *, kPageCount> page_table{};
+
+    void UpdatePageTable(const Area &area) {
+        if constexpr (kUsePageTable) {
+            auto [min, max] = area.first;
+            for (size_t page = min >> kPageBits; page <= (max >> kPageBits); ++page) {
+                auto page_min = page << kPageBits;
+                auto page_max = page_min + (size_t{1} << kPageBits) - 1;
+                if (min <= page_min && page_max <= max) {
+                    page_table[page] = &area;
+                }
+            }
+        }
+    }
 
     std::optional<Area> LookupAddress(Address_t addr) const {
+        if constexpr (kUsePageTable) {
+            if (auto *area = page_table[addr >> kPageBits]; area != nullptr) {
+                return *area;
+            }
+        }
+
         auto area_it = std::find_if(areas.begin(), areas.end(), [addr](const auto &item) {
             auto [min, max] = item.first;
             return min <= addr && addr <= max;
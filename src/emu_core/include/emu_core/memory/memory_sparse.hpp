@@ -10,6 +10,7 @@
 #include <iostream>
 #include <optional>
 #include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -62,8 +63,9 @@ struct MemorySparse : public MemoryInterface<_Address_t> {
     }
 
     void WriteRange(Address_t addr, const VectorType &data) {
-        for (Address_t pos = 0; pos < data.size(); ++pos) {
-            memory_map[addr + pos] = data[pos];
+        memory_map.reserve(memory_map.size() + data.size());
+        for (size_t pos = 0; pos < data.size(); ++pos) {
+            memory_map[static_cast<Address_t>(addr + pos)] = data[pos];
         }
     }
 
@@ -75,10 +77,15 @@ struct MemorySparse : public MemoryInterface<_Address_t> {
         return r;
     }
 
+    // Accepts address -> byte pairs or address -> run of bytes pairs
     template <typename SparseIterable>
     void WriteSparse(const SparseIterable &data) {
-        for (auto [addr, v] : data) {
-            memory_map[addr] = v;
+        for (auto &[addr, v] : data) {
+            if constexpr (std::is_integral_v<std::remove_cvref_t<decltype(v)>>) {
+                memory_map[addr] = v;
+            } else {
+                WriteRange(addr, v);
+            }
         }
     }
 
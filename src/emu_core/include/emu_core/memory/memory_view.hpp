@@ -0,0 +1,76 @@
+#pragma once
+
+#include "emu_core/clock.hpp"
+#include "emu_core/memory.hpp"
+#include <concepts>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace emu::memory {
+
+// Read-only memory over external storage (e.g. mapped package file), no copy is made
+template <std::unsigned_integral _Address_t>
+struct MemoryView : public MemoryInterface<_Address_t> {
+    using Address_t = _Address_t;
+    using Iface = MemoryInterface<_Address_t>;
+
+    Clock *const clock;
+    std::ostream *const verbose_stream;
+    const std::span<const uint8_t> block;
+    const std::shared_ptr<const void> owner;
+    std::string name;
+
+    MemoryView(Clock *clock, std::span<const uint8_t> memory,
+               std::shared_ptr<const void> owner, std::ostream *verbose_stream = nullptr,
+               std::string name = "")
+        : clock(clock), verbose_stream(verbose_stream), block(memory),
+          owner(std::move(owner)), name(std::move(name)) {}
+
+    uint8_t Load(Address_t address) const override {
+        if (address >= block.size()) {
+            throw MemoryOutOfBoundAccessException(address, block.size(), "MemoryView");
+        }
+        WaitForNextCycle();
+        auto v = block[address];
+        AccessLog(address, v, false);
+        return v;
+    }
+
+    void Store(Address_t address, uint8_t value) override {
+        WaitForNextCycle();
+        AccessLog(address, value, true);
+        if (address >= block.size()) {
+            throw MemoryOutOfBoundAccessException(address, block.size(), "MemoryView");
+        }
+    }
+
+    [[nodiscard]] MemoryMode Mode() const override { return MemoryMode::kReadOnly; }
+
+    [[nodiscard]] std::optional<uint8_t> DebugRead(Address_t address) const override {
+        if (address >= block.size()) {
+            return std::nullopt;
+        }
+        return block[address];
+    }
+
+private:
+    void AccessLog(Address_t address, uint8_t value, bool write) const {
+        if (verbose_stream != nullptr) {
+            Iface::WriteAccessLog(*verbose_stream, "VIEW", name, write, address, value,
+                                  "");
+        }
+    }
+
+    void WaitForNextCycle() const {
+        if (clock != nullptr) {
+            clock->WaitForNextCycle();
+        }
+    }
+};
+
+using MemoryView16 = MemoryView<uint16_t>;
+
+} // namespace emu::memory
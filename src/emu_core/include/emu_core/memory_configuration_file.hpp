@@ -5,6 +5,7 @@
 #include <fmt/format.h>
 #include <map>
 #include <optional>
+#include <span>
 #include <string>
 #include <variant>
 #include <vector>
@@ -86,4 +87,17 @@ MemoryConfig LoadMemoryConfigurationFromString(const std::string &text,
 
 std::string StoreMemoryConfigurationToString(const MemoryConfig &config);
 
+// Compact binary form of MemoryConfig, overrides are already applied
+std::vector<uint8_t> StoreMemoryConfigurationToBinary(const MemoryConfig &config);
+MemoryConfig LoadMemoryConfigurationFromBinary(std::span<const uint8_t> data);
+
+constexpr auto kMemoryConfigCacheExtension = ".cache";
+
+// Same as LoadMemoryConfigurationFromFile, but parsed config is stored in binary form
+// next to the source file and reused while source file and overrides are unchanged.
+// Configs using includes are not cached.
+MemoryConfig LoadMemoryConfigurationCached(const std::string &file_name,
+                                           FileSearch *searcher = nullptr,
+                                           const ConfigOverrides &overrides = {});
+
 } // namespace emu
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "emu_core/memory_configuration_file.hpp"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace emu {
+
+// Layout of address space derived from MemoryConfig. Contiguous ram areas of the same
+// mode are merged into single area backed by one memory block.
+struct MemoryMapPlan {
+    static constexpr uint64_t kPageSize = 256;
+
+    struct Part {
+        const MemoryConfigEntry *entry;
+        uint64_t offset; // relative to area start
+    };
+
+    struct Area {
+        uint64_t offset;
+        // Not known for devices and ram areas without explicit size
+        std::optional<uint64_t> size;
+        std::vector<Part> parts;
+
+        [[nodiscard]] bool IsMerged() const { return parts.size() > 1; }
+    };
+
+    std::vector<Area> areas;
+
+    // One line per area, page granular
+    void Describe(std::ostream &out) const;
+};
+
+// Entries of config must outlive the plan.
+// Throws on entries overlapping each other or exceeding address space.
+MemoryMapPlan PlanMemoryMap(const MemoryConfig &config,
+                            uint64_t address_space_size = 0x10000);
+
+} // namespace emu
@@ -4,7 +4,9 @@
 #include <cstdint>
 #include <fmt/format.h>
 #include <map>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <variant>
 #include <vector>
@@ -13,6 +15,12 @@ namespace emu::package {
 
 using ByteVector = std::vector<uint8_t>;
 
+// Read-only view of file stored in package; owner keeps the storage alive
+struct MappedFile {
+    std::span<const uint8_t> data;
+    std::shared_ptr<const void> owner;
+};
+
 class IPackage {
 public:
     virtual ~IPackage() = default;
@@ -22,6 +30,16 @@ public:
     virtual ByteVector LoadFile(const std::string &file_name,
                                 std::optional<size_t> offset = std::nullopt,
                                 std::optional<size_t> length = std::nullopt) const = 0;
+
+    // Size of the file in bytes, without reading its content
+    virtual size_t FileSize(const std::string &file_name) const = 0;
+
+    // Only packages with uncompressed storage can provide direct view of the data
+    virtual std::optional<MappedFile>
+    MapFile(const std::string &file_name, std::optional<size_t> offset = std::nullopt,
+            std::optional<size_t> length = std::nullopt) const {
+        return std::nullopt;
+    }
 };
 
 } // namespace emu::package
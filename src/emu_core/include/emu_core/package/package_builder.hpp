@@ -19,6 +19,8 @@ public:
 
     virtual void SetMemoryConfig(const MemoryConfig &config) const = 0;
     virtual void AddFile(const ByteVector &data, const std::string &file_name) const = 0;
+    // Writes the package, throws on failure. Files cannot be added afterwards.
+    virtual void Finish() const = 0;
 };
 
 } // namespace emu::package
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "package_builder.hpp"
+#include "package_mapped.hpp"
+
+namespace emu::package {
+
+// File is written by Finish, destroying unfinished builder discards added files
+class MappedPackageBuilder : public IPackageBuilder {
+public:
+    ~MappedPackageBuilder() override;
+    MappedPackageBuilder(const std::string &output_path);
+
+    void SetMemoryConfig(const MemoryConfig &config) const override;
+    void AddFile(const ByteVector &data, const std::string &file_name) const override;
+    void Finish() const override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace emu::package
@@ -14,6 +14,7 @@ public:
 
     void SetMemoryConfig(const MemoryConfig &config) const override;
     void AddFile(const ByteVector &data, const std::string &file_name) const override;
+    void Finish() const override;
 
 private:
     struct Impl;
@@ -23,6 +23,7 @@ public:
     ByteVector LoadFile(const std::string &file_name,
                         std::optional<size_t> offset = std::nullopt,
                         std::optional<size_t> length = std::nullopt) const override;
+    size_t FileSize(const std::string &file_name) const override;
 
 private:
     const MemoryConfig config;
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "emu_core/memory_configuration_file.hpp"
+#include "package.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace emu::package {
+
+constexpr auto kEmuMappedImageExtension = ".emu_mapped";
+
+// Uncompressed container, loaded with mmap. Layout, fields stored little endian
+// whatever the host byte order:
+//   MappedImageHeader, MappedImageIndexEntry[entry_count], page aligned file blobs.
+// Memory config is stored as regular files named kMemoryMetafileName and
+// kMemoryBinaryMetafileName.
+struct MappedImageHeader {
+    static constexpr char kMagic[8] = {'E', 'M', 'U', 'M', 'A', 'P', 'P', 'D'};
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint64_t kBlobAlignment = 4096;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_count;
+};
+
+struct MappedImageIndexEntry {
+    static constexpr size_t kMaxNameLength = 111;
+
+    uint64_t offset;
+    uint64_t size;
+    char name[kMaxNameLength + 1];
+};
+
+static_assert(sizeof(MappedImageHeader) == 16);
+static_assert(sizeof(MappedImageIndexEntry) == 128);
+
+class MappedPackage : public IPackage {
+public:
+    ~MappedPackage() override;
+    MappedPackage(const std::string &container_path);
+
+    MemoryConfig LoadMemoryConfig() const override;
+    ByteVector LoadFile(const std::string &file_name,
+                        std::optional<size_t> offset = std::nullopt,
+                        std::optional<size_t> length = std::nullopt) const override;
+    size_t FileSize(const std::string &file_name) const override;
+    std::optional<MappedFile>
+    MapFile(const std::string &file_name, std::optional<size_t> offset = std::nullopt,
+            std::optional<size_t> length = std::nullopt) const override;
+
+private:
+    struct Impl;
+    std::shared_ptr<Impl> impl;
+};
+
+} // namespace emu::package
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "emu_core/memory_configuration_file.hpp"
+#include "package.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace emu::package {
+
+// Package assembled in process, files are served directly from memory
+class MemoryPackage : public IPackage {
+public:
+    ~MemoryPackage() override = default;
+    MemoryPackage(MemoryConfig config);
+
+    void AddFile(const std::string &file_name, ByteVector data);
+
+    MemoryConfig LoadMemoryConfig() const override;
+    ByteVector LoadFile(const std::string &file_name,
+                        std::optional<size_t> offset = std::nullopt,
+                        std::optional<size_t> length = std::nullopt) const override;
+    size_t FileSize(const std::string &file_name) const override;
+    std::optional<MappedFile>
+    MapFile(const std::string &file_name, std::optional<size_t> offset = std::nullopt,
+            std::optional<size_t> length = std::nullopt) const override;
+
+private:
+    const MemoryConfig config;
+    std::map<std::string, std::shared_ptr<const ByteVector>> files;
+
+    std::span<const uint8_t> GetFile(const std::string &file_name,
+                                     std::optional<size_t> offset,
+                                     std::optional<size_t> length) const;
+};
+
+} // namespace emu::package
@@ -13,6 +13,8 @@
 namespace emu::package {
 
 constexpr auto kMemoryMetafileName = ".memory.yaml";
+// Binary copy of memory config, preferred over yaml one when present
+constexpr auto kMemoryBinaryMetafileName = ".memory.bin";
 constexpr auto kEmuImageExtension = ".emu_image";
 
 class ZipPackage : public IPackage {
@@ -24,6 +26,7 @@ public:
     ByteVector LoadFile(const std::string &file_name,
                         std::optional<size_t> offset = std::nullopt,
                         std::optional<size_t> length = std::nullopt) const override;
+    size_t FileSize(const std::string &file_name) const override;
 
 private:
     struct Impl;
@@ -1,11 +1,14 @@
 #pragma once
 
+#include "emu_core/interned_table.hpp"
 #include <fmt/format.h>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <memory>
 #include <optional>
 #include <set>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <variant>
@@ -70,9 +73,10 @@ struct SymbolInfo {
 };
 
 std::string to_string(const SymbolInfo &symbol);
-std::string to_string(std::weak_ptr<SymbolInfo> symbol);
 
-using SymbolMap = std::unordered_map<std::string, std::shared_ptr<SymbolInfo>>;
+using SymbolTable = InternedTable<SymbolInfo>;
+using SymbolId = SymbolTable::Id;
+using SymbolMap = InternedTableMapView<SymbolInfo>;
 
 //-----------------------------------------------------------------------------
 
@@ -84,24 +88,20 @@ enum class RelocationMode {
 std::string to_string(RelocationMode rel_mode);
 uint8_t RelocationSize(RelocationMode rm);
 
+// Target symbol is an id in symbol table of the program holding the relocation
 struct RelocationInfo {
-    std::weak_ptr<SymbolInfo> target_symbol;
+    SymbolId target_symbol;
     Address_t position;
     RelocationMode mode;
 
-    bool operator==(const RelocationInfo &other) const;
+    bool operator==(const RelocationInfo &other) const = default;
     bool operator<(const RelocationInfo &other) const;
 };
 
-std::string to_string(const RelocationInfo &relocation);
-std::string to_string(std::weak_ptr<RelocationInfo> relocation);
+std::string to_string(const RelocationInfo &relocation, const SymbolTable &symbols);
 
-struct RelocationInfoComp {
-    bool operator()(const std::shared_ptr<RelocationInfo> &lhs,
-                    const std::shared_ptr<RelocationInfo> &rhs) const {
-        return (*lhs) < (*rhs);
-    }
-};
+// Relocations in order of emission, at most one per position
+using RelocationList = std::vector<RelocationInfo>;
 
 //-----------------------------------------------------------------------------
 
@@ -111,64 +111,106 @@ struct ValueAlias {
 };
 
 std::string to_string(const ValueAlias &value_alias);
-std::string to_string(std::shared_ptr<ValueAlias> value_alias);
 
-using AliasMap = std::unordered_map<std::string, std::shared_ptr<ValueAlias>>;
+using AliasTable = InternedTable<ValueAlias>;
+using AliasMap = InternedTableMapView<ValueAlias>;
 
 //-----------------------------------------------------------------------------
 
+// Code stored as sorted runs of adjacent bytes. Runs never overlap nor touch each
+// other, so equal code always has equal representation.
 struct SparseBinaryCode {
-    using MapType = std::unordered_map<Address_t, uint8_t>;
+    using RangeMap = std::map<Address_t, ByteVector>;
     using VectorType = std::vector<uint8_t>;
-    MapType sparse_map;
 
-    SparseBinaryCode(std::initializer_list<MapType::value_type> init)
-        : sparse_map(init) {}
+    SparseBinaryCode(std::initializer_list<std::pair<Address_t, uint8_t>> init);
     SparseBinaryCode() = default;
     SparseBinaryCode(Address_t base_address, const VectorType &bytes) {
         PutBytes(base_address, bytes);
     }
     SparseBinaryCode(const VectorType &bytes) : SparseBinaryCode(0, bytes) {}
 
+    // Runs of bytes keyed by address of first byte
+    const RangeMap &Ranges() const { return ranges; }
+    [[nodiscard]] bool Empty() const { return ranges.empty(); }
+    [[nodiscard]] size_t ByteCount() const;
+
+    [[nodiscard]] bool Contains(Address_t address) const {
+        return Get(address).has_value();
+    }
+    [[nodiscard]] std::optional<uint8_t> Get(Address_t address) const;
+    // Throws std::out_of_range if any byte is missing
+    [[nodiscard]] uint8_t At(Address_t address) const;
+    [[nodiscard]] ByteVector ReadBytes(Address_t address, size_t count) const;
+    // First occupied address in range
+    [[nodiscard]] std::optional<Address_t> FindOccupied(Address_t address,
+                                                        size_t count) const;
+
     std::pair<Address_t, Address_t> CodeRange() const;
     void PutByte(Address_t address, uint8_t byte, bool overwrite = false);
     void PutBytes(Address_t address, const std::vector<uint8_t> &bytes,
+                  bool overwrite = false) {
+        PutBytes(address, std::span<const uint8_t>{bytes}, overwrite);
+    }
+    void PutBytes(Address_t address, std::span<const uint8_t> bytes,
                   bool overwrite = false);
+    // Missing bytes are ignored
+    void Erase(Address_t address, size_t count);
 
     std::string HexDump(std::string_view line_prefix = "") const;
     ByteVector DumpMemory() const;
 
     bool operator==(const SparseBinaryCode &other) const;
+
+private:
+    RangeMap ranges;
+
+    RangeMap::const_iterator FindRun(Address_t address) const;
 };
 
 //-----------------------------------------------------------------------------
 
 struct Program {
     SparseBinaryCode sparse_binary_code;
-    SymbolMap symbols;
-    AliasMap aliases;
-    std::set<std::shared_ptr<RelocationInfo>, RelocationInfoComp> relocations;
+    SymbolTable symbols;
+    AliasTable aliases;
+    RelocationList relocations;
 
+    // Symbols and relocation targets are compared by name, ids may differ
     bool operator==(const Program &other) const;
 
-    void AddSymbol(std::shared_ptr<SymbolInfo> symbol);
-    std::shared_ptr<SymbolInfo> AddSymbol(SymbolInfo symbol) {
-        std::shared_ptr<SymbolInfo> r = std::make_shared<SymbolInfo>(symbol);
-        AddSymbol(r);
-        return r;
+    SymbolId AddSymbol(SymbolInfo symbol);
+    SymbolInfo *FindSymbol(std::string_view name) { return symbols.Find(name); }
+    const SymbolInfo *FindSymbol(std::string_view name) const {
+        return symbols.Find(name);
+    }
+    std::optional<SymbolId> FindSymbolId(std::string_view name) const {
+        return symbols.FindId(name);
+    }
+
+    void AddAlias(ValueAlias alias);
+    const ValueAlias *FindAlias(std::string_view name) const {
+        return aliases.Find(name);
     }
-    std::shared_ptr<SymbolInfo> FindSymbol(const std::string &name) const;
 
-    void AddAlias(std::shared_ptr<ValueAlias> alias);
-    std::shared_ptr<ValueAlias> AddAlias(ValueAlias alias) {
-        std::shared_ptr<ValueAlias> r = std::make_shared<ValueAlias>(alias);
-        AddAlias(r);
-        return r;
+    SymbolInfo &Target(const RelocationInfo &relocation) {
+        return symbols[relocation.target_symbol];
     }
-    std::shared_ptr<ValueAlias> FindAlias(const std::string &name) const;
+    const SymbolInfo &Target(const RelocationInfo &relocation) const {
+        return symbols[relocation.target_symbol];
+    }
+    // Relocations ordered by position
+    RelocationList SortedRelocations() const;
+
+    SymbolMap SymbolsByName() const { return SymbolMap{symbols}; }
+    AliasMap AliasesByName() const { return AliasMap{aliases}; }
 };
 
 std::string to_string(const Program &program);
 std::ostream &operator<<(std::ostream &o, const Program &program);
 
+// Compact binary form of program with pending relocations (e.g. assembler objects)
+ByteVector StoreProgramToBinary(const Program &program);
+Program LoadProgramFromBinary(std::span<const uint8_t> data);
+
 } // namespace emu
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cctype>
 #include <functional>
 #include <optional>
 #include <string>
@@ -26,4 +27,11 @@ inline std::string ToUpper(const std::string &s) {
     return r;
 }
 
+inline bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+        return ::tolower(static_cast<unsigned char>(x)) ==
+               ::tolower(static_cast<unsigned char>(y));
+    });
+}
+
 } // namespace emu
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <fmt/format.h>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace emu {
+
+// Little endian varint/fixed/string encoding shared by binary file formats
+struct BinaryWriter {
+    std::vector<uint8_t> data;
+
+    void WriteByte(uint8_t v) { data.push_back(v); }
+
+    void WriteVarint(uint64_t v) {
+        while (v >= 0x80) {
+            data.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        data.push_back(static_cast<uint8_t>(v));
+    }
+
+    void WriteZigzag(int64_t v) {
+        WriteVarint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+    }
+
+    template <typename T>
+    void WriteFixed(T v) {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            data.push_back(static_cast<uint8_t>(static_cast<uint64_t>(v) >> (8 * i)));
+        }
+    }
+
+    void WriteBytes(std::span<const uint8_t> bytes) {
+        data.insert(data.end(), bytes.begin(), bytes.end());
+    }
+
+    void WriteString(const std::string &s) {
+        WriteVarint(s.size());
+        data.insert(data.end(), s.begin(), s.end());
+    }
+};
+
+struct BinaryReader {
+    std::span<const uint8_t> data;
+    // Used as error message prefix, e.g. "binary memory config"
+    const char *format_name;
+    size_t position = 0;
+
+    [[noreturn]] void Error(const std::string &what) const {
+        throw std::runtime_error(
+            fmt::format("Malformed {} at {}: {}", format_name, position, what));
+    }
+
+    [[nodiscard]] bool AtEnd() const { return position == data.size(); }
+
+    uint8_t ReadByte() {
+        if (position >= data.size()) {
+            Error("unexpected end of data");
+        }
+        return data[position++];
+    }
+
+    uint64_t ReadVarint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            auto byte = ReadByte();
+            v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return v;
+            }
+        }
+        Error("varint is too long");
+    }
+
+    int64_t ReadZigzag() {
+        auto v = ReadVarint();
+        return static_cast<int64_t>((v >> 1) ^ (~(v & 1) + 1));
+    }
+
+    template <typename T>
+    T ReadFixed() {
+        uint64_t v = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            v |= static_cast<uint64_t>(ReadByte()) << (8 * i);
+        }
+        return static_cast<T>(v);
+    }
+
+    std::span<const uint8_t> ReadBytes(uint64_t size) {
+        if (size > data.size() - position) {
+            Error("data block exceeds data");
+        }
+        auto r = data.subspan(position, size);
+        position += size;
+        return r;
+    }
+
+    std::string ReadString() {
+        auto size = ReadVarint();
+        if (size > data.size() - position) {
+            Error("string exceeds data");
+        }
+        std::string r{reinterpret_cast<const char *>(data.data() + position), size};
+        position += size;
+        return r;
+    }
+};
+
+} // namespace emu
@@ -0,0 +1,184 @@
+#include "emu_core/memory_configuration_file.hpp"
+#include "binary_codec.hpp"
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <type_traits>
+
+namespace emu {
+
+namespace {
+
+constexpr std::array<uint8_t, 4> kBinaryMagic = {'E', 'M', 'C', 'F'};
+constexpr uint8_t kBinaryVersion = 1;
+
+enum RamAreaFlags : uint8_t {
+    kWritable = 0x01,
+    kHasSize = 0x02,
+    kHasImage = 0x04,
+    kHasImageOffset = 0x08,
+};
+
+enum class EntryKind : uint8_t {
+    kRamArea = 0,
+    kMappedDevice = 1,
+};
+
+struct ConfigWriter : BinaryWriter {
+    void Write(const std::monostate &) {}
+    void Write(const std::string &s) { WriteString(s); }
+    void Write(int64_t v) { WriteZigzag(v); }
+    void Write(bool b) { WriteByte(b ? 1 : 0); }
+    void Write(double d) {
+        auto v = std::bit_cast<uint64_t>(d);
+        for (int i = 0; i < 8; ++i) {
+            WriteByte(static_cast<uint8_t>(v >> (i * 8)));
+        }
+    }
+
+    void Write(const MemoryConfigEntry::RamArea &ra) {
+        uint8_t flags = 0;
+        flags |= ra.writable ? kWritable : 0;
+        flags |= ra.size.has_value() ? kHasSize : 0;
+        flags |= ra.image.has_value() ? kHasImage : 0;
+        flags |= ra.image.has_value() && ra.image->offset.has_value() ? kHasImageOffset : 0;
+        WriteByte(flags);
+        if (ra.size.has_value()) {
+            WriteVarint(*ra.size);
+        }
+        if (ra.image.has_value()) {
+            WriteString(ra.image->file);
+            if (ra.image->offset.has_value()) {
+                WriteVarint(*ra.image->offset);
+            }
+        }
+    }
+
+    void Write(const MemoryConfigEntry::MappedDevice &md) {
+        WriteString(md.module_name);
+        WriteString(md.class_name);
+        WriteVarint(md.config.size());
+        for (auto &[key, value] : md.config) {
+            WriteString(key);
+            WriteByte(static_cast<uint8_t>(value.index()));
+            std::visit([this](auto &item) { Write(item); }, value);
+        }
+    }
+};
+
+struct ConfigReader : BinaryReader {
+    MemoryConfigEntry::ValueVariant ReadValue() {
+        switch (ReadByte()) {
+        case 0:
+            return std::monostate{};
+        case 1:
+            return ReadString();
+        case 2:
+            return ReadZigzag();
+        case 3:
+            return ReadByte() != 0;
+        case 4: {
+            uint64_t v = 0;
+            for (int i = 0; i < 8; ++i) {
+                v |= static_cast<uint64_t>(ReadByte()) << (i * 8);
+            }
+            return std::bit_cast<double>(v);
+        }
+        default:
+            Error("unknown value type");
+        }
+    }
+
+    MemoryConfigEntry::RamArea ReadRamArea() {
+        MemoryConfigEntry::RamArea ra;
+        auto flags = ReadByte();
+        ra.writable = (flags & kWritable) != 0;
+        if ((flags & kHasSize) != 0) {
+            ra.size = ReadVarint();
+        }
+        if ((flags & kHasImage) != 0) {
+            ra.image = MemoryConfigEntry::RamArea::Image{.file = ReadString()};
+            if ((flags & kHasImageOffset) != 0) {
+                ra.image->offset = ReadVarint();
+            }
+        }
+        return ra;
+    }
+
+    MemoryConfigEntry::MappedDevice ReadMappedDevice() {
+        MemoryConfigEntry::MappedDevice md;
+        md.module_name = ReadString();
+        md.class_name = ReadString();
+        for (auto count = ReadVarint(); count > 0; --count) {
+            auto key = ReadString();
+            md.config[key] = ReadValue();
+        }
+        return md;
+    }
+};
+
+static_assert(std::is_same_v<std::variant_alternative_t<1, MemoryConfigEntry::ValueVariant>,
+                             std::string>);
+static_assert(std::is_same_v<std::variant_alternative_t<4, MemoryConfigEntry::ValueVariant>,
+                             double>);
+
+} // namespace
+
+std::vector<uint8_t> StoreMemoryConfigurationToBinary(const MemoryConfig &config) {
+    ConfigWriter w;
+    w.data.assign(kBinaryMagic.begin(), kBinaryMagic.end());
+    w.WriteByte(kBinaryVersion);
+    w.WriteVarint(config.entries.size());
+    for (auto &entry : config.entries) {
+        w.WriteString(entry.name);
+        w.WriteVarint(entry.offset);
+        if (auto *ra = std::get_if<MemoryConfigEntry::RamArea>(&entry.entry_variant)) {
+            w.WriteByte(static_cast<uint8_t>(EntryKind::kRamArea));
+            w.Write(*ra);
+        } else {
+            w.WriteByte(static_cast<uint8_t>(EntryKind::kMappedDevice));
+            w.Write(std::get<MemoryConfigEntry::MappedDevice>(entry.entry_variant));
+        }
+    }
+    return std::move(w.data);
+}
+
+MemoryConfig LoadMemoryConfigurationFromBinary(std::span<const uint8_t> data) {
+    ConfigReader r{{.data = data, .format_name = "binary memory config"}};
+    if (data.size() < kBinaryMagic.size() ||
+        std::memcmp(data.data(), kBinaryMagic.data(), kBinaryMagic.size()) != 0) {
+        r.Error("invalid magic");
+    }
+    r.position = kBinaryMagic.size();
+    if (auto version = r.ReadByte(); version != kBinaryVersion) {
+        r.Error(fmt::format("unsupported version {}", version));
+    }
+
+    MemoryConfig config;
+    auto count = r.ReadVarint();
+    config.entries.reserve(std::min<uint64_t>(count, data.size()));
+    for (; count > 0; --count) {
+        MemoryConfigEntry entry;
+        entry.name = r.ReadString();
+        entry.offset = r.ReadVarint();
+        switch (static_cast<EntryKind>(r.ReadByte())) {
+        case EntryKind::kRamArea:
+            entry.entry_variant = r.ReadRamArea();
+            break;
+        case EntryKind::kMappedDevice:
+            entry.entry_variant = r.ReadMappedDevice();
+            break;
+        default:
+            r.Error("unknown entry kind");
+        }
+        config.entries.emplace_back(std::move(entry));
+    }
+    if (r.position != data.size()) {
+        r.Error("trailing data");
+    }
+    return config;
+}
+
+} // namespace emu
@@ -1,6 +1,10 @@
 #include "emu_core/memory_configuration_file.hpp"
+#include "emu_core/byte_utils.hpp"
+#include <filesystem>
 #include <fmt/format.h>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <unordered_map>
 #include <yaml-cpp/yaml.h>
@@ -296,6 +300,80 @@ LoadMemoryConfigEntryVector(const YAML::Node &node, FileSearch *searcher,
     return rhs;
 }
 
+bool HasIncludes(const YAML::Node &node) {
+    if (!node.IsSequence()) {
+        return false;
+    }
+    for (auto i : node) {
+        if (i["include"]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Identifies source file version and overrides used to produce cached config
+std::vector<uint8_t> MakeCacheStamp(const std::string &file_name,
+                                    const ConfigOverrides &overrides) {
+    std::map<std::string, std::string> sorted{overrides.begin(), overrides.end()};
+    uint64_t overrides_hash = kFnv1aOffsetBasis;
+    for (auto &[key, value] : sorted) {
+        overrides_hash = Fnv1aHash(key + "=" + value + "\n", overrides_hash);
+    }
+
+    uint64_t fields[] = {
+        static_cast<uint64_t>(
+            std::filesystem::last_write_time(file_name).time_since_epoch().count()),
+        static_cast<uint64_t>(std::filesystem::file_size(file_name)),
+        overrides_hash,
+    };
+    std::vector<uint8_t> stamp;
+    for (auto field : fields) {
+        for (int i = 0; i < 8; ++i) {
+            stamp.push_back(static_cast<uint8_t>(field >> (i * 8)));
+        }
+    }
+    return stamp;
+}
+
+std::optional<MemoryConfig> ReadCachedConfig(const std::string &cache_file,
+                                             const std::vector<uint8_t> &stamp) {
+    std::ifstream input(cache_file, std::ios::binary);
+    if (!input) {
+        return std::nullopt;
+    }
+    std::vector<uint8_t> data{std::istreambuf_iterator<char>(input),
+                              std::istreambuf_iterator<char>()};
+    if (data.size() < stamp.size() || !std::equal(stamp.begin(), stamp.end(), data.begin())) {
+        return std::nullopt;
+    }
+    try {
+        return LoadMemoryConfigurationFromBinary(
+            std::span<const uint8_t>{data}.subspan(stamp.size()));
+    } catch (const std::runtime_error &) {
+        return std::nullopt;
+    }
+}
+
+// Cache is an optimization only, failure to write it is ignored
+void WriteCachedConfig(const std::string &cache_file, const std::vector<uint8_t> &stamp,
+                       const MemoryConfig &config) {
+    auto binary = StoreMemoryConfigurationToBinary(config);
+    auto temp_file = cache_file + ".tmp";
+    {
+        std::ofstream output(temp_file, std::ios::binary | std::ios::trunc);
+        output.write(reinterpret_cast<const char *>(stamp.data()),
+                     static_cast<std::streamsize>(stamp.size()));
+        output.write(reinterpret_cast<const char *>(binary.data()),
+                     static_cast<std::streamsize>(binary.size()));
+        if (!output) {
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_file, cache_file, ec);
+}
+
 MemoryConfig Load(YAML::Node config, FileSearch *searcher,
                   const ConfigOverrides &overrides) {
     return MemoryConfig{
@@ -309,12 +387,32 @@ MemoryConfig LoadMemoryConfigurationFromFile(const std::string &file_name,
                                              FileSearch *searcher,
                                              const ConfigOverrides &overrides) {
     auto yaml = YAML::LoadFile(file_name);
-    auto s = searcher->PrependPath(file_name);
+    auto s = FileSearch::PrependPath(file_name, searcher);
     return MemoryConfig{
         .entries = LoadMemoryConfigEntryVector(yaml["memory"], s.get(), overrides),
     };
 }
 
+MemoryConfig LoadMemoryConfigurationCached(const std::string &file_name,
+                                           FileSearch *searcher,
+                                           const ConfigOverrides &overrides) {
+    auto cache_file = file_name + kMemoryConfigCacheExtension;
+    auto stamp = MakeCacheStamp(file_name, overrides);
+    if (auto cached = ReadCachedConfig(cache_file, stamp); cached.has_value()) {
+        return std::move(*cached);
+    }
+
+    auto yaml = YAML::LoadFile(file_name);
+    auto s = FileSearch::PrependPath(file_name, searcher);
+    auto config = MemoryConfig{
+        .entries = LoadMemoryConfigEntryVector(yaml["memory"], s.get(), overrides),
+    };
+    if (!HasIncludes(yaml["memory"])) {
+        WriteCachedConfig(cache_file, stamp, config);
+    }
+    return config;
+}
+
 MemoryConfig LoadMemoryConfigurationFromString(const std::string &text,
                                                FileSearch *searcher,
                                                const ConfigOverrides &overrides) {
@@ -0,0 +1,118 @@
+#include "emu_core/memory_map_planner.hpp"
+#include <algorithm>
+#include <fmt/format.h>
+#include <optional>
+#include <stdexcept>
+
+namespace emu {
+
+namespace {
+
+std::optional<uint64_t> EntrySize(const MemoryConfigEntry &entry) {
+    if (auto *ra = std::get_if<MemoryConfigEntry::RamArea>(&entry.entry_variant)) {
+        return ra->size;
+    }
+    return std::nullopt;
+}
+
+std::string EntryName(const MemoryConfigEntry &entry) {
+    if (!entry.name.empty()) {
+        return entry.name;
+    }
+    return fmt::format("@{:04x}", entry.offset);
+}
+
+bool CanMerge(const MemoryMapPlan::Area &area, const MemoryConfigEntry &entry) {
+    auto *ra = std::get_if<MemoryConfigEntry::RamArea>(&entry.entry_variant);
+    auto *area_ra =
+        std::get_if<MemoryConfigEntry::RamArea>(&area.parts.front().entry->entry_variant);
+    if (ra == nullptr || area_ra == nullptr) {
+        return false;
+    }
+    if (!ra->size.has_value() || !area.size.has_value()) {
+        return false;
+    }
+    return ra->writable == area_ra->writable && area.offset + *area.size == entry.offset;
+}
+
+} // namespace
+
+MemoryMapPlan PlanMemoryMap(const MemoryConfig &config, uint64_t address_space_size) {
+    std::vector<const MemoryConfigEntry *> sorted;
+    for (auto &entry : config.entries) {
+        sorted.emplace_back(&entry);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](auto *a, auto *b) { return a->offset < b->offset; });
+
+    MemoryMapPlan plan;
+    const MemoryConfigEntry *previous = nullptr;
+    std::optional<uint64_t> previous_size;
+
+    for (auto *entry : sorted) {
+        auto size = EntrySize(*entry);
+        if (entry->offset >= address_space_size ||
+            (size.has_value() && *size > address_space_size - entry->offset)) {
+            throw std::runtime_error(
+                fmt::format("Memory entry {} exceeds address space of size {:#x}",
+                            EntryName(*entry), address_space_size));
+        }
+
+        if (previous != nullptr) {
+            auto overlaps = previous_size.has_value()
+                                ? entry->offset < previous->offset + *previous_size
+                                : entry->offset == previous->offset;
+            if (overlaps) {
+                throw std::runtime_error(
+                    fmt::format("Memory entry {} at {:04x} overlaps {} at {:04x}",
+                                EntryName(*entry), entry->offset, EntryName(*previous),
+                                previous->offset));
+            }
+        }
+        previous = entry;
+        previous_size = size;
+
+        if (!plan.areas.empty() && CanMerge(plan.areas.back(), *entry)) {
+            auto &area = plan.areas.back();
+            area.parts.emplace_back(MemoryMapPlan::Part{
+                .entry = entry,
+                .offset = entry->offset - area.offset,
+            });
+            *area.size += *size;
+            continue;
+        }
+
+        plan.areas.emplace_back(MemoryMapPlan::Area{
+            .offset = entry->offset,
+            .size = size,
+            .parts = {MemoryMapPlan::Part{.entry = entry, .offset = 0}},
+        });
+    }
+
+    return plan;
+}
+
+void MemoryMapPlan::Describe(std::ostream &out) const {
+    for (auto &area : areas) {
+        auto *ra =
+            std::get_if<MemoryConfigEntry::RamArea>(&area.parts.front().entry->entry_variant);
+        std::string kind = ra == nullptr ? "device" : (ra->writable ? "ram" : "rom");
+
+        std::string names;
+        for (auto &part : area.parts) {
+            names += (names.empty() ? "" : "+") + EntryName(*part.entry);
+        }
+
+        if (area.size.has_value() && *area.size > 0) {
+            auto last = area.offset + *area.size - 1;
+            out << fmt::format("PLAN {:04x}-{:04x} pages {:02x}-{:02x} {:6} {}\n",
+                               area.offset, last, area.offset / kPageSize, last / kPageSize,
+                               kind, names);
+        } else {
+            out << fmt::format("PLAN {:04x}-????  page  {:02x}    {:6} {}\n", area.offset,
+                               area.offset / kPageSize, kind, names);
+        }
+    }
+}
+
+} // namespace emu
@@ -0,0 +1,97 @@
+#include "emu_core/package/package_builder_mapped.hpp"
+#include "binary_codec.hpp"
+#include "emu_core/package/package_zip.hpp"
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+
+namespace emu::package {
+
+struct MappedPackageBuilder::Impl {
+    Impl(const std::string &output_path) : output_path(output_path) {}
+
+    const std::string output_path;
+    std::vector<std::pair<std::string, ByteVector>> files;
+
+    void Add(const std::string &name, ByteVector data) {
+        if (name.size() > MappedImageIndexEntry::kMaxNameLength) {
+            throw std::runtime_error(
+                fmt::format("MappedPackageBuilder: File name '{}' is too long", name));
+        }
+        for (auto &item : files) {
+            if (item.first == name) {
+                item.second = std::move(data);
+                return;
+            }
+        }
+        files.emplace_back(name, std::move(data));
+    }
+
+    static uint64_t Align(uint64_t v) {
+        constexpr auto kAlign = MappedImageHeader::kBlobAlignment;
+        return (v + kAlign - 1) / kAlign * kAlign;
+    }
+
+    void Write() const {
+        BinaryWriter table;
+        table.WriteBytes({reinterpret_cast<const uint8_t *>(MappedImageHeader::kMagic),
+                          sizeof(MappedImageHeader::kMagic)});
+        table.WriteFixed<uint32_t>(MappedImageHeader::kVersion);
+        table.WriteFixed<uint32_t>(static_cast<uint32_t>(files.size()));
+
+        std::vector<uint64_t> offsets;
+        uint64_t offset = Align(sizeof(MappedImageHeader) +
+                                files.size() * sizeof(MappedImageIndexEntry));
+        for (auto &[name, data] : files) {
+            std::array<uint8_t, MappedImageIndexEntry::kMaxNameLength + 1> name_bytes{};
+            std::copy(name.begin(), name.end(), name_bytes.begin());
+            table.WriteFixed<uint64_t>(offset);
+            table.WriteFixed<uint64_t>(data.size());
+            table.WriteBytes(name_bytes);
+            offsets.push_back(offset);
+            offset = Align(offset + data.size());
+        }
+
+        std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error(
+                fmt::format("MappedPackageBuilder: Cannot open '{}'", output_path));
+        }
+        out.write(reinterpret_cast<const char *>(table.data.data()),
+                  static_cast<std::streamsize>(table.data.size()));
+        for (size_t i = 0; i < files.size(); ++i) {
+            out.seekp(static_cast<std::streamoff>(offsets[i]));
+            out.write(reinterpret_cast<const char *>(files[i].second.data()),
+                      static_cast<std::streamsize>(files[i].second.size()));
+        }
+        out.close();
+        if (!out) {
+            throw std::runtime_error(
+                fmt::format("MappedPackageBuilder: Failed to write '{}'", output_path));
+        }
+    }
+};
+
+MappedPackageBuilder::MappedPackageBuilder(const std::string &output_path)
+    : impl(std::make_unique<Impl>(output_path)) {
+}
+
+MappedPackageBuilder::~MappedPackageBuilder() = default;
+
+void MappedPackageBuilder::SetMemoryConfig(const MemoryConfig &config) const {
+    auto str_config = StoreMemoryConfigurationToString(config);
+    impl->Add(kMemoryMetafileName, ByteVector(str_config.begin(), str_config.end()));
+    impl->Add(kMemoryBinaryMetafileName, StoreMemoryConfigurationToBinary(config));
+}
+
+void MappedPackageBuilder::AddFile(const ByteVector &data,
+                                   const std::string &file_name) const {
+    impl->Add(file_name, data);
+}
+
+void MappedPackageBuilder::Finish() const {
+    impl->Write();
+}
+
+} // namespace emu::package
@@ -8,7 +8,8 @@ using namespace libzippp;
 namespace emu::package {
 
 struct ZipPackageBuilder::Impl {
-    Impl(const std::string &output_path) : archive(output_path) {
+    Impl(const std::string &output_path)
+        : output_path(output_path), archive(output_path) {
         if (std::filesystem::exists(output_path)) {
             std::filesystem::remove(output_path);
         }
@@ -18,6 +19,7 @@ struct ZipPackageBuilder::Impl {
         archive.close();
     }
 
+    const std::string output_path;
     ZipArchive archive;
     std::vector<std::unique_ptr<ByteVector>> stored_data;
 };
@@ -33,6 +35,12 @@ void ZipPackageBuilder::SetMemoryConfig(const MemoryConfig &config) const {
     auto byte_config = std::make_unique<ByteVector>(str_config.begin(), str_config.end());
     impl->archive.addData(kMemoryMetafileName, byte_config->data(), byte_config->size());
     impl->stored_data.emplace_back(std::move(byte_config));
+
+    auto binary_config =
+        std::make_unique<ByteVector>(StoreMemoryConfigurationToBinary(config));
+    impl->archive.addData(kMemoryBinaryMetafileName, binary_config->data(),
+                          binary_config->size());
+    impl->stored_data.emplace_back(std::move(binary_config));
 }
 
 void ZipPackageBuilder::AddFile(const ByteVector &data,
@@ -42,4 +50,11 @@ void ZipPackageBuilder::AddFile(const ByteVector &data,
     impl->stored_data.emplace_back(std::move(byte_config));
 }
 
+void ZipPackageBuilder::Finish() const {
+    if (impl->archive.close() != 0) {
+        throw std::runtime_error(
+            fmt::format("ZipPackageBuilder: Failed to write '{}'", impl->output_path));
+    }
+}
+
 } // namespace emu::package
@@ -4,7 +4,7 @@
 namespace emu::package {
 
 FsPackage::FsPackage(std::string config_file, std::shared_ptr<FileSearch> searcher)
-    : FsPackage(LoadMemoryConfigurationFromFile(config_file), std::move(searcher)) {
+    : FsPackage(LoadMemoryConfigurationCached(config_file), std::move(searcher)) {
 }
 
 FsPackage::FsPackage(MemoryConfig config, std::shared_ptr<FileSearch> searcher)
@@ -28,4 +28,10 @@ ByteVector FsPackage::LoadFile(const std::string &file_name, std::optional<size_
     return data;
 }
 
+size_t FsPackage::FileSize(const std::string &file_name) const {
+    auto file = searcher->OpenFile(file_name);
+    file->seekg(0u, std::ios::end);
+    return static_cast<size_t>(file->tellg());
+}
+
 } // namespace emu::package
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "emu_core/package/package_mapped.hpp"
+#include "binary_codec.hpp"
+#include "emu_core/package/package_zip.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace emu::package {
+
+struct MappedPackage::Impl {
+    Impl(const std::string &container_path) : path(container_path) {
+        int fd = ::open(container_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            Error("Failed to open");
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            Error("Failed to stat");
+        }
+        size = static_cast<size_t>(st.st_size);
+        if (size < sizeof(MappedImageHeader)) {
+            ::close(fd);
+            Error("File is too small");
+        }
+        void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            Error("Failed to map");
+        }
+        base = static_cast<const uint8_t *>(p);
+        ReadIndex();
+    }
+
+    ~Impl() {
+        if (base != nullptr) {
+            ::munmap(const_cast<uint8_t *>(base), size);
+        }
+    }
+
+    const std::string path;
+    const uint8_t *base = nullptr;
+    size_t size = 0;
+    std::map<std::string, std::span<const uint8_t>, std::less<>> files;
+
+    [[noreturn]] void Error(const std::string &msg) const {
+        throw std::runtime_error(fmt::format("MappedPackage {}: {}: {}", path, msg,
+                                             errno != 0 ? std::strerror(errno) : ""));
+    }
+
+    void ReadIndex() {
+        errno = 0;
+        BinaryReader reader{{base, size}, "mapped package"};
+        auto magic = reader.ReadBytes(sizeof(MappedImageHeader::kMagic));
+        auto version = reader.ReadFixed<uint32_t>();
+        auto entry_count = reader.ReadFixed<uint32_t>();
+        if (std::memcmp(magic.data(), MappedImageHeader::kMagic, magic.size()) != 0 ||
+            version != MappedImageHeader::kVersion) {
+            Error("Invalid header");
+        }
+        auto index_end = sizeof(MappedImageHeader) +
+                         uint64_t{entry_count} * sizeof(MappedImageIndexEntry);
+        if (index_end > size) {
+            Error("Truncated index");
+        }
+        for (uint32_t i = 0; i < entry_count; ++i) {
+            auto offset = reader.ReadFixed<uint64_t>();
+            auto entry_size = reader.ReadFixed<uint64_t>();
+            auto name_bytes = reader.ReadBytes(MappedImageIndexEntry::kMaxNameLength + 1);
+            std::string name{reinterpret_cast<const char *>(name_bytes.data()),
+                             ::strnlen(reinterpret_cast<const char *>(name_bytes.data()),
+                                       MappedImageIndexEntry::kMaxNameLength)};
+            if (entry_size == 0) {
+                files[name] = {};
+                continue;
+            }
+            if (offset > size || entry_size > size - offset) {
+                Error(fmt::format("Entry '{}' is out of bounds", name));
+            }
+            files[name] = std::span<const uint8_t>{base + offset, entry_size};
+        }
+    }
+
+    std::span<const uint8_t> GetFile(const std::string &file_name,
+                                     std::optional<size_t> offset,
+                                     std::optional<size_t> length) const {
+        auto it = files.find(file_name);
+        if (it == files.end()) {
+            throw std::runtime_error(
+                fmt::format("Failed to find '{}' in package", file_name));
+        }
+        auto data = it->second;
+        auto beg = std::min(offset.value_or(0), data.size());
+        auto to_read = std::min(data.size() - beg, length.value_or(data.size()));
+        return data.subspan(beg, to_read);
+    }
+};
+
+MappedPackage::MappedPackage(const std::string &container_path)
+    : impl(std::make_shared<Impl>(container_path)) {
+}
+
+MappedPackage::~MappedPackage() = default;
+
+MemoryConfig MappedPackage::LoadMemoryConfig() const {
+    if (impl->files.contains(kMemoryBinaryMetafileName)) {
+        return LoadMemoryConfigurationFromBinary(
+            impl->GetFile(kMemoryBinaryMetafileName, std::nullopt, std::nullopt));
+    }
+    auto data = impl->GetFile(kMemoryMetafileName, std::nullopt, std::nullopt);
+    return LoadMemoryConfigurationFromString(
+        std::string{reinterpret_cast<const char *>(data.data()), data.size()});
+}
+
+ByteVector MappedPackage::LoadFile(const std::string &file_name,
+                                   std::optional<size_t> offset,
+                                   std::optional<size_t> length) const {
+    auto data = impl->GetFile(file_name, offset, length);
+    return ByteVector{data.begin(), data.end()};
+}
+
+size_t MappedPackage::FileSize(const std::string &file_name) const {
+    return impl->GetFile(file_name, std::nullopt, std::nullopt).size();
+}
+
+std::optional<MappedFile> MappedPackage::MapFile(const std::string &file_name,
+                                                 std::optional<size_t> offset,
+                                                 std::optional<size_t> length) const {
+    return MappedFile{
+        .data = impl->GetFile(file_name, offset, length),
+        .owner = impl,
+    };
+}
+
+} // namespace emu::package
@@ -0,0 +1,53 @@
+#include "emu_core/package/package_memory.hpp"
+#include <algorithm>
+#include <fmt/format.h>
+#include <stdexcept>
+
+namespace emu::package {
+
+MemoryPackage::MemoryPackage(MemoryConfig config) : config(std::move(config)) {
+}
+
+void MemoryPackage::AddFile(const std::string &file_name, ByteVector data) {
+    files[file_name] = std::make_shared<const ByteVector>(std::move(data));
+}
+
+MemoryConfig MemoryPackage::LoadMemoryConfig() const {
+    return config;
+}
+
+ByteVector MemoryPackage::LoadFile(const std::string &file_name,
+                                   std::optional<size_t> offset,
+                                   std::optional<size_t> length) const {
+    auto data = GetFile(file_name, offset, length);
+    return ByteVector{data.begin(), data.end()};
+}
+
+size_t MemoryPackage::FileSize(const std::string &file_name) const {
+    return GetFile(file_name, std::nullopt, std::nullopt).size();
+}
+
+std::optional<MappedFile> MemoryPackage::MapFile(const std::string &file_name,
+                                                 std::optional<size_t> offset,
+                                                 std::optional<size_t> length) const {
+    return MappedFile{
+        .data = GetFile(file_name, offset, length),
+        .owner = files.at(file_name),
+    };
+}
+
+std::span<const uint8_t> MemoryPackage::GetFile(const std::string &file_name,
+                                                std::optional<size_t> offset,
+                                                std::optional<size_t> length) const {
+    auto it = files.find(file_name);
+    if (it == files.end()) {
+        throw std::runtime_error(
+            fmt::format("Failed to find '{}' in package", file_name));
+    }
+    std::span<const uint8_t> data{*it->second};
+    auto beg = std::min(offset.value_or(0), data.size());
+    auto to_read = std::min(data.size() - beg, length.value_or(data.size()));
+    return data.subspan(beg, to_read);
+}
+
+} // namespace emu::package
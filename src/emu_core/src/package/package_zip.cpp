@@ -1,10 +1,58 @@
 #include "emu_core/package/package_zip.hpp"
+#include <algorithm>
 #include <libzippp.h>
+#include <mutex>
+#include <streambuf>
 
 using namespace libzippp;
 
 namespace emu::package {
 
+namespace {
+
+// Copies [offset, offset + length) of written data into output buffer. Once the range is
+// complete, writes start to fail, which makes libzippp stop decompressing.
+class SliceStreamBuf : public std::streambuf {
+public:
+    SliceStreamBuf(uint8_t *output, size_t offset, size_t length)
+        : output(output), skip(offset), remaining(length) {}
+
+    [[nodiscard]] bool Complete() const { return remaining == 0; }
+    [[nodiscard]] size_t Written() const { return written; }
+
+protected:
+    std::streamsize xsputn(const char *data, std::streamsize count) override {
+        auto size = static_cast<size_t>(count);
+        auto skipped = std::min(skip, size);
+        skip -= skipped;
+        auto to_copy = std::min(size - skipped, remaining);
+        std::copy_n(reinterpret_cast<const uint8_t *>(data) + skipped, to_copy,
+                    output + written);
+        written += to_copy;
+        remaining -= to_copy;
+        if (remaining == 0 && skipped + to_copy < size) {
+            return static_cast<std::streamsize>(skipped + to_copy);
+        }
+        return count;
+    }
+
+    int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) {
+            return traits_type::not_eof(ch);
+        }
+        char c = traits_type::to_char_type(ch);
+        return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+    }
+
+private:
+    uint8_t *const output;
+    size_t skip;
+    size_t remaining;
+    size_t written = 0;
+};
+
+} // namespace
+
 struct ZipPackage::Impl {
     Impl(const std::string &container_path) : archive(container_path) {
         archive.open(ZipArchive::OpenMode::ReadOnly);
@@ -14,7 +62,80 @@ struct ZipPackage::Impl {
     }
 
     ZipArchive archive;
-    std::vector<std::unique_ptr<ByteVector>> stored_data;
+
+    std::mutex mutex;
+    std::optional<MemoryConfig> memory_config;
+    std::map<std::string, size_t> image_references;
+    std::map<std::string, std::shared_ptr<const ByteVector>> entry_cache;
+
+    ZipEntry GetEntry(const std::string &file_name) const {
+        auto entry = archive.getEntry(file_name);
+        if (entry.isNull()) {
+            throw std::runtime_error(
+                fmt::format("Failed to find '{}' in package", file_name));
+        }
+        return entry;
+    }
+
+    const MemoryConfig &GetMemoryConfig() {
+        if (!memory_config.has_value()) {
+            if (auto entry = archive.getEntry(kMemoryBinaryMetafileName); !entry.isNull()) {
+                auto data = entry.readAsText();
+                memory_config = LoadMemoryConfigurationFromBinary(std::span<const uint8_t>{
+                    reinterpret_cast<const uint8_t *>(data.data()), data.size()});
+            } else if (entry = archive.getEntry(kMemoryMetafileName); !entry.isNull()) {
+                memory_config = LoadMemoryConfigurationFromString(entry.readAsText());
+            } else {
+                throw std::runtime_error("Failed to find memory config in package");
+            }
+            for (auto &item : memory_config->entries) {
+                if (auto *ra = std::get_if<MemoryConfigEntry::RamArea>(&item.entry_variant);
+                    ra != nullptr && ra->image.has_value()) {
+                    ++image_references[ra->image->file];
+                }
+            }
+        }
+        return *memory_config;
+    }
+
+    // Entries used by more than one memory area are decompressed once and kept
+    bool ShouldCache(const std::string &file_name) {
+        if (entry_cache.contains(file_name)) {
+            return true;
+        }
+        if (archive.getEntry(kMemoryMetafileName).isNull() &&
+            archive.getEntry(kMemoryBinaryMetafileName).isNull()) {
+            return false;
+        }
+        GetMemoryConfig();
+        auto it = image_references.find(file_name);
+        return it != image_references.end() && it->second > 1;
+    }
+
+    std::shared_ptr<const ByteVector> GetCachedEntry(const std::string &file_name) {
+        if (auto it = entry_cache.find(file_name); it != entry_cache.end()) {
+            return it->second;
+        }
+        auto entry = GetEntry(file_name);
+        auto data = std::make_shared<ByteVector>(entry.getSize());
+        ReadRange(entry, data->data(), 0, data->size());
+        entry_cache[file_name] = data;
+        return data;
+    }
+
+    static void ReadRange(const ZipEntry &entry, uint8_t *output, size_t offset,
+                          size_t length) {
+        if (length == 0) {
+            return;
+        }
+        SliceStreamBuf buffer{output, offset, length};
+        std::ostream stream{&buffer};
+        entry.readContent(stream);
+        if (!buffer.Complete()) {
+            throw std::runtime_error(
+                fmt::format("Failed to read '{}' from package", entry.getName()));
+        }
+    }
 };
 
 ZipPackage::ZipPackage(std::string container_path)
@@ -24,30 +145,34 @@ ZipPackage::ZipPackage(std::string container_path)
 ZipPackage::~ZipPackage() = default;
 
 MemoryConfig ZipPackage::LoadMemoryConfig() const {
-    auto entry = impl->archive.getEntry(kMemoryMetafileName);
-    if (entry.isNull()) {
-        throw std::runtime_error("Failed to find memory config in package");
-    }
-    auto config_string = entry.readAsText();
-    return LoadMemoryConfigurationFromString(config_string);
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    return impl->GetMemoryConfig();
 }
 
 ByteVector ZipPackage::LoadFile(const std::string &file_name,
                                 std::optional<size_t> offset,
                                 std::optional<size_t> length) const {
-    auto entry = impl->archive.getEntry(file_name);
-    if (entry.isNull()) {
-        throw std::runtime_error(
-            fmt::format("Failed to find '{}' in package", file_name));
-    }
-    auto data = entry.readAsText();
-    auto beg = data.begin() + static_cast<std::streamsize>(offset.value_or(0));
-    auto to_read = static_cast<std::streamsize>(
-        std::min(data.size() - offset.value_or(0), length.value_or(data.size())));
-    if (beg + to_read >= data.end()) {
-        to_read = data.end() - beg; //trim if overflow
-    }
-    return ByteVector{beg, beg + to_read};
+    std::lock_guard<std::mutex> lock(impl->mutex);
+
+    auto entry = impl->GetEntry(file_name);
+    auto entry_size = static_cast<size_t>(entry.getSize());
+    auto beg = std::min(offset.value_or(0), entry_size);
+    auto to_read = std::min(entry_size - beg, length.value_or(entry_size)); //trim if overflow
+
+    if (impl->ShouldCache(file_name)) {
+        auto data = impl->GetCachedEntry(file_name);
+        return ByteVector{data->begin() + static_cast<std::ptrdiff_t>(beg),
+                          data->begin() + static_cast<std::ptrdiff_t>(beg + to_read)};
+    }
+
+    ByteVector r(to_read);
+    Impl::ReadRange(entry, r.data(), beg, to_read);
+    return r;
+}
+
+size_t ZipPackage::FileSize(const std::string &file_name) const {
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    return static_cast<size_t>(impl->GetEntry(file_name).getSize());
 }
 
-} // namespace emu::package
\ No newline at end of file
+} // namespace emu::package
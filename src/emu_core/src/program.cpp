@@ -2,6 +2,8 @@
 #include "emu_core/base16.hpp"
 #include "emu_core/byte_utils.hpp"
 #include <algorithm>
+#include <array>
+#include <iterator>
 #include <fmt/format.h>
 #include <limits>
 #include <stdexcept>
@@ -48,14 +50,6 @@ std::string to_string(const SymbolInfo &symbol) {
     return r;
 }
 
-std::string to_string(std::weak_ptr<SymbolInfo> symbol) {
-    auto ptr = symbol.lock();
-    if (!ptr) {
-        return "SymbolInfo:NULL";
-    }
-    return to_string(*ptr);
-}
-
 std::string to_string(Segment mode) {
     switch (mode) {
     case Segment::ZeroPage:
@@ -114,46 +108,22 @@ uint8_t RelocationSize(RelocationMode rm) {
         fmt::format("Unknown relocation mode {}", static_cast<int>(rm)));
 }
 
-bool RelocationInfo::operator==(const RelocationInfo &other) const {
-    if (position != other.position || mode != other.mode) {
-        return false;
-    }
-
-    auto my_symbol = target_symbol.lock();
-    auto oth_symbol = other.target_symbol.lock();
-    if (static_cast<bool>(my_symbol) != static_cast<bool>(oth_symbol)) {
-        return false;
-    }
-    if (my_symbol) {
-        return *my_symbol == *oth_symbol;
-    } else {
-        return true;
-    }
-}
-
 bool RelocationInfo::operator<(const RelocationInfo &other) const {
     return position < other.position;
 }
 
-std::string to_string(const RelocationInfo &relocation) {
+std::string to_string(const RelocationInfo &relocation, const SymbolTable &symbols) {
     std::string r = "RelocationInfo:{";
-    auto symbol = relocation.target_symbol.lock();
-    std::string symbol_name =
-        symbol ? fmt::format("'{}'", symbol->name) : std::string("-");
+    std::string symbol_name = "-";
+    if (relocation.target_symbol < symbols.size()) {
+        symbol_name = fmt::format("'{}'", symbols[relocation.target_symbol].name);
+    }
     r += fmt::format("position:{:04x},mode:{},symbol:{}", relocation.position,
                      to_string(relocation.mode), symbol_name);
     r += "}";
     return r;
 }
 
-std::string to_string(std::weak_ptr<RelocationInfo> relocation) {
-    auto ptr = relocation.lock();
-    if (!ptr) {
-        return "RelocationInfo:NULL";
-    }
-    return to_string(*ptr);
-}
-
 //-----------------------------------------------------------------------------
 
 std::string to_string(const ValueAlias &value_alias) {
@@ -161,54 +131,205 @@ std::string to_string(const ValueAlias &value_alias) {
                        ToHex(value_alias.value, ""));
 }
 
-std::string to_string(std::shared_ptr<ValueAlias> value_alias) {
-    return to_string(*value_alias);
+//-----------------------------------------------------------------------------
+
+SparseBinaryCode::SparseBinaryCode(
+    std::initializer_list<std::pair<Address_t, uint8_t>> init) {
+    for (auto [address, byte] : init) {
+        PutByte(address, byte);
+    }
+}
+
+SparseBinaryCode::RangeMap::const_iterator
+SparseBinaryCode::FindRun(Address_t address) const {
+    auto it = ranges.upper_bound(address);
+    if (it == ranges.begin()) {
+        return ranges.end();
+    }
+    --it;
+    return address < it->first + it->second.size() ? it : ranges.end();
 }
 
-//-----------------------------------------------------------------------------
+size_t SparseBinaryCode::ByteCount() const {
+    size_t r = 0;
+    for (auto &[address, bytes] : ranges) {
+        r += bytes.size();
+    }
+    return r;
+}
+
+std::optional<uint8_t> SparseBinaryCode::Get(Address_t address) const {
+    auto it = FindRun(address);
+    if (it == ranges.end()) {
+        return std::nullopt;
+    }
+    return it->second[address - it->first];
+}
+
+uint8_t SparseBinaryCode::At(Address_t address) const {
+    auto byte = Get(address);
+    if (!byte.has_value()) {
+        throw std::out_of_range(fmt::format("Address {:04x} is not occupied", address));
+    }
+    return *byte;
+}
+
+ByteVector SparseBinaryCode::ReadBytes(Address_t address, size_t count) const {
+    if (count == 0) {
+        return {};
+    }
+    auto it = FindRun(address);
+    if (it == ranges.end() || address + count > it->first + it->second.size()) {
+        throw std::out_of_range(
+            fmt::format("Range {:04x}+{} is not fully occupied", address, count));
+    }
+    auto begin = it->second.begin() + (address - it->first);
+    return ByteVector(begin, begin + static_cast<std::ptrdiff_t>(count));
+}
+
+std::optional<Address_t> SparseBinaryCode::FindOccupied(Address_t address,
+                                                        size_t count) const {
+    if (count == 0) {
+        return std::nullopt;
+    }
+    if (FindRun(address) != ranges.end()) {
+        return address;
+    }
+    auto it = ranges.upper_bound(address);
+    if (it != ranges.end() && it->first < address + count) {
+        return it->first;
+    }
+    return std::nullopt;
+}
 
 std::pair<Address_t, Address_t> SparseBinaryCode::CodeRange() const {
-    auto [min, max] =
-        std::minmax_element(sparse_map.begin(), sparse_map.end(),
-                            [](auto &a, auto &b) { return a.first < b.first; });
-    return {min->first, max->first};
+    auto &[last_address, last_bytes] = *ranges.rbegin();
+    return {ranges.begin()->first,
+            static_cast<Address_t>(last_address + last_bytes.size() - 1)};
 }
 
 void SparseBinaryCode::PutByte(Address_t address, uint8_t byte, bool overwrite) {
-    if (sparse_map.find(address) != sparse_map.end() && !overwrite) {
+    PutBytes(address, {byte}, overwrite);
+}
+
+void SparseBinaryCode::PutBytes(Address_t address, std::span<const uint8_t> bytes,
+                                bool overwrite) {
+    if (bytes.empty()) {
+        return;
+    }
+    size_t end = address + bytes.size();
+    if (end > std::numeric_limits<Address_t>::max() + size_t{1}) {
+        throw std::runtime_error(fmt::format("Program::PutBytes address overflow!"));
+    }
+    if (auto occupied = FindOccupied(address, bytes.size());
+        occupied.has_value() && !overwrite) {
         throw std::runtime_error(
-            fmt::format("Address {:04x} is already occupied", address));
+            fmt::format("Address {:04x} is already occupied", *occupied));
+    }
+
+    // Runs which overlap or touch new bytes are merged with them
+    auto first = ranges.upper_bound(address);
+    if (first != ranges.begin()) {
+        auto prev = std::prev(first);
+        if (prev->first + prev->second.size() >= address) {
+            first = prev;
+        }
     }
-    sparse_map[address] = byte;
+    auto last = first;
+    while (last != ranges.end() && last->first <= end) {
+        ++last;
+    }
+    if (first == last) {
+        ranges.emplace_hint(last, address, ByteVector(bytes.begin(), bytes.end()));
+        return;
+    }
+
+    Address_t start = std::min(address, first->first);
+    auto &tail = *std::prev(last);
+    end = std::max(end, tail.first + tail.second.size());
+    ByteVector merged;
+    if (first->first == start && std::next(first) == last) {
+        merged = std::move(first->second);
+        merged.resize(end - start);
+    } else {
+        merged.resize(end - start);
+        for (auto it = first; it != last; ++it) {
+            std::copy(it->second.begin(), it->second.end(),
+                      merged.begin() + (it->first - start));
+        }
+    }
+    std::copy(bytes.begin(), bytes.end(), merged.begin() + (address - start));
+    ranges.erase(first, last);
+    ranges.emplace(start, std::move(merged));
 }
 
-void SparseBinaryCode::PutBytes(Address_t address, const std::vector<uint8_t> &bytes,
-                                bool overwrite) {
-    for (size_t i = 0; i < bytes.size(); i++) {
-        size_t a = address;
-        a += i;
-        if (a > std::numeric_limits<Address_t>::max()) {
-            throw std::runtime_error(fmt::format("Program::PutBytes address overflow!"));
+void SparseBinaryCode::Erase(Address_t address, size_t count) {
+    size_t end = address + count;
+    auto it = ranges.upper_bound(address);
+    if (it != ranges.begin()) {
+        --it;
+    }
+    while (it != ranges.end() && it->first < end) {
+        size_t run_end = it->first + it->second.size();
+        if (run_end <= address) {
+            ++it;
+            continue;
+        }
+        auto &bytes = it->second;
+        if (run_end > end) {
+            auto kept = static_cast<std::ptrdiff_t>(run_end - end);
+            ranges.emplace(static_cast<Address_t>(end),
+                           ByteVector(bytes.end() - kept, bytes.end()));
+        }
+        if (it->first < address) {
+            bytes.resize(address - it->first);
+            ++it;
+        } else {
+            it = ranges.erase(it);
         }
-        PutByte(static_cast<Address_t>(a), bytes[i], overwrite);
     }
 }
 
 bool SparseBinaryCode::operator==(const SparseBinaryCode &other) const {
-    return sparse_map == other.sparse_map;
+    return ranges == other.ranges;
 }
 
 std::string SparseBinaryCode::HexDump(std::string_view line_prefix) const {
-    return SparseHexDump(sparse_map, line_prefix);
+    std::string r;
+    // Runs are visited in order, line is printed once all its runs are seen
+    std::optional<size_t> line;
+    std::array<std::optional<uint8_t>, 0x10> line_bytes;
+    auto flush = [&] {
+        if (!line.has_value()) {
+            return;
+        }
+        std::string hexes;
+        for (auto &byte : line_bytes) {
+            hexes += byte.has_value() ? fmt::format(" {:02x}", *byte) : " --";
+            byte.reset();
+        }
+        r += fmt::format("{}{:04x} |{}\n", line_prefix, *line, hexes);
+    };
+
+    for (auto &[start, bytes] : ranges) {
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            size_t address = start + i;
+            if (line != (address & ~size_t{0xF})) {
+                flush();
+                line = address & ~size_t{0xF};
+            }
+            line_bytes[address & 0xF] = bytes[i];
+        }
+    }
+    flush();
+    return r;
 }
 
 ByteVector SparseBinaryCode::DumpMemory() const {
     ByteVector r(0x10000, 0);
-
-    for (auto [addr, value] : sparse_map) {
-        r[addr] = value;
+    for (auto &[address, bytes] : ranges) {
+        std::copy(bytes.begin(), bytes.end(), r.begin() + address);
     }
-
     return r;
 }
 
@@ -217,16 +338,16 @@ ByteVector SparseBinaryCode::DumpMemory() const {
 std::string to_string(const Program &program) {
     std::string r = "Program:\n";
     r += "\tsymbols:\n";
-    for (auto &[n, l] : program.symbols) {
-        r += fmt::format("\t\t{}\n", to_string(*l));
+    for (auto &symbol : program.symbols) {
+        r += fmt::format("\t\t{}\n", to_string(symbol));
     }
     r += "\tRelocations:\n";
-    for (auto &l : program.relocations) {
-        r += fmt::format("\t\t{}\n", to_string(*l));
+    for (auto &relocation : program.SortedRelocations()) {
+        r += fmt::format("\t\t{}\n", to_string(relocation, program.symbols));
     }
     r += "\tAliases:\n";
-    for (auto &[n, l] : program.aliases) {
-        r += fmt::format("\t\t{}\n", to_string(*l));
+    for (auto &alias : program.aliases) {
+        r += fmt::format("\t\t{}\n", to_string(alias));
     }
     r += "\tCode:\n";
     r += program.sparse_binary_code.HexDump("\t\t");
@@ -243,50 +364,49 @@ bool Program::operator==(const Program &other) const {
         return false;
     }
 
-    for (auto &item : symbols) {
-        auto other_it = other.symbols.find(item.first);
-        if (other_it == other.symbols.end() || (*other_it->second) != (*item.second)) {
+    for (auto &symbol : symbols) {
+        auto other_symbol = other.FindSymbol(symbol.name);
+        if (other_symbol == nullptr || *other_symbol != symbol) {
             return false;
         }
     }
 
-    return std::equal(relocations.begin(), relocations.end(), other.relocations.begin(),
-                      other.relocations.end(),
-                      [](auto &a, auto &b) { return (*a) == (*b); });
+    auto sorted = SortedRelocations();
+    auto other_sorted = other.SortedRelocations();
+    return std::equal(sorted.begin(), sorted.end(), other_sorted.begin(),
+                      other_sorted.end(), [&](auto &a, auto &b) {
+                          return a.position == b.position && a.mode == b.mode &&
+                                 Target(a) == other.Target(b);
+                      });
 }
 
-std::shared_ptr<ValueAlias> Program::FindAlias(const std::string &name) const {
-    auto it = aliases.find(name);
-    return it == aliases.end() ? nullptr : it->second;
-}
-
-std::shared_ptr<SymbolInfo> Program::FindSymbol(const std::string &name) const {
-    auto it = symbols.find(name);
-    return it == symbols.end() ? nullptr : it->second;
+RelocationList Program::SortedRelocations() const {
+    auto r = relocations;
+    std::sort(r.begin(), r.end());
+    return r;
 }
 
-void Program::AddAlias(std::shared_ptr<ValueAlias> alias) {
-    if (alias->name.size() < 2) {
-        throw std::runtime_error(
-            fmt::format("symbol '{}' name is to short", alias->name));
+void Program::AddAlias(ValueAlias alias) {
+    if (alias.name.size() < 2) {
+        throw std::runtime_error(fmt::format("symbol '{}' name is to short", alias.name));
     }
-    if (aliases.contains(alias->name)) {
+    if (aliases.contains(alias.name)) {
         throw std::runtime_error(
-            fmt::format("Alias '{}' is already defined", alias->name));
+            fmt::format("Alias '{}' is already defined", alias.name));
     }
-    aliases[alias->name] = std::move(alias);
+    aliases.Add(std::move(alias));
 }
 
-void Program::AddSymbol(std::shared_ptr<SymbolInfo> symbol) {
-    if (symbol->name.size() < 2) {
+SymbolId Program::AddSymbol(SymbolInfo symbol) {
+    if (symbol.name.size() < 2) {
         throw std::runtime_error(
-            fmt::format("symbol '{}' name is to short", symbol->name));
+            fmt::format("symbol '{}' name is to short", symbol.name));
     }
-    if (symbols.contains(symbol->name)) {
+    if (symbols.contains(symbol.name)) {
         throw std::runtime_error(
-            fmt::format("symbol '{}' is already defined", symbol->name));
+            fmt::format("symbol '{}' is already defined", symbol.name));
     }
-    symbols[symbol->name] = std::move(symbol);
+    return symbols.Add(std::move(symbol));
 }
 
 } // namespace emu
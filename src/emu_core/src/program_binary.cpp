@@ -0,0 +1,188 @@
+#include "binary_codec.hpp"
+#include "emu_core/program.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <string_view>
+#include <vector>
+
+namespace emu {
+
+namespace {
+
+constexpr std::array<uint8_t, 4> kBinaryMagic = {'E', 'P', 'R', 'G'};
+constexpr uint8_t kBinaryVersion = 1;
+
+enum class AddressKind : uint8_t {
+    kNone = 0,
+    kByte = 1,
+    kWord = 2,
+};
+
+struct ProgramWriter : BinaryWriter {
+    void Write(const SparseBinaryCode &code) {
+        WriteVarint(code.Ranges().size());
+        for (auto &[address, bytes] : code.Ranges()) {
+            WriteVarint(address);
+            WriteVarint(bytes.size());
+            WriteBytes(bytes);
+        }
+    }
+
+    void Write(const SymbolAddress &address) {
+        if (std::holds_alternative<uint8_t>(address)) {
+            WriteByte(static_cast<uint8_t>(AddressKind::kByte));
+            WriteVarint(std::get<uint8_t>(address));
+        } else if (std::holds_alternative<uint16_t>(address)) {
+            WriteByte(static_cast<uint8_t>(AddressKind::kWord));
+            WriteVarint(std::get<uint16_t>(address));
+        } else {
+            WriteByte(static_cast<uint8_t>(AddressKind::kNone));
+        }
+    }
+};
+
+struct ProgramReader : BinaryReader {
+    using BinaryReader::ReadVarint;
+
+    uint64_t ReadVarint(uint64_t limit) {
+        auto v = BinaryReader::ReadVarint();
+        if (v > limit) {
+            Error("value out of range");
+        }
+        return v;
+    }
+
+    void Read(SparseBinaryCode &code) {
+        for (auto count = ReadVarint(); count > 0; --count) {
+            auto address = ReadVarint(0xFFFF);
+            auto bytes = ReadBytes(ReadVarint(0x10000 - address));
+            code.PutBytes(static_cast<Address_t>(address), bytes, true);
+        }
+    }
+
+    SymbolAddress ReadAddress() {
+        switch (static_cast<AddressKind>(ReadByte())) {
+        case AddressKind::kNone:
+            return std::monostate{};
+        case AddressKind::kByte:
+            return static_cast<uint8_t>(ReadVarint(0xFF));
+        case AddressKind::kWord:
+            return static_cast<uint16_t>(ReadVarint(0xFFFF));
+        default:
+            Error("unknown address kind");
+        }
+    }
+};
+
+} // namespace
+
+ByteVector StoreProgramToBinary(const Program &program) {
+    ProgramWriter w;
+    w.data.assign(kBinaryMagic.begin(), kBinaryMagic.end());
+    w.WriteByte(kBinaryVersion);
+
+    w.Write(program.sparse_binary_code);
+
+    // Tables are stored sorted by name, so output does not depend on order of insertion
+    std::map<std::string_view, const ValueAlias *> aliases;
+    for (auto &alias : program.aliases) {
+        aliases[alias.name] = &alias;
+    }
+    w.WriteVarint(aliases.size());
+    for (auto &[name, alias] : aliases) {
+        w.WriteString(alias->name);
+        w.WriteVarint(alias->value.size());
+        w.WriteBytes(alias->value);
+    }
+
+    std::map<std::string_view, SymbolId> symbols;
+    for (auto &symbol : program.symbols) {
+        symbols[symbol.name] = *program.FindSymbolId(symbol.name);
+    }
+    std::vector<size_t> symbol_index(program.symbols.size());
+    size_t next_index = 0;
+    w.WriteVarint(symbols.size());
+    for (auto &[name, id] : symbols) {
+        auto &symbol = program.symbols[id];
+        symbol_index[id] = next_index++;
+        w.WriteString(symbol.name);
+        w.Write(symbol.offset);
+        w.WriteVarint(symbol.segment.has_value() ? static_cast<uint64_t>(*symbol.segment)
+                                                 : 0);
+        w.WriteByte(symbol.imported ? 1 : 0);
+    }
+
+    w.WriteVarint(program.relocations.size());
+    for (auto &relocation : program.SortedRelocations()) {
+        if (relocation.target_symbol >= symbol_index.size()) {
+            throw std::runtime_error(fmt::format(
+                "Relocation at {:04x} refers to symbol outside of program",
+                relocation.position));
+        }
+        w.WriteVarint(symbol_index[relocation.target_symbol]);
+        w.WriteVarint(relocation.position);
+        w.WriteByte(static_cast<uint8_t>(relocation.mode));
+    }
+
+    return std::move(w.data);
+}
+
+Program LoadProgramFromBinary(std::span<const uint8_t> data) {
+    ProgramReader r{{.data = data, .format_name = "binary program"}};
+    if (data.size() < kBinaryMagic.size() ||
+        std::memcmp(data.data(), kBinaryMagic.data(), kBinaryMagic.size()) != 0) {
+        r.Error("invalid magic");
+    }
+    r.position = kBinaryMagic.size();
+    if (auto version = r.ReadByte(); version != kBinaryVersion) {
+        r.Error(fmt::format("unsupported version {}", version));
+    }
+
+    Program program;
+    r.Read(program.sparse_binary_code);
+
+    for (auto count = r.ReadVarint(); count > 0; --count) {
+        ValueAlias alias;
+        alias.name = r.ReadString();
+        auto value = r.ReadBytes(r.ReadVarint());
+        alias.value.assign(value.begin(), value.end());
+        program.AddAlias(std::move(alias));
+    }
+
+    std::vector<SymbolId> symbols;
+    for (auto count = r.ReadVarint(); count > 0; --count) {
+        SymbolInfo symbol;
+        symbol.name = r.ReadString();
+        symbol.offset = r.ReadAddress();
+        if (auto segment = r.ReadVarint(static_cast<uint64_t>(Segment::AbsoluteAddress));
+            segment != 0) {
+            symbol.segment = static_cast<Segment>(segment);
+        }
+        symbol.imported = r.ReadByte() != 0;
+        symbols.push_back(program.AddSymbol(std::move(symbol)));
+    }
+
+    for (auto count = r.ReadVarint(); count > 0; --count) {
+        auto index = r.ReadVarint();
+        if (index >= symbols.size()) {
+            r.Error("relocation symbol index out of range");
+        }
+        RelocationInfo relocation{.target_symbol = symbols[index]};
+        relocation.position = static_cast<Address_t>(r.ReadVarint(0xFFFF));
+        auto mode = r.ReadByte();
+        if (mode > static_cast<uint8_t>(RelocationMode::ZeroPage)) {
+            r.Error("unknown relocation mode");
+        }
+        relocation.mode = static_cast<RelocationMode>(mode);
+        program.relocations.push_back(relocation);
+    }
+
+    if (!r.AtEnd()) {
+        r.Error("trailing data");
+    }
+    return program;
+}
+
+} // namespace emu
@@ -0,0 +1,34 @@
+#include "emu_core/clock.hpp"
+#include <gtest/gtest.h>
+
+namespace emu::test {
+namespace {
+
+void RunCycles(Clock &clock, uint64_t cycles) {
+    for (uint64_t i = 0; i < cycles; ++i) {
+        clock.WaitForNextCycle();
+    }
+}
+
+TEST(ClockTest, ResetRestartsWatchdog) {
+    ClockSimple clock;
+    clock.ArmWatchdog(100);
+    RunCycles(clock, 150);
+    EXPECT_TRUE(clock.WatchdogExpired());
+
+    // Deadline of previous run is dropped, timeout starts from cycle 0
+    clock.Reset();
+    EXPECT_FALSE(clock.WatchdogExpired());
+    RunCycles(clock, 99);
+    EXPECT_FALSE(clock.WatchdogExpired());
+    RunCycles(clock, 1);
+    EXPECT_TRUE(clock.WatchdogExpired());
+
+    clock.DisarmWatchdog();
+    clock.Reset();
+    RunCycles(clock, 1000);
+    EXPECT_FALSE(clock.WatchdogExpired());
+}
+
+} // namespace
+} // namespace emu::test
@@ -0,0 +1,64 @@
+#include "emu_core/interned_table.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace emu::test {
+namespace {
+
+struct Entry {
+    std::string name;
+    int value = 0;
+};
+
+TEST(InternedTableTest, AddAndFind) {
+    InternedTable<Entry> table{{"a", 1}, {"b", 2}};
+    auto &first = table[0];
+    for (int i = 0; i < 1000; ++i) {
+        table.Add({"entry" + std::to_string(i), i});
+    }
+    EXPECT_EQ(&first, table.Find("a"));
+    EXPECT_EQ(table.FindId("b"), 1u);
+    EXPECT_EQ(table.FindId("entry999"), 1001u);
+    EXPECT_EQ(table.Find("c"), nullptr);
+    EXPECT_FALSE(table.contains("c"));
+    EXPECT_EQ(table.size(), 1002u);
+}
+
+TEST(InternedTableTest, CopyRebuildsIndex) {
+    InternedTable<Entry> table{{"a", 1}, {"b", 2}};
+    auto copy = table;
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    ASSERT_NE(copy.Find("b"), nullptr);
+    EXPECT_EQ(copy.Find("b")->value, 2);
+
+    std::vector<std::string> names;
+    for (auto &entry : copy) {
+        names.push_back(entry.name);
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"a", "b"}));
+}
+
+TEST(InternedTableTest, MapView) {
+    InternedTable<Entry> table{{"a", 1}, {"b", 2}};
+    InternedTableMapView<Entry> view{table};
+    table.Add({"c", 3});
+
+    EXPECT_EQ(view.size(), 3u);
+    EXPECT_TRUE(view.contains("c"));
+    EXPECT_EQ(view.count("d"), 0u);
+    EXPECT_EQ(view.at("b"), table.Find("b"));
+    EXPECT_THROW((void)view.at("d"), std::out_of_range);
+
+    std::vector<std::string> names;
+    for (auto &[name, entry] : view) {
+        EXPECT_EQ(name, entry->name);
+        names.emplace_back(name);
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"a", "b", "c"}));
+}
+
+} // namespace
+} // namespace emu::test
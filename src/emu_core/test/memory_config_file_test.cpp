@@ -3,7 +3,10 @@
 
 #include "emu_core/file_search.hpp"
 #include "emu_core/memory_configuration_file.hpp"
+#include <filesystem>
+#include <fstream>
 #include <sstream>
+#include <unistd.h>
 
 namespace emu::test {
 namespace {
@@ -181,5 +184,94 @@ memory:
     }
 }
 
+TEST_F(MemoryConfigFileTest, binary_round_trip) {
+    const MemoryConfig config{
+        .entries =
+            {
+                MemoryConfigEntry{
+                    .name = "rom",
+                    .offset = 0xE000,
+                    .entry_variant =
+                        MemoryConfigEntry::RamArea{
+                            .image =
+                                MemoryConfigEntry::RamArea::Image{
+                                    .file = "rom.bin",
+                                    .offset = 0x1234,
+                                },
+                            .size = 0x2000,
+                            .writable = false,
+                        },
+                },
+                MemoryConfigEntry{
+                    .name = "",
+                    .offset = 0,
+                    .entry_variant =
+                        MemoryConfigEntry::RamArea{
+                            .image = MemoryConfigEntry::RamArea::Image{.file = "a.bin"},
+                            .size = std::nullopt,
+                            .writable = true,
+                        },
+                },
+                MemoryConfigEntry{
+                    .name = "dev",
+                    .offset = 0xA000,
+                    .entry_variant =
+                        MemoryConfigEntry::MappedDevice{
+                            .module_name = "tty",
+                            .class_name = "default",
+                            .config = {{"s", "text"},
+                                       {"n", std::monostate{}},
+                                       {"i", int64_t{-70000}},
+                                       {"b", true},
+                                       {"d", 0.25}},
+                        },
+                },
+            },
+    };
+
+    auto binary = StoreMemoryConfigurationToBinary(config);
+    EXPECT_EQ(LoadMemoryConfigurationFromBinary(binary), config);
+
+    for (size_t size = 0; size < binary.size(); ++size) {
+        EXPECT_THROW(LoadMemoryConfigurationFromBinary(
+                         std::span<const uint8_t>{binary}.first(size)),
+                     std::runtime_error);
+    }
+    binary[0] = 'X';
+    EXPECT_THROW(LoadMemoryConfigurationFromBinary(binary), std::runtime_error);
+}
+
+TEST_F(MemoryConfigFileTest, cached) {
+    auto dir = std::filesystem::temp_directory_path() /
+               fmt::format("emu_memory_config_cache_{}", ::getpid());
+    std::filesystem::create_directories(dir);
+    auto file = (dir / "memory.yaml").string();
+    std::ofstream(file) << R"==(
+memory:
+- ram:
+  offset: 0x0000
+  size: 0x0100
+  image:
+    file: $image_file
+)==";
+
+    auto first = LoadMemoryConfigurationCached(file, nullptr, {{"image_file", "a.bin"}});
+    ASSERT_TRUE(std::filesystem::exists(file + kMemoryConfigCacheExtension));
+    auto second = LoadMemoryConfigurationCached(file, nullptr, {{"image_file", "a.bin"}});
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first, LoadMemoryConfigurationFromFile(file, nullptr,
+                                                     {{"image_file", "a.bin"}}));
+
+    auto other = LoadMemoryConfigurationCached(file, nullptr, {{"image_file", "b.bin"}});
+    auto &ra = std::get<MemoryConfigEntry::RamArea>(other.entries[0].entry_variant);
+    EXPECT_EQ(ra.image->file, "b.bin");
+
+    std::ofstream(file + kMemoryConfigCacheExtension) << "garbage";
+    EXPECT_EQ(LoadMemoryConfigurationCached(file, nullptr, {{"image_file", "a.bin"}}),
+              first);
+
+    std::filesystem::remove_all(dir);
+}
+
 } // namespace
 } // namespace emu::test
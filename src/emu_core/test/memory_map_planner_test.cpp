@@ -0,0 +1,93 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "emu_core/memory_map_planner.hpp"
+#include <sstream>
+
+namespace emu::test {
+namespace {
+
+using namespace ::testing;
+
+MemoryConfigEntry Ram(uint64_t offset, std::optional<uint64_t> size, bool writable = true,
+                      std::string name = "") {
+    return MemoryConfigEntry{
+        .name = std::move(name),
+        .offset = offset,
+        .entry_variant =
+            MemoryConfigEntry::RamArea{
+                .image = std::nullopt,
+                .size = size,
+                .writable = writable,
+            },
+    };
+}
+
+MemoryConfigEntry Device(uint64_t offset, std::string name = "") {
+    return MemoryConfigEntry{
+        .name = std::move(name),
+        .offset = offset,
+        .entry_variant =
+            MemoryConfigEntry::MappedDevice{
+                .module_name = "tty",
+                .class_name = "default",
+            },
+    };
+}
+
+TEST(MemoryMapPlannerTest, MergesAdjacentAreas) {
+    MemoryConfig config{
+        .entries =
+            {
+                Ram(0x1000, 0x1000, true, "b"),
+                Ram(0x0000, 0x1000, true, "a"),
+                Ram(0x2000, 0x0100, false, "rom"),
+                Device(0x2100, "dev"),
+                Ram(0x3000, 0x1000, true, "c"),
+                Ram(0x4000, std::nullopt, true, "d"),
+                Ram(0xF000, 0x0800, false, "e"),
+                Ram(0xF800, 0x0800, false, "f"),
+            },
+    };
+
+    auto plan = PlanMemoryMap(config);
+    ASSERT_EQ(plan.areas.size(), 6);
+
+    EXPECT_EQ(plan.areas[0].offset, 0x0000);
+    EXPECT_EQ(plan.areas[0].size, 0x2000);
+    ASSERT_EQ(plan.areas[0].parts.size(), 2);
+    EXPECT_EQ(plan.areas[0].parts[0].entry->name, "a");
+    EXPECT_EQ(plan.areas[0].parts[1].entry->name, "b");
+    EXPECT_EQ(plan.areas[0].parts[1].offset, 0x1000);
+
+    EXPECT_FALSE(plan.areas[1].IsMerged());
+    EXPECT_EQ(plan.areas[2].parts[0].entry->name, "dev");
+    EXPECT_EQ(plan.areas[2].size, std::nullopt);
+    EXPECT_FALSE(plan.areas[3].IsMerged());
+    EXPECT_EQ(plan.areas[4].size, std::nullopt);
+
+    EXPECT_TRUE(plan.areas[5].IsMerged());
+    EXPECT_EQ(plan.areas[5].size, 0x1000);
+
+    std::stringstream ss;
+    plan.Describe(ss);
+    EXPECT_THAT(ss.str(), HasSubstr("0000-1fff pages 00-1f ram    a+b"));
+    EXPECT_THAT(ss.str(), HasSubstr("f000-ffff pages f0-ff rom    e+f"));
+}
+
+TEST(MemoryMapPlannerTest, DetectsOverlaps) {
+    EXPECT_THROW(PlanMemoryMap({.entries = {Ram(0, 0x1000), Ram(0x0800, 0x1000)}}),
+                 std::runtime_error);
+    EXPECT_THROW(PlanMemoryMap({.entries = {Ram(0, 0x1000), Device(0x0010)}}),
+                 std::runtime_error);
+    EXPECT_THROW(PlanMemoryMap({.entries = {Device(0x10), Device(0x10)}}),
+                 std::runtime_error);
+    EXPECT_THROW(PlanMemoryMap({.entries = {Ram(0xF000, 0x2000)}}), std::runtime_error);
+    EXPECT_THROW(PlanMemoryMap({.entries = {Device(0x10000)}}), std::runtime_error);
+
+    EXPECT_NO_THROW(PlanMemoryMap({.entries = {Ram(0, 0x10000)}}));
+    EXPECT_NO_THROW(PlanMemoryMap({.entries = {Ram(0, 0x10), Device(0x10)}}));
+}
+
+} // namespace
+} // namespace emu::test
@@ -4,9 +4,13 @@
 #include "emu_core/byte_utils.hpp"
 #include "emu_core/clock.hpp"
 #include "emu_core/memory/memory_block.hpp"
+#include "emu_core/memory/memory_lazy.hpp"
 #include "emu_core/memory/memory_mapper.hpp"
 #include "emu_core/program.hpp"
+#include <atomic>
+#include <chrono>
 #include <sstream>
+#include <thread>
 
 namespace emu::test {
 namespace {
@@ -45,6 +49,80 @@ TEST_F(MemoryTest, MemoryBlock16) {
     EXPECT_THROW(mem.Store(200_addr, 1_u8), std::runtime_error);
 }
 
+TEST_F(MemoryTest, MemoryLazy16) {
+    std::vector<std::pair<size_t, size_t>> requests;
+    auto loader = [&](size_t offset, size_t length) {
+        requests.emplace_back(offset, length);
+        MemoryLazy16::VectorType data(std::min<size_t>(length, 16));
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<uint8_t>(offset / MemoryLazy16::kPageSize + i);
+        }
+        return data;
+    };
+    MemoryLazy16 mem{&clock, 0x2100, loader, MemoryMode::kReadWrite};
+    EXPECT_EQ(mem.PageCount(), 3);
+    EXPECT_EQ(mem.LoadedPageCount(), 0);
+
+    EXPECT_EQ(mem.Load(0x1001_addr), 2);
+    EXPECT_EQ(mem.Load(0x1100_addr), 0);
+    EXPECT_NO_THROW(mem.Store(0x1002_addr, 0x55));
+    EXPECT_EQ(mem.Load(0x1002_addr), 0x55);
+    EXPECT_EQ(mem.LoadedPageCount(), 1);
+
+    EXPECT_EQ(mem.Load(0x2000_addr), 2);
+    EXPECT_THAT(requests, ElementsAre(Pair(0x1000, 0x1000), Pair(0x2000, 0x100)));
+
+    EXPECT_THROW(mem.Load(0x2100_addr), std::runtime_error);
+    EXPECT_THROW(mem.Store(0x2100_addr, 1_u8), std::runtime_error);
+    EXPECT_EQ(mem.LoadedPageCount(), 2);
+}
+
+TEST_F(MemoryTest, MemoryLazy16ReadOnly) {
+    auto loader = [](size_t offset, size_t length) {
+        return MemoryLazy16::VectorType(length, 0xAA);
+    };
+    MemoryLazy16 mem{&clock, 0x100, loader, MemoryMode::kReadOnly};
+
+    EXPECT_NO_THROW(mem.Store(0x10_addr, 0x55));
+    EXPECT_EQ(mem.LoadedPageCount(), 0);
+    EXPECT_EQ(mem.Load(0x10_addr), 0xAA);
+    EXPECT_EQ(mem.DebugRead(0x100_addr), std::nullopt);
+}
+
+TEST_F(MemoryTest, MemoryLazy16Prefetch) {
+    auto loader = [](size_t offset, size_t length) {
+        return MemoryLazy16::VectorType(length, static_cast<uint8_t>(offset >> 12));
+    };
+    MemoryLazy16 mem{&clock, 0x10000, loader, MemoryMode::kReadWrite, true};
+
+    EXPECT_EQ(mem.Load(0xF000_addr), 0xF);
+    for (int i = 0; i < 500 && mem.LoadedPageCount() < mem.PageCount(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(mem.LoadedPageCount(), 16);
+    EXPECT_EQ(mem.Load(0x7000_addr), 7);
+}
+
+TEST_F(MemoryTest, MemoryLazy16PrefetchError) {
+    std::atomic<bool> failed = false;
+    auto loader = [&](size_t offset, size_t length) {
+        if (offset == MemoryLazy16::kPageSize) {
+            failed = true;
+            throw std::runtime_error("read error");
+        }
+        return MemoryLazy16::VectorType(length, 0xAA);
+    };
+    MemoryLazy16 mem{&clock, 0x3000, loader, MemoryMode::kReadWrite, true};
+
+    for (int i = 0; i < 500 && !failed; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(failed);
+    EXPECT_EQ(mem.Load(0x0010_addr), 0xAA);
+    EXPECT_THROW(mem.Load(0x1010_addr), std::runtime_error);
+    EXPECT_EQ(mem.LoadedPageCount(), 1);
+}
+
 TEST_F(MemoryTest, MemoryMapper16) {
     MemoryMapper16 mapper{&clock, {}, true, &std::cout};
 
@@ -69,5 +147,23 @@ TEST_F(MemoryTest, MemoryMapper16) {
     EXPECT_NO_THROW(mapper.Store(40_addr, 8_u8));
 }
 
+TEST_F(MemoryTest, MemoryMapper16Validation) {
+    MemoryMapper16 mapper{&clock, {}, true};
+
+    mapper.MapArea({0x0000_addr, 0x02ff_addr}, &mock_a);
+    mapper.MapArea({0x0300_addr, 0x030f_addr}, &mock_b);
+
+    EXPECT_THROW(mapper.MapArea({0x0200_addr, 0x0300_addr}, &mock_b), std::runtime_error);
+    EXPECT_THROW(mapper.MapArea({0x030f_addr, 0x0310_addr}, &mock_b), std::runtime_error);
+    EXPECT_THROW(mapper.MapArea({0x0500_addr, 0x0400_addr}, &mock_b), std::runtime_error);
+    EXPECT_THROW(mapper.MapArea({0x0500_addr, 0x0600_addr}, nullptr), std::runtime_error);
+
+    EXPECT_CALL(mock_a, Load(0x0180_addr)).WillOnce(Return(1_u8));
+    EXPECT_EQ(mapper.Load(0x0180_addr), 1_u8);
+    EXPECT_CALL(mock_b, Load(0x0005_addr)).WillOnce(Return(2_u8));
+    EXPECT_EQ(mapper.Load(0x0305_addr), 2_u8);
+    EXPECT_THROW(mapper.Load(0x0310_addr), std::runtime_error);
+}
+
 } // namespace
 } // namespace emu::test
@@ -0,0 +1,99 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "emu_core/package/package_builder_mapped.hpp"
+#include "emu_core/package/package_mapped.hpp"
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <unistd.h>
+
+namespace emu::package::test {
+namespace {
+
+using namespace ::testing;
+using namespace std::string_literals;
+
+class MappedPackageTest : public testing::Test {
+public:
+    std::string path = (std::filesystem::temp_directory_path() /
+                        fmt::format("emu_mapped_package_test_{}{}", ::getpid(),
+                                    kEmuMappedImageExtension))
+                           .string();
+    ByteVector image = ByteVector(0x1800);
+    MemoryConfig config;
+
+    void SetUp() override {
+        std::iota(image.begin(), image.end(), uint8_t{0});
+        config.entries.emplace_back(MemoryConfigEntry{
+            .name = "rom",
+            .offset = 0xF000,
+            .entry_variant =
+                MemoryConfigEntry::RamArea{
+                    .image = MemoryConfigEntry::RamArea::Image{.file = "rom.bin"},
+                    .size = 0x1000,
+                    .writable = false,
+                },
+        });
+
+        MappedPackageBuilder builder{path};
+        builder.AddFile(image, "rom.bin");
+        builder.AddFile({}, "empty.bin");
+        builder.SetMemoryConfig(config);
+        builder.Finish();
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+};
+
+TEST_F(MappedPackageTest, RoundTrip) {
+    MappedPackage package{path};
+    EXPECT_EQ(package.LoadMemoryConfig(), config);
+    EXPECT_EQ(package.LoadFile("rom.bin"), image);
+    EXPECT_EQ(package.LoadFile("rom.bin", 0x10, 0x10),
+              ByteVector(image.begin() + 0x10, image.begin() + 0x20));
+    EXPECT_TRUE(package.LoadFile("empty.bin").empty());
+    EXPECT_THROW((void)package.LoadFile("missing.bin"), std::runtime_error);
+}
+
+TEST_F(MappedPackageTest, MapFile) {
+    std::optional<MappedFile> mapped;
+    {
+        MappedPackage package{path};
+        mapped = package.MapFile("rom.bin", 0x1000, 0x1000);
+    }
+    ASSERT_TRUE(mapped.has_value());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped->data.data()) % 4096, 0u);
+    ASSERT_EQ(mapped->data.size(), 0x800);
+    EXPECT_TRUE(
+        std::equal(mapped->data.begin(), mapped->data.end(), image.begin() + 0x1000));
+}
+
+TEST_F(MappedPackageTest, InvalidFile) {
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "not a package at all";
+    }
+    EXPECT_THROW(MappedPackage{path}, std::runtime_error);
+}
+
+TEST_F(MappedPackageTest, LittleEndianIndex) {
+    std::ifstream in(path, std::ios::binary);
+    ByteVector head(sizeof(MappedImageHeader) + 16);
+    in.read(reinterpret_cast<char *>(head.data()),
+            static_cast<std::streamsize>(head.size()));
+    // Version, entry count, offset and size of first file
+    EXPECT_THAT(ByteVector(head.begin() + 8, head.end()),
+                ElementsAre(1, 0, 0, 0, 4, 0, 0, 0,       //
+                            0x00, 0x10, 0, 0, 0, 0, 0, 0, //
+                            0x00, 0x18, 0, 0, 0, 0, 0, 0));
+}
+
+TEST_F(MappedPackageTest, WriteError) {
+    MappedPackageBuilder builder{path + ".missing/package"};
+    builder.AddFile(image, "rom.bin");
+    EXPECT_THROW(builder.Finish(), std::runtime_error);
+}
+
+} // namespace
+} // namespace emu::package::test
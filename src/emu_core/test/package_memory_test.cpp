@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "emu_core/package/package_memory.hpp"
+#include <numeric>
+
+namespace emu::package::test {
+namespace {
+
+TEST(MemoryPackageTest, ServesFilesFromMemory) {
+    MemoryConfig config;
+    config.entries.emplace_back(MemoryConfigEntry{
+        .name = "ram",
+        .offset = 0,
+        .entry_variant =
+            MemoryConfigEntry::RamArea{
+                .image = MemoryConfigEntry::RamArea::Image{.file = "program.bin"},
+                .size = 0x100,
+                .writable = true,
+            },
+    });
+    ByteVector image(0x100);
+    std::iota(image.begin(), image.end(), uint8_t{0});
+
+    MemoryPackage package{config};
+    package.AddFile("program.bin", image);
+    EXPECT_EQ(package.LoadMemoryConfig(), config);
+    EXPECT_EQ(package.LoadFile("program.bin"), image);
+    EXPECT_EQ(package.LoadFile("program.bin", 0xF0, 0x20),
+              ByteVector(image.begin() + 0xF0, image.end()));
+    EXPECT_THROW((void)package.LoadFile("missing.bin"), std::runtime_error);
+
+    std::optional<MappedFile> mapped = package.MapFile("program.bin", 0x10, 0x10);
+    package.AddFile("program.bin", {});
+    ASSERT_TRUE(mapped.has_value());
+    ASSERT_EQ(mapped->data.size(), 0x10u);
+    EXPECT_EQ(mapped->data[0], 0x10);
+}
+
+} // namespace
+} // namespace emu::package::test
@@ -0,0 +1,89 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "emu_core/package/package_builder_zip.hpp"
+#include "emu_core/package/package_zip.hpp"
+#include <filesystem>
+#include <numeric>
+#include <unistd.h>
+
+namespace emu::package::test {
+namespace {
+
+using namespace ::testing;
+using namespace std::string_literals;
+
+class ZipPackageTest : public testing::Test {
+public:
+    std::string path = (std::filesystem::temp_directory_path() /
+                        fmt::format("emu_zip_package_test_{}{}", ::getpid(),
+                                    kEmuImageExtension))
+                           .string();
+    ByteVector image = ByteVector(0x1000);
+
+    void SetUp() override {
+        std::iota(image.begin(), image.end(), uint8_t{0});
+
+        MemoryConfig config;
+        config.entries.emplace_back(MemoryConfigEntry{
+            .name = "low",
+            .offset = 0,
+            .entry_variant =
+                MemoryConfigEntry::RamArea{
+                    .image = MemoryConfigEntry::RamArea::Image{.file = "image.bin"},
+                    .size = 0x100,
+                    .writable = true,
+                },
+        });
+        config.entries.emplace_back(MemoryConfigEntry{
+            .name = "high",
+            .offset = 0xF000,
+            .entry_variant =
+                MemoryConfigEntry::RamArea{
+                    .image =
+                        MemoryConfigEntry::RamArea::Image{
+                            .file = "image.bin",
+                            .offset = 0xF00,
+                        },
+                    .size = 0x100,
+                    .writable = false,
+                },
+        });
+
+        ZipPackageBuilder builder{path};
+        builder.SetMemoryConfig(config);
+        builder.AddFile(image, "image.bin");
+        builder.AddFile(image, "other.bin");
+        builder.Finish();
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    ByteVector Slice(size_t offset, size_t length) {
+        return ByteVector{image.begin() + static_cast<std::ptrdiff_t>(offset),
+                          image.begin() + static_cast<std::ptrdiff_t>(offset + length)};
+    }
+};
+
+TEST_F(ZipPackageTest, PartialRead) {
+    ZipPackage package{path};
+    EXPECT_EQ(package.LoadFile("other.bin"), image);
+    EXPECT_EQ(package.LoadFile("other.bin", 0x10, 0x20), Slice(0x10, 0x20));
+    EXPECT_EQ(package.LoadFile("other.bin", 0xFF0, 0x100), Slice(0xFF0, 0x10));
+    EXPECT_TRUE(package.LoadFile("other.bin", 0x2000, 0x10).empty());
+}
+
+TEST_F(ZipPackageTest, SharedEntry) {
+    ZipPackage package{path};
+    EXPECT_EQ(package.LoadMemoryConfig().entries.size(), 2);
+    EXPECT_EQ(package.LoadFile("image.bin", 0, 0x100), Slice(0, 0x100));
+    EXPECT_EQ(package.LoadFile("image.bin", 0xF00, 0x100), Slice(0xF00, 0x100));
+}
+
+TEST_F(ZipPackageTest, MissingEntry) {
+    ZipPackage package{path};
+    EXPECT_THROW((void)package.LoadFile("missing.bin"), std::runtime_error);
+}
+
+} // namespace
+} // namespace emu::package::test
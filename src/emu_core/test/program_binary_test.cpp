@@ -0,0 +1,60 @@
+#include "emu_core/program.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace emu::test {
+namespace {
+
+Program MakeProgram() {
+    Program program;
+    program.sparse_binary_code.PutBytes(0x1000, {0x20, 0x00, 0x00, 0x60});
+    program.sparse_binary_code.PutBytes(0xFFFE, {0x01, 0x02});
+    program.AddAlias(ValueAlias{.name = "COUNT", .value = {0x10}});
+
+    auto defined = program.AddSymbol(SymbolInfo{.name = "MAIN", .offset = 0x1000_addr});
+    auto imported = program.AddSymbol(SymbolInfo{.name = "FUNC", .imported = true});
+    program.AddSymbol(SymbolInfo{
+        .name = "DEVICE",
+        .offset = uint8_t{0x20},
+        .segment = Segment::AbsoluteAddress,
+        .imported = true,
+    });
+
+    program.relocations.push_back(RelocationInfo{
+        .target_symbol = imported, .position = 0x1001, .mode = RelocationMode::Absolute});
+    program.relocations.push_back(RelocationInfo{
+        .target_symbol = defined, .position = 0xFFFE, .mode = RelocationMode::Absolute});
+    return program;
+}
+
+TEST(ProgramBinaryTest, RoundTrip) {
+    auto program = MakeProgram();
+    auto data = StoreProgramToBinary(program);
+    auto loaded = LoadProgramFromBinary(data);
+
+    EXPECT_EQ(program, loaded);
+    ASSERT_NE(loaded.FindAlias("COUNT"), nullptr);
+    EXPECT_EQ(loaded.FindAlias("COUNT")->value, ByteVector{0x10});
+    ASSERT_NE(loaded.FindSymbol("DEVICE"), nullptr);
+    EXPECT_EQ(loaded.FindSymbol("DEVICE")->segment, Segment::AbsoluteAddress);
+    for (auto &relocation : loaded.relocations) {
+        ASSERT_LT(relocation.target_symbol, loaded.symbols.size());
+        auto &symbol = loaded.Target(relocation);
+        EXPECT_EQ(loaded.FindSymbol(symbol.name), &symbol);
+    }
+    EXPECT_EQ(StoreProgramToBinary(loaded), data);
+}
+
+TEST(ProgramBinaryTest, Malformed) {
+    auto data = StoreProgramToBinary(MakeProgram());
+    EXPECT_THROW(LoadProgramFromBinary({}), std::runtime_error);
+    for (size_t size = 1; size < data.size(); ++size) {
+        EXPECT_THROW(LoadProgramFromBinary(std::span(data).first(size)), std::runtime_error)
+            << size;
+    }
+    data.push_back(0);
+    EXPECT_THROW(LoadProgramFromBinary(data), std::runtime_error);
+}
+
+} // namespace
+} // namespace emu::test
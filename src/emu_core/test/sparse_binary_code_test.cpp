@@ -0,0 +1,64 @@
+#include "emu_core/program.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace emu::test {
+namespace {
+
+using Ranges = SparseBinaryCode::RangeMap;
+
+TEST(SparseBinaryCodeTest, MergesAdjacentRuns) {
+    SparseBinaryCode code;
+    code.PutBytes(0x1003, {4, 5});
+    code.PutBytes(0x1000, {1, 2});
+    code.PutBytes(0x2000, {9});
+    EXPECT_EQ(code.Ranges(), (Ranges{{0x1000, {1, 2}}, {0x1003, {4, 5}}, {0x2000, {9}}}));
+
+    code.PutByte(0x1002, 3);
+    EXPECT_EQ(code.Ranges(), (Ranges{{0x1000, {1, 2, 3, 4, 5}}, {0x2000, {9}}}));
+    EXPECT_EQ(code.ByteCount(), 6u);
+    EXPECT_EQ(code.CodeRange(), (std::pair<Address_t, Address_t>{0x1000, 0x2000}));
+    EXPECT_EQ(code, SparseBinaryCode({{0x2000, 9}, {0x1000, 1}, {0x1001, 2}, {0x1002, 3},
+                                      {0x1003, 4}, {0x1004, 5}}));
+}
+
+TEST(SparseBinaryCodeTest, Overlap) {
+    SparseBinaryCode code{0x1000, {1, 2, 3}};
+    EXPECT_THROW(code.PutBytes(0x0FFE, {0, 0, 0}), std::runtime_error);
+    EXPECT_THROW(code.PutBytes(0xFFFF, {0, 0}), std::runtime_error);
+    EXPECT_EQ(code.FindOccupied(0x0F00, 0x100), std::nullopt);
+    EXPECT_EQ(code.FindOccupied(0x0F00, 0x101), 0x1000);
+    EXPECT_EQ(code.FindOccupied(0x1002, 10), 0x1002);
+
+    code.PutBytes(0x0FFF, {0, 9, 9, 9, 5}, true);
+    EXPECT_EQ(code.Ranges(), (Ranges{{0x0FFF, {0, 9, 9, 9, 5}}}));
+}
+
+TEST(SparseBinaryCodeTest, ReadAndErase) {
+    SparseBinaryCode code{0x1000, {1, 2, 3, 4, 5}};
+    EXPECT_EQ(code.ReadBytes(0x1001, 3), (ByteVector{2, 3, 4}));
+    EXPECT_THROW((void)code.ReadBytes(0x1003, 3), std::out_of_range);
+    EXPECT_THROW((void)code.At(0x1005), std::out_of_range);
+
+    code.Erase(0x1001, 2);
+    EXPECT_EQ(code.Ranges(), (Ranges{{0x1000, {1}}, {0x1003, {4, 5}}}));
+    EXPECT_EQ(code.Get(0x1002), std::nullopt);
+    EXPECT_EQ(code.Get(0x1003), 4);
+    code.Erase(0x0F00, 0x104);
+    EXPECT_EQ(code.Ranges(), (Ranges{{0x1004, {5}}}));
+}
+
+TEST(SparseBinaryCodeTest, Dumps) {
+    SparseBinaryCode code{{0x000F, 0xAA}, {0x0010, 0xBB}, {0x0012, 0xCC}, {0x0100, 0xDD}};
+    EXPECT_EQ(code.HexDump(">"),
+              ">0000 | -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- aa\n"
+              ">0010 | bb -- cc -- -- -- -- -- -- -- -- -- -- -- -- --\n"
+              ">0100 | dd -- -- -- -- -- -- -- -- -- -- -- -- -- -- --\n");
+    auto memory = code.DumpMemory();
+    ASSERT_EQ(memory.size(), 0x10000u);
+    EXPECT_EQ(memory[0x0012], 0xCC);
+    EXPECT_EQ(memory[0x0011], 0);
+}
+
+} // namespace
+} // namespace emu::test
@@ -103,6 +103,7 @@ TEST_P(FunctionalTest, ) {
     std::cout << fmt::format("Cpu cycles: {} ({:.3f} Hz)\n", result->cpu_cycles,
                              static_cast<double>(result->cpu_cycles) / result->duration);
 
+    EXPECT_EQ(result->stop_reason, EmuSimulation::StopReason::kHalt);
     EXPECT_EQ(result->halt_code.value_or(0u), 0u);
 }
 
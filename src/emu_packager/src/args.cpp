@@ -3,6 +3,7 @@
 #include "emu_core/clock.hpp"
 #include "emu_core/file_search.hpp"
 #include "emu_core/package/package_builder.hpp"
+#include "emu_core/package/package_builder_mapped.hpp"
 #include "emu_core/package/package_builder_zip.hpp"
 #include "emu_core/string_file.hpp"
 #include <boost/algorithm/string.hpp>
@@ -45,6 +46,7 @@ struct Options {
 
         out_options.add_options()
             ("output,o", po::value<std::string>()->required(), "Output file")
+            ("format", po::value<std::string>()->default_value("zip"), "Output format: zip or mapped (uncompressed, mmap-able)")
             ;
 
         // arg_positional_opt.add("arg", -1);
@@ -111,9 +113,20 @@ protected:
             throw std::runtime_error("Output is not specified");
         }
 
+        auto format = vm["format"].as<std::string>();
+        if (format == "zip") {
+            opts.format = PackageFormat::kZip;
+        } else if (format == "mapped") {
+            opts.format = PackageFormat::kMapped;
+        } else {
+            throw std::logic_error(fmt::format("Unknown package format '{}'", format));
+        }
+
+        auto extension = opts.format == PackageFormat::kZip ? kEmuImageExtension
+                                                             : kEmuMappedImageExtension;
         opts.output_path = vm["output"].as<std::string>();
-        if (!opts.output_path.ends_with(kEmuImageExtension)) {
-            opts.output_path += kEmuImageExtension;
+        if (!opts.output_path.ends_with(extension)) {
+            opts.output_path += extension;
         }
     }
 
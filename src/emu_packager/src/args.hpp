@@ -11,11 +11,17 @@
 
 namespace emu::packager {
 
+enum class PackageFormat {
+    kZip,
+    kMapped,
+};
+
 struct ExecArguments {
     std::ostream *verbose_stream = nullptr;
     MemoryConfig memory_options;
     StreamContainer streams;
     std::string output_path;
+    PackageFormat format = PackageFormat::kZip;
 };
 
 ExecArguments ParseComandline(int argc, char **argv);
@@ -1,8 +1,17 @@
 #include "runner.hpp"
+#include "emu_core/byte_utils.hpp"
 #include "emu_core/clock_steady.hpp"
 #include "emu_core/memory/memory_block.hpp"
+#include "emu_core/package/package_builder_mapped.hpp"
 #include "emu_core/package/package_builder_zip.hpp"
 #include "emu_core/string_file.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <tuple>
 
 namespace emu::packager {
 
@@ -11,16 +20,28 @@ int Runner::Pack(const ExecArguments &exec_args) {
 
     int code = 0;
 
-    package_builder = std::make_unique<package::ZipPackageBuilder>(exec_args.output_path);
+    switch (exec_args.format) {
+    case PackageFormat::kZip:
+        package_builder =
+            std::make_unique<package::ZipPackageBuilder>(exec_args.output_path);
+        break;
+    case PackageFormat::kMapped:
+        package_builder =
+            std::make_unique<package::MappedPackageBuilder>(exec_args.output_path);
+        break;
+    }
 
     auto memory_options = exec_args.memory_options;
 
+    image_refs.clear();
     for (auto &entry : memory_options.entries) {
         std::visit([this, &entry](auto &value) { HandleEntry(entry, value); },
                    entry.entry_variant);
     }
+    StoreImages();
 
     package_builder->SetMemoryConfig(memory_options);
+    package_builder->Finish();
     package_builder.reset();
 
     return code;
@@ -32,44 +53,124 @@ void Runner::HandleEntry(MemoryConfigEntry &entry, MemoryConfigEntry::RamArea &r
     }
 
     auto &image = *ra.image;
-    auto input = streams.OpenBinaryInput(image.file);
-    auto file_size = static_cast<uint64_t>(std::filesystem::file_size(image.file));
-    if (image.offset.has_value()) {
-        auto offset = image.offset.value();
-        input->seekg(static_cast<std::streamsize>(offset), std::ios::beg);
-        if (offset > file_size) {
-            file_size = 0;
-        } else {
-            file_size -= offset;
-        }
+    if (!std::filesystem::is_regular_file(image.file)) {
+        throw std::runtime_error(fmt::format("Cannot open image file {}", image.file));
     }
 
+    auto file_size = static_cast<uint64_t>(std::filesystem::file_size(image.file));
+    auto offset = std::min(image.offset.value_or(0), file_size);
+    auto size = file_size - offset;
     if (ra.size.has_value()) {
-        file_size = std::min(file_size, ra.size.value());
+        size = std::min(size, ra.size.value());
     }
-    ra.size = file_size;
 
-    auto file_name = fmt::format("{:04x}_{:04x}", entry.offset, file_size);
+    image_refs.emplace_back(ImageRef{
+        .ram_area = &ra,
+        .source = std::filesystem::weakly_canonical(image.file).string(),
+        .begin = offset,
+        .size = size,
+    });
+}
+
+void Runner::HandleEntry(MemoryConfigEntry &entry, MemoryConfigEntry::MappedDevice &md) {
+    // nothing
+}
 
-    if (!entry.name.empty()) {
-        file_name += "_" + entry.name;
+std::vector<Runner::Segment> Runner::PlanSegments() {
+    std::vector<ImageRef *> sorted;
+    for (auto &ref : image_refs) {
+        sorted.emplace_back(&ref);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](auto *a, auto *b) {
+        return std::tie(a->source, a->begin) < std::tie(b->source, b->begin);
+    });
+
+    // Overlapping or adjacent ranges of the same source are stored as single blob
+    std::vector<Segment> segments;
+    for (auto *ref : sorted) {
+        if (!segments.empty()) {
+            auto &last = segments.back();
+            auto last_end = last.begin + last.size;
+            if (last.source == ref->source && ref->begin <= last_end) {
+                last.size = std::max(last_end, ref->begin + ref->size) - last.begin;
+                last.refs.emplace_back(ref);
+                continue;
+            }
+        }
+        segments.emplace_back(Segment{
+            .source = ref->source,
+            .begin = ref->begin,
+            .size = ref->size,
+            .refs = {ref},
+        });
     }
+    return segments;
+}
 
-    file_name += ".bin";
+Runner::Blob Runner::LoadBlob(const Segment &segment) {
+    std::ifstream input(segment.source, std::ios::binary);
+    input.seekg(static_cast<std::streamoff>(segment.begin), std::ios::beg);
+
+    Blob blob;
+    blob.data.resize(segment.size);
+    input.read(reinterpret_cast<char *>(blob.data.data()),
+               static_cast<std::streamsize>(segment.size));
+    if (!input) {
+        throw std::runtime_error(
+            fmt::format("Failed to read {} bytes at {:#x} from {}", segment.size,
+                        segment.begin, segment.source));
+    }
+    blob.hash = Fnv1aHash(blob.data);
+    return blob;
+}
 
-    package::ByteVector data(file_size, '\0');
-    input->read(reinterpret_cast<char *>(&data[0]),
-                static_cast<std::streamsize>(file_size));
+std::string Runner::StoreBlob(Blob blob) {
+    auto [begin, end] = stored_blob_index.equal_range(blob.hash);
+    for (auto it = begin; it != end; ++it) {
+        auto &[name, stored] = stored_blobs[it->second];
+        if (stored.data == blob.data) {
+            return name;
+        }
+    }
 
-    image = MemoryConfigEntry::RamArea::Image{
-        .file = file_name,
-        .offset = 0,
-    };
-    package_builder->AddFile(data, file_name);
+    auto collisions = std::distance(begin, end);
+    auto name = collisions == 0 ? fmt::format("{:016x}.bin", blob.hash)
+                                : fmt::format("{:016x}_{}.bin", blob.hash, collisions);
+    package_builder->AddFile(blob.data, name);
+
+    stored_blob_index.emplace(blob.hash, stored_blobs.size());
+    stored_blobs.emplace_back(name, std::move(blob));
+    return name;
 }
 
-void Runner::HandleEntry(MemoryConfigEntry &entry, MemoryConfigEntry::MappedDevice &md) {
-    // nothing
+void Runner::StoreImages() {
+    stored_blobs.clear();
+    stored_blob_index.clear();
+
+    auto segments = PlanSegments();
+
+    std::vector<std::future<Blob>> pending;
+    for (auto &segment : segments) {
+        auto policy = segment.size >= kParallelBlobThreshold ? std::launch::async
+                                                             : std::launch::deferred;
+        pending.emplace_back(std::async(policy, &Runner::LoadBlob, std::cref(segment)));
+    }
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        auto name = StoreBlob(pending[i].get());
+        for (auto *ref : segments[i].refs) {
+            ref->ram_area->image = MemoryConfigEntry::RamArea::Image{
+                .file = name,
+                .offset = ref->begin - segments[i].begin,
+            };
+            ref->ram_area->size = ref->size;
+        }
+    }
+
+    if (verbose_stream != nullptr) {
+        (*verbose_stream) << fmt::format("Stored {} blobs for {} images\n",
+                                         stored_blobs.size(), image_refs.size());
+    }
 }
 
 } // namespace emu::packager
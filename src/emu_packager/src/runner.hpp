@@ -5,26 +5,60 @@
 #include "emu_core/device_factory.hpp"
 #include "emu_core/memory_configuration_file.hpp"
 #include "emu_core/package/package_builder.hpp"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
 namespace emu::packager {
 
 struct Runner {
+    // Blobs larger than this are loaded and hashed on a separate thread
+    static constexpr uint64_t kParallelBlobThreshold = 64 * 1024;
+
     Runner() {}
     int Pack(const ExecArguments &exec_args);
 
 protected:
+    // Range of a source file referenced by a single RamArea
+    struct ImageRef {
+        MemoryConfigEntry::RamArea *ram_area;
+        std::string source;
+        uint64_t begin;
+        uint64_t size;
+    };
+
+    // Merged range of a source file covering one or more ImageRefs
+    struct Segment {
+        std::string source;
+        uint64_t begin;
+        uint64_t size;
+        std::vector<ImageRef *> refs;
+    };
+
+    struct Blob {
+        package::ByteVector data;
+        uint64_t hash;
+    };
+
     std::ostream *verbose_stream = nullptr;
-    StreamContainer streams;
 
     std::unique_ptr<package::IPackageBuilder> package_builder;
 
+    std::vector<ImageRef> image_refs;
+    std::vector<std::pair<std::string, Blob>> stored_blobs;
+    std::unordered_multimap<uint64_t, size_t> stored_blob_index;
+
     void HandleEntry(MemoryConfigEntry &entry, MemoryConfigEntry::RamArea &ra);
     void HandleEntry(MemoryConfigEntry &entry, MemoryConfigEntry::MappedDevice &md);
+
+    std::vector<Segment> PlanSegments();
+    static Blob LoadBlob(const Segment &segment);
+    std::string StoreBlob(Blob blob);
+    void StoreImages();
 };
 
 } // namespace emu::packager
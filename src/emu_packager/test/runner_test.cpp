@@ -0,0 +1,134 @@
+#include "emu_core/package/package_mapped.hpp"
+#include "runner.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <sstream>
+#include <unistd.h>
+
+namespace emu::packager::test {
+namespace {
+
+namespace fs = std::filesystem;
+using package::ByteVector;
+
+struct TestRunner : public Runner {
+    using Runner::HandleEntry;
+    using Runner::PlanSegments;
+    using Runner::Segment;
+};
+
+class PackagerRunnerTest : public testing::Test {
+protected:
+    fs::path directory;
+    ByteVector data = ByteVector(0x3000);
+
+    void SetUp() override {
+        auto test = testing::UnitTest::GetInstance()->current_test_info();
+        directory = fs::temp_directory_path() /
+                    fmt::format("emu_packager_test_{}_{}", ::getpid(), test->name());
+        fs::create_directories(directory);
+        std::iota(data.begin(), data.end(), uint8_t{0});
+        Write("a.bin", data);
+        // Same content as overlapping ranges of a.bin
+        Write("b.bin", ByteVector(data.begin(), data.begin() + 0x1800));
+    }
+    void TearDown() override { fs::remove_all(directory); }
+
+    void Write(const std::string &name, const ByteVector &bytes) {
+        std::ofstream file(directory / name, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(bytes.data()),
+                   static_cast<std::streamsize>(bytes.size()));
+    }
+
+    MemoryConfig MakeConfig() {
+        MemoryConfig config;
+        auto add = [&](const std::string &file, uint64_t image_offset,
+                       std::optional<uint64_t> size) {
+            config.entries.emplace_back(MemoryConfigEntry{
+                .name = fmt::format("area{}", config.entries.size()),
+                .offset = config.entries.size() * 0x2000,
+                .entry_variant =
+                    MemoryConfigEntry::RamArea{
+                        .image =
+                            MemoryConfigEntry::RamArea::Image{
+                                .file = (directory / file).string(),
+                                .offset = image_offset,
+                            },
+                        .size = size,
+                        .writable = false,
+                    },
+            });
+        };
+        add("a.bin", 0x2000, 0x800);
+        add("a.bin", 0x800, 0x1000);
+        add("a.bin", 0, 0x1000);
+        add("b.bin", 0, std::nullopt);
+        return config;
+    }
+
+    static const MemoryConfigEntry::RamArea &GetRamArea(const MemoryConfig &config,
+                                                        size_t index) {
+        return std::get<MemoryConfigEntry::RamArea>(config.entries[index].entry_variant);
+    }
+};
+
+TEST_F(PackagerRunnerTest, SegmentLayout) {
+    auto config = MakeConfig();
+    TestRunner runner;
+    for (auto &entry : config.entries) {
+        std::visit([&](auto &value) { runner.HandleEntry(entry, value); },
+                   entry.entry_variant);
+    }
+
+    auto segments = runner.PlanSegments();
+    ASSERT_EQ(segments.size(), 3u);
+    auto a = fs::weakly_canonical(directory / "a.bin").string();
+    auto b = fs::weakly_canonical(directory / "b.bin").string();
+    std::vector<std::tuple<std::string, uint64_t, uint64_t, size_t>> layout;
+    for (auto &segment : segments) {
+        layout.emplace_back(segment.source, segment.begin, segment.size,
+                            segment.refs.size());
+    }
+    EXPECT_EQ(layout, (decltype(layout){
+                          {a, 0, 0x1800, 2},
+                          {a, 0x2000, 0x800, 1},
+                          {b, 0, 0x1800, 1},
+                      }));
+}
+
+TEST_F(PackagerRunnerTest, DuplicateBlob) {
+    std::stringstream verbose;
+    ExecArguments args;
+    args.verbose_stream = &verbose;
+    args.memory_options = MakeConfig();
+    args.output_path = (directory / "out.emu_mapped").string();
+    args.format = PackageFormat::kMapped;
+
+    Runner runner;
+    ASSERT_EQ(runner.Pack(args), 0);
+    EXPECT_EQ(verbose.str(), "Stored 2 blobs for 4 images\n");
+
+    package::MappedPackage package{args.output_path};
+    auto config = package.LoadMemoryConfig();
+    ASSERT_EQ(config.entries.size(), 4u);
+    auto &shared = GetRamArea(config, 2).image->file;
+    EXPECT_EQ(GetRamArea(config, 1).image->file, shared);
+    EXPECT_EQ(GetRamArea(config, 3).image->file, shared);
+    EXPECT_NE(GetRamArea(config, 0).image->file, shared);
+    EXPECT_EQ(package.FileSize(shared), 0x1800u);
+
+    for (size_t i = 0; i < config.entries.size(); ++i) {
+        auto &ra = GetRamArea(config, i);
+        auto &original = GetRamArea(args.memory_options, i);
+        auto begin =
+            data.begin() + static_cast<ptrdiff_t>(original.image->offset.value());
+        EXPECT_EQ(package.LoadFile(ra.image->file, ra.image->offset, ra.size),
+                  ByteVector(begin, begin + static_cast<ptrdiff_t>(*ra.size)))
+            << "area " << i;
+    }
+}
+
+} // namespace
+} // namespace emu::packager::test
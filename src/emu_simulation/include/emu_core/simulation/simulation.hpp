@@ -34,9 +34,17 @@ struct EmuSimulation {
           debugger(std::move(_debugger)), devices(std::move(_devices)),
           mapped_devices(std::move(_mapped_devices)) {}
 
+    enum class StopReason {
+        kHalt,
+        kTimeout,
+        kWatchdog,
+    };
+
     struct Result {
+        StopReason stop_reason = StopReason::kTimeout;
         double duration;
         uint64_t cpu_cycles;
+        uint64_t cpu_instructions;
         std::optional<uint8_t> halt_code;
     };
 
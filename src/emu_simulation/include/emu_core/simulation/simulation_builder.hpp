@@ -43,9 +43,18 @@ struct SimulationBuildCpuConfig {
     emu6502::InstructionSet instruction_set;
 };
 
+struct SimulationBuildMemoryConfig {
+    // Ram images are read from package on first access to each page.
+    // Package must outlive the simulation.
+    bool lazy_images = false;
+    // Remaining pages of lazy images are read by background thread
+    bool prefetch_images = false;
+};
+
 std::unique_ptr<EmuSimulation>
 BuildEmuSimulation(std::shared_ptr<DeviceFactory> device_factory,
                    package::IPackage *package, const SimulationBuildCpuConfig &cpu_config,
-                   const SimulationBuildVerboseConfig &vc = {});
+                   const SimulationBuildVerboseConfig &vc = {},
+                   const SimulationBuildMemoryConfig &mc = {});
 
 } // namespace emu
@@ -15,6 +15,7 @@ EmuSimulation::Result EmuSimulation::Run(std::chrono::nanoseconds timeout) {
                 std::chrono::duration_cast<std::chrono::microseconds>(end - start);
             result.duration = static_cast<double>(delta.count()) / 1.0e6;
             result.cpu_cycles = clock->CurrentCycle();
+            result.cpu_instructions = clock->RetiredInstructions();
         };
 
         clock->Reset();
@@ -25,7 +26,10 @@ EmuSimulation::Result EmuSimulation::Run(std::chrono::nanoseconds timeout) {
             cpu->Execute();
         }
     } catch (const emu6502::cpu::ExecutionHalted &e) {
+        result.stop_reason = StopReason::kHalt;
         result.halt_code = e.halt_code;
+    } catch (const emu6502::cpu::WatchdogExpired &e) {
+        result.stop_reason = StopReason::kWatchdog;
     } catch (const std::exception &e) {
         throw SimulationFailedException(fmt::format("{}: {}", typeid(e).name(), e.what()),
                                         std::current_exception(), result);
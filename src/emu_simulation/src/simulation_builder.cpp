@@ -2,13 +2,18 @@
 #include "emu_6502/cpu/verbose_debugger.hpp"
 #include "emu_core/clock_steady.hpp"
 #include "emu_core/memory/memory_block.hpp"
+#include "emu_core/memory/memory_lazy.hpp"
+#include "emu_core/memory/memory_view.hpp"
+#include "emu_core/memory_map_planner.hpp"
 #include "emu_core/string_file.hpp"
+#include <algorithm>
 
 namespace emu {
 
 struct BuilderState {
     std::shared_ptr<DeviceFactory> device_factory;
     SimulationBuildVerboseConfig verbose;
+    SimulationBuildMemoryConfig memory_config;
     package::IPackage *package = nullptr;
 
     std::unique_ptr<Clock> clock;
@@ -47,20 +52,150 @@ struct BuilderState {
     }
 
     void InitMemory() {
-        for (auto &dev : package->LoadMemoryConfig().entries) {
-            auto [device_ptr, size] =
-                std::visit([&](auto &item) { return CreateMemoryDevice(dev.name, item); },
-                           dev.entry_variant);
-            if (device_ptr != nullptr) {
-                memory->MapArea(static_cast<uint16_t>(dev.offset),
-                                static_cast<uint16_t>(size), device_ptr.get());
-                mapped_devices.emplace_back(std::move(device_ptr));
+        auto config = package->LoadMemoryConfig();
+        auto plan = PlanMemoryMap(config);
+        if (verbose.memory_mapper != nullptr) {
+            plan.Describe(*verbose.memory_mapper);
+        }
+
+        for (auto &area : plan.areas) {
+            if (!area.IsMerged()) {
+                MapDevice(area.offset, CreateMemoryDevice(*area.parts[0].entry));
+            } else if (auto views = CreateMemoryViews(area); !views.empty()) {
+                // Mapped images are used in place, copying them into block is wasteful
+                for (size_t i = 0; i < views.size(); ++i) {
+                    MapDevice(area.offset + area.parts[i].offset, std::move(views[i]));
+                }
+            } else if (HasContiguousImages(area)) {
+                MapDevice(area.offset, CreateMergedRamArea(area));
+            } else {
+                // Shared block would map gaps after short images
+                for (auto &part : area.parts) {
+                    MapDevice(area.offset + part.offset, CreateMemoryDevice(*part.entry));
+                }
             }
         }
     }
 
     using MappedDevice = std::tuple<std::shared_ptr<Memory16>, size_t>;
 
+    void MapDevice(uint64_t offset, MappedDevice mapped) {
+        auto [device_ptr, size] = std::move(mapped);
+        if (device_ptr != nullptr && size > 0) {
+            memory->MapArea(static_cast<uint16_t>(offset), static_cast<uint16_t>(size),
+                            device_ptr.get());
+        }
+        if (device_ptr != nullptr) {
+            mapped_devices.emplace_back(std::move(device_ptr));
+        }
+    }
+
+    MappedDevice CreateMemoryDevice(const MemoryConfigEntry &entry) {
+        return std::visit(
+            [&](auto &item) { return CreateMemoryDevice(entry.name, item); },
+            entry.entry_variant);
+    }
+
+    static const MemoryConfigEntry::RamArea &GetRamArea(const MemoryMapPlan::Part &part) {
+        return std::get<MemoryConfigEntry::RamArea>(part.entry->entry_variant);
+    }
+
+    // Merged area maps the same addresses as its parts would, only when images of all
+    // parts except the last one cover whole part
+    bool HasContiguousImages(const MemoryMapPlan::Area &area) const {
+        return std::all_of(area.parts.begin(), std::prev(area.parts.end()),
+                           [&](auto &part) {
+                               auto &ra = GetRamArea(part);
+                               return ImageSize(ra) == *ra.size;
+                           });
+    }
+
+    // Views of all part images, empty unless every part is read-only and mappable
+    std::vector<MappedDevice> CreateMemoryViews(const MemoryMapPlan::Area &area) {
+        std::vector<MappedDevice> views;
+        for (auto &part : area.parts) {
+            auto view = CreateMemoryView(GetRamArea(part));
+            if (!view.has_value()) {
+                return {};
+            }
+            views.emplace_back(std::move(*view));
+        }
+        return views;
+    }
+
+    std::optional<MappedDevice> CreateMemoryView(const MemoryConfigEntry::RamArea &ra) {
+        if (ra.writable || !ra.image.has_value()) {
+            return std::nullopt;
+        }
+        auto mapped = package->MapFile(ra.image->file, ra.image->offset, ra.size);
+        if (!mapped.has_value()) {
+            return std::nullopt;
+        }
+        const auto size = mapped->data.size();
+        return MappedDevice{
+            std::make_shared<memory::MemoryView16>(clock.get(), mapped->data,
+                                                   std::move(mapped->owner),
+                                                   verbose.memory),
+            size,
+        };
+    }
+
+    // Adjacent ram areas share single block, each part is initialized from its image
+    MappedDevice CreateMergedRamArea(const MemoryMapPlan::Area &area) {
+        // Lazy loader outlives the memory config, parts are copied
+        std::vector<std::pair<uint64_t, MemoryConfigEntry::RamArea>> parts;
+        for (auto &part : area.parts) {
+            parts.emplace_back(part.offset, GetRamArea(part));
+        }
+        auto loader = [package = package, parts = std::move(parts)](size_t offset,
+                                                                    size_t length) {
+            std::vector<uint8_t> bytes(length, 0);
+            for (auto &[part_offset, ra] : parts) {
+                auto begin = std::max<uint64_t>(offset, part_offset);
+                auto end = std::min<uint64_t>(offset + length, part_offset + *ra.size);
+                if (!ra.image.has_value() || begin >= end) {
+                    continue;
+                }
+                auto data = package->LoadFile(
+                    ra.image->file, ra.image->offset.value_or(0) + (begin - part_offset),
+                    end - begin);
+                std::copy_n(data.begin(), std::min<size_t>(data.size(), end - begin),
+                            bytes.begin() + static_cast<ptrdiff_t>(begin - offset));
+            }
+            return bytes;
+        };
+
+        auto mode = GetRamArea(area.parts[0]).writable ? MemoryMode::kReadWrite
+                                                       : MemoryMode::kReadOnly;
+        auto &last = area.parts.back();
+        const auto size = static_cast<size_t>(last.offset) + ImageSize(GetRamArea(last));
+        if (memory_config.lazy_images) {
+            return {
+                std::make_shared<memory::MemoryLazy16>(clock.get(), size,
+                                                       std::move(loader), mode,
+                                                       memory_config.prefetch_images,
+                                                       verbose.memory),
+                size,
+            };
+        }
+        return {
+            std::make_shared<memory::MemoryBlock16>(clock.get(), loader(0, size), mode,
+                                                    verbose.memory),
+            size,
+        };
+    }
+
+    // Ram area is mapped as far as its image reaches, up to its size
+    size_t ImageSize(const MemoryConfigEntry::RamArea &ra) const {
+        if (!ra.image.has_value()) {
+            return 0;
+        }
+        auto file_size = package->FileSize(ra.image->file);
+        auto available =
+            file_size - std::min<size_t>(ra.image->offset.value_or(0), file_size);
+        return ra.size.has_value() ? std::min<size_t>(available, *ra.size) : available;
+    }
+
     MappedDevice CreateMemoryDevice(std::string name,
                                     const MemoryConfigEntry::MappedDevice &md) {
         auto device = device_factory->CreateDevice(name, md, clock.get(), verbose.device);
@@ -70,7 +205,27 @@ struct BuilderState {
 
     MappedDevice CreateMemoryDevice(std::string name,
                                     const MemoryConfigEntry::RamArea &ra) {
+        if (auto view = CreateMemoryView(ra); view.has_value()) {
+            return std::move(*view);
+        }
+
         auto mode = ra.writable ? MemoryMode::kReadWrite : MemoryMode::kReadOnly;
+        if (memory_config.lazy_images && ra.image.has_value() && ra.size.has_value()) {
+            auto loader = [package = package, image = *ra.image](size_t offset,
+                                                                 size_t length) {
+                return package->LoadFile(image.file, image.offset.value_or(0) + offset,
+                                         length);
+            };
+            const auto size = ImageSize(ra);
+            return {
+                std::make_shared<memory::MemoryLazy16>(clock.get(), size,
+                                                       std::move(loader), mode,
+                                                       memory_config.prefetch_images,
+                                                       verbose.memory),
+                size,
+            };
+        }
+
         std::vector<uint8_t> bytes;
         if (ra.image.has_value()) {
             bytes = package->LoadFile(ra.image->file, ra.image->offset, ra.size);
@@ -87,9 +242,11 @@ struct BuilderState {
 std::unique_ptr<EmuSimulation>
 BuildEmuSimulation(std::shared_ptr<DeviceFactory> device_factory,
                    package::IPackage *package, const SimulationBuildCpuConfig &cpu_config,
-                   const SimulationBuildVerboseConfig &vc) {
+                   const SimulationBuildVerboseConfig &vc,
+                   const SimulationBuildMemoryConfig &mc) {
     BuilderState state;
     state.verbose = vc;
+    state.memory_config = mc;
     state.package = package;
     state.device_factory = device_factory;
 
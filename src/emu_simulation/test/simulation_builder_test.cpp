@@ -0,0 +1,129 @@
+#include "emu_core/memory/memory_view.hpp"
+#include "emu_core/package/package_builder_mapped.hpp"
+#include "emu_core/package/package_mapped.hpp"
+#include "emu_core/package/package_memory.hpp"
+#include "emu_core/simulation/simulation_builder.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <unistd.h>
+
+namespace emu::test {
+namespace {
+
+using RamArea = MemoryConfigEntry::RamArea;
+using package::ByteVector;
+
+class SimulationBuilderTest : public testing::Test {
+protected:
+    MemoryConfig config;
+    std::map<std::string, ByteVector> files;
+
+    void AddRamArea(uint64_t offset, uint64_t size, std::optional<size_t> image_size,
+                    bool writable = true) {
+        RamArea ra{.size = size, .writable = writable};
+        if (image_size.has_value()) {
+            auto name = fmt::format("image_{:04x}.bin", offset);
+            ByteVector image(*image_size);
+            std::iota(image.begin(), image.end(), static_cast<uint8_t>(offset >> 8));
+            files[name] = std::move(image);
+            ra.image = RamArea::Image{.file = name};
+        }
+        config.entries.emplace_back(MemoryConfigEntry{
+            .name = fmt::format("ram_{:04x}", offset),
+            .offset = offset,
+            .entry_variant = ra,
+        });
+    }
+
+    // Value of each address in the address space, nullopt when not mapped
+    std::vector<std::optional<uint8_t>> Build(const MemoryConfig &memory_config,
+                                              bool lazy) {
+        package::MemoryPackage package{memory_config};
+        for (auto &[name, data] : files) {
+            package.AddFile(name, data);
+        }
+        auto simulation =
+            BuildEmuSimulation(nullptr, &package, {0, emu6502::InstructionSet::NMOS6502},
+                               {}, {.lazy_images = lazy});
+        std::vector<std::optional<uint8_t>> result;
+        for (uint32_t address = 0; address <= 0xFFFF; ++address) {
+            auto value = simulation->memory->DebugRead(static_cast<uint16_t>(address));
+            result.push_back(value);
+        }
+        return result;
+    }
+};
+
+TEST_F(SimulationBuilderTest, LazyImagesMapSameRange) {
+    AddRamArea(0x1000, 0x1000, 0x800);
+    AddRamArea(0x4000, 0x1000, 0x1000);
+    auto eager = Build(config, false);
+    EXPECT_EQ(eager[0x1000], 0x10);
+    EXPECT_EQ(eager[0x1800], std::nullopt);
+    EXPECT_EQ(Build(config, true), eager);
+}
+
+TEST_F(SimulationBuilderTest, MergedAreasMapSameRange) {
+    AddRamArea(0x1000, 0x1000, 0x1000);
+    AddRamArea(0x2000, 0x1000, 0x800);
+    AddRamArea(0x3000, 0x1000, 0x1000);
+    AddRamArea(0x4000, 0x1000, 0x400);
+    AddRamArea(0x5000, 0x100, std::nullopt);
+    // Only image of the last area is shorter, areas share single block
+    AddRamArea(0x6000, 0x1000, 0x1000);
+    AddRamArea(0x7000, 0x1000, 0x600);
+
+    // Areas placed apart are never merged
+    MemoryConfig separate = config;
+    for (auto &entry : separate.entries) {
+        entry.offset *= 2;
+    }
+    auto unmerged = Build(separate, false);
+
+    for (auto lazy : {false, true}) {
+        auto merged = Build(config, lazy);
+        for (auto &entry : config.entries) {
+            auto size = *std::get<RamArea>(entry.entry_variant).size;
+            for (uint64_t i = 0; i < size; ++i) {
+                ASSERT_EQ(merged[entry.offset + i], unmerged[entry.offset * 2 + i])
+                    << fmt::format("{:04x} lazy:{}", entry.offset + i, lazy);
+            }
+        }
+    }
+}
+
+TEST_F(SimulationBuilderTest, AdjacentMappedImagesAreViews) {
+    AddRamArea(0xE000, 0x1000, 0x1000, false);
+    AddRamArea(0xF000, 0x1000, 0x1000, false);
+
+    auto test = testing::UnitTest::GetInstance()->current_test_info();
+    auto path = std::filesystem::temp_directory_path() /
+                fmt::format("emu_simulation_test_{}_{}{}", ::getpid(), test->name(),
+                            package::kEmuMappedImageExtension);
+    {
+        package::MappedPackageBuilder builder{path.string()};
+        for (auto &[name, data] : files) {
+            builder.AddFile(data, name);
+        }
+        builder.SetMemoryConfig(config);
+        builder.Finish();
+    }
+
+    for (auto lazy : {false, true}) {
+        package::MappedPackage package{path.string()};
+        auto simulation =
+            BuildEmuSimulation(nullptr, &package, {0, emu6502::InstructionSet::NMOS6502},
+                               {}, {.lazy_images = lazy});
+        ASSERT_EQ(simulation->mapped_devices.size(), 2u);
+        for (auto &device : simulation->mapped_devices) {
+            EXPECT_NE(std::dynamic_pointer_cast<memory::MemoryView16>(device), nullptr);
+        }
+        EXPECT_EQ(simulation->memory->DebugRead(0xE001), 0xE1);
+        EXPECT_EQ(simulation->memory->DebugRead(0xF001), 0xF1);
+    }
+    std::filesystem::remove(path);
+}
+
+} // namespace
+} // namespace emu::test
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "emu/module/perf/perf_counter_device.hpp"
+#include "emu_core/device_factory.hpp"
+#include <cstdint>
+
+namespace emu::module::perf {
+
+struct PerfCounterDeviceInstance : public Device,
+                                   std::enable_shared_from_this<PerfCounterDeviceInstance> {
+    ~PerfCounterDeviceInstance() override = default;
+
+    std::shared_ptr<Memory16> GetMemory() override { return device; }
+    size_t GetMemorySize() override { return PerfCounterDevice::kDeviceMemorySize; };
+    std::shared_ptr<PerfCounterDevice> device;
+};
+
+struct PerfCounterDeviceFactory : public DeviceFactory {
+    PerfCounterDeviceFactory() = default;
+    ~PerfCounterDeviceFactory() override = default;
+
+    std::shared_ptr<Device> CreateDevice(const std::string &name,
+                                         const MemoryConfigEntry::MappedDevice &md,
+                                         Clock *clock,
+                                         std::ostream *verbose_output) const override {
+        auto instance = std::make_shared<PerfCounterDeviceInstance>();
+        auto running = md.GetConfigItem("running", false);
+        instance->device =
+            std::make_shared<PerfCounterDevice>(clock, running, verbose_output);
+        return instance;
+    }
+};
+
+} // namespace emu::module::perf
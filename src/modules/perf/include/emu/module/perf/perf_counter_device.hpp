@@ -0,0 +1,81 @@
+#pragma once
+
+#include "emu_core/clock.hpp"
+#include "emu_core/memory.hpp"
+#include <cstdint>
+#include <iostream>
+
+namespace emu::module::perf {
+
+// Cycle and instruction counters. Counters accumulate only while running; values visible
+// to guest are latched on snapshot or stop, so multi byte reads are consistent.
+class PerfCounterDevice : public Memory16 {
+public:
+    using CounterReg = uint32_t;
+
+    enum class Register : Memory16::Address_t {
+        kControl,
+        kCycles0,
+        kCycles1,
+        kCycles2,
+        kCycles3,
+        kInstructions0,
+        kInstructions1,
+        kInstructions2,
+        kInstructions3,
+    };
+
+    enum ControlBits : uint8_t {
+        kRun = 1 << 0,
+        kSnapshot = 1 << 1,
+        kClear = 1 << 2,
+    };
+
+    static constexpr Memory16::Address_t kDeviceMemorySize = 1 + 2 * sizeof(CounterReg);
+
+    PerfCounterDevice(Clock *clock, bool running = false,
+                      std::ostream *verbose_output = nullptr);
+
+    [[nodiscard]] uint8_t Load(Address_t address) const override;
+    void Store(Address_t address, uint8_t value) override;
+
+    [[nodiscard]] std::optional<uint8_t> DebugRead(Address_t address) const override;
+
+    [[nodiscard]] uint8_t Load(Register address) const {
+        return Load(static_cast<Address_t>(address));
+    }
+    void Store(Register address, uint8_t value) {
+        Store(static_cast<Address_t>(address), value);
+    }
+
+    [[nodiscard]] uint64_t Cycles() const;
+    [[nodiscard]] uint64_t Instructions() const;
+
+private:
+    Clock *const clock;
+    std::ostream *const verbose_output;
+
+    bool running = false;
+    uint64_t accumulated_cycles = 0;
+    uint64_t accumulated_instructions = 0;
+    uint64_t start_cycle = 0;
+    uint64_t start_instruction = 0;
+
+    CounterReg latched_cycles = 0;
+    CounterReg latched_instructions = 0;
+
+    void Start();
+    void Stop();
+    void Snapshot();
+
+    [[nodiscard]] std::optional<uint8_t> ReadRegister(Address_t address) const;
+
+    [[noreturn]] void Error(const std::string &msg) const {
+        if (verbose_output != nullptr) {
+            (*verbose_output) << msg << "\n";
+        }
+        throw std::runtime_error(msg);
+    }
+};
+
+} // namespace emu::module::perf
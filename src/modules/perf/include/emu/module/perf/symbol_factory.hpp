@@ -0,0 +1,41 @@
+#pragma once
+
+#include "emu/module/perf/perf_counter_device.hpp"
+#include "emu_core/symbol_factory.hpp"
+#include <cstdint>
+#include <memory>
+
+using namespace std::string_literals;
+
+namespace emu::module::perf {
+
+struct PerfCounterDeviceSymbolFactory : public SymbolFactory {
+    PerfCounterDeviceSymbolFactory() = default;
+    ~PerfCounterDeviceSymbolFactory() override = default;
+
+    static constexpr auto kClassName = "PERF";
+
+    SymbolDefVector GetSymbols(const MemoryConfigEntry &entry,
+                               const MemoryConfigEntry::MappedDevice &md) const override {
+        auto base = entry.offset;
+        SymbolDefVectorBuilder r{kClassName, entry.name};
+        using Reg = PerfCounterDevice::Register;
+        r.EmitSymbol("BASE_ADDRESS"s, base);
+        r.EmitSymbol("REGISTER_CONTROL"s, base, Reg::kControl);
+        r.EmitSymbol("REGISTER_CYCLES_0"s, base, Reg::kCycles0);
+        r.EmitSymbol("REGISTER_CYCLES_1"s, base, Reg::kCycles1);
+        r.EmitSymbol("REGISTER_CYCLES_2"s, base, Reg::kCycles2);
+        r.EmitSymbol("REGISTER_CYCLES_3"s, base, Reg::kCycles3);
+        r.EmitSymbol("REGISTER_INSTRUCTIONS_0"s, base, Reg::kInstructions0);
+        r.EmitSymbol("REGISTER_INSTRUCTIONS_1"s, base, Reg::kInstructions1);
+        r.EmitSymbol("REGISTER_INSTRUCTIONS_2"s, base, Reg::kInstructions2);
+        r.EmitSymbol("REGISTER_INSTRUCTIONS_3"s, base, Reg::kInstructions3);
+        r.EmitAlias("CONTROL_RUN"s, static_cast<uint8_t>(PerfCounterDevice::kRun));
+        r.EmitAlias("CONTROL_SNAPSHOT"s,
+                    static_cast<uint8_t>(PerfCounterDevice::kSnapshot));
+        r.EmitAlias("CONTROL_CLEAR"s, static_cast<uint8_t>(PerfCounterDevice::kClear));
+        return r.entries;
+    }
+};
+
+} // namespace emu::module::perf
@@ -0,0 +1,8 @@
+#include "emu/module/perf/device_factory.hpp"
+#include "emu/module/perf/symbol_factory.hpp"
+#include "emu_core/plugins/plugin.hpp"
+
+using namespace emu::module::perf;
+
+EMU_DEFINE_FACTORIES(PerfCounterDeviceFactory, PerfCounterDeviceSymbolFactory, default)
+EMU_DEFINE_FACTORIES(PerfCounterDeviceFactory, PerfCounterDeviceSymbolFactory, counter)
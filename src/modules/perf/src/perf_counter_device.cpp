@@ -0,0 +1,115 @@
+#include "emu/module/perf/perf_counter_device.hpp"
+#include <fmt/format.h>
+
+namespace emu::module::perf {
+
+namespace {
+
+uint8_t CounterByte(uint32_t v, size_t index) {
+    return static_cast<uint8_t>((v >> (index * 8)) & 0xFF);
+}
+
+} // namespace
+
+PerfCounterDevice::PerfCounterDevice(Clock *clock, bool running,
+                                     std::ostream *verbose_output)
+    : clock(clock), verbose_output(verbose_output) {
+    if (running) {
+        Start();
+    }
+}
+
+uint64_t PerfCounterDevice::Cycles() const {
+    auto r = accumulated_cycles;
+    if (running) {
+        r += clock->CurrentCycle() - start_cycle;
+    }
+    return r;
+}
+
+uint64_t PerfCounterDevice::Instructions() const {
+    auto r = accumulated_instructions;
+    if (running) {
+        r += clock->RetiredInstructions() - start_instruction;
+    }
+    return r;
+}
+
+void PerfCounterDevice::Start() {
+    if (running) {
+        return;
+    }
+    running = true;
+    start_cycle = clock->CurrentCycle();
+    start_instruction = clock->RetiredInstructions();
+}
+
+void PerfCounterDevice::Stop() {
+    if (!running) {
+        return;
+    }
+    accumulated_cycles = Cycles();
+    accumulated_instructions = Instructions();
+    running = false;
+}
+
+void PerfCounterDevice::Snapshot() {
+    latched_cycles = static_cast<CounterReg>(Cycles());
+    latched_instructions = static_cast<CounterReg>(Instructions());
+}
+
+std::optional<uint8_t> PerfCounterDevice::ReadRegister(Address_t address) const {
+    switch (static_cast<Register>(address)) {
+    case Register::kControl:
+        return static_cast<uint8_t>(running ? kRun : 0);
+    case Register::kCycles0:
+    case Register::kCycles1:
+    case Register::kCycles2:
+    case Register::kCycles3:
+        return CounterByte(latched_cycles,
+                           address - static_cast<Address_t>(Register::kCycles0));
+    case Register::kInstructions0:
+    case Register::kInstructions1:
+    case Register::kInstructions2:
+    case Register::kInstructions3:
+        return CounterByte(latched_instructions,
+                           address - static_cast<Address_t>(Register::kInstructions0));
+    }
+    return std::nullopt;
+}
+
+std::optional<uint8_t> PerfCounterDevice::DebugRead(Address_t address) const {
+    return ReadRegister(address);
+}
+
+uint8_t PerfCounterDevice::Load(Address_t address) const {
+    if (auto v = ReadRegister(address); v.has_value()) {
+        return *v;
+    }
+    Error(fmt::format("PerfCounterDevice: Attempt to read address {:04x}", address));
+}
+
+void PerfCounterDevice::Store(Address_t address, uint8_t value) {
+    if (static_cast<Register>(address) != Register::kControl) {
+        Error(fmt::format("PerfCounterDevice: Attempt to write address {:04x} with {:02x}",
+                          address, value));
+    }
+
+    if ((value & kClear) != 0) {
+        accumulated_cycles = 0;
+        accumulated_instructions = 0;
+        start_cycle = clock->CurrentCycle();
+        start_instruction = clock->RetiredInstructions();
+    }
+    if ((value & kRun) != 0) {
+        Start();
+    } else if (running) {
+        Stop();
+        Snapshot();
+    }
+    if ((value & kSnapshot) != 0) {
+        Snapshot();
+    }
+}
+
+} // namespace emu::module::perf
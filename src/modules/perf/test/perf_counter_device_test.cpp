@@ -0,0 +1,79 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "emu/module/perf/perf_counter_device.hpp"
+#include "emu_core/clock.hpp"
+
+namespace emu::module::perf::test {
+namespace {
+
+using namespace ::testing;
+
+class PerfCounterDeviceTest : public testing::Test {
+public:
+    using Register = PerfCounterDevice::Register;
+
+    ClockSimple clock;
+    PerfCounterDevice device{&clock};
+
+    void Execute(uint64_t instructions, uint64_t cycles_per_instruction) {
+        for (uint64_t i = 0; i < instructions; ++i) {
+            for (uint64_t c = 0; c < cycles_per_instruction; ++c) {
+                clock.WaitForNextCycle();
+            }
+            clock.RetireInstruction();
+        }
+    }
+
+    uint32_t LoadCounter(Register first) {
+        uint32_t r = 0;
+        for (int i = 0; i < 4; ++i) {
+            r |= device.Load(static_cast<Register>(static_cast<int>(first) + i)) << (8 * i);
+        }
+        return r;
+    }
+};
+
+TEST_F(PerfCounterDeviceTest, InitialState) {
+    EXPECT_EQ(device.Load(Register::kControl), 0);
+    EXPECT_EQ(LoadCounter(Register::kCycles0), 0);
+    EXPECT_EQ(LoadCounter(Register::kInstructions0), 0);
+}
+
+TEST_F(PerfCounterDeviceTest, StartStop) {
+    Execute(10, 2);
+    device.Store(Register::kControl, PerfCounterDevice::kRun);
+    EXPECT_EQ(device.Load(Register::kControl), PerfCounterDevice::kRun);
+    Execute(300, 3);
+
+    // not latched yet
+    EXPECT_EQ(LoadCounter(Register::kCycles0), 0);
+    device.Store(Register::kControl, 0);
+    Execute(10, 2);
+
+    EXPECT_EQ(LoadCounter(Register::kCycles0), 900);
+    EXPECT_EQ(LoadCounter(Register::kInstructions0), 300);
+}
+
+TEST_F(PerfCounterDeviceTest, SnapshotAndClear) {
+    device.Store(Register::kControl, PerfCounterDevice::kRun);
+    Execute(5, 4);
+    device.Store(Register::kControl, PerfCounterDevice::kRun | PerfCounterDevice::kSnapshot);
+    Execute(5, 4);
+    EXPECT_EQ(LoadCounter(Register::kCycles0), 20);
+    EXPECT_EQ(device.Cycles(), 40);
+
+    device.Store(Register::kControl, PerfCounterDevice::kRun | PerfCounterDevice::kClear);
+    Execute(1, 2);
+    EXPECT_EQ(device.Cycles(), 2);
+    EXPECT_EQ(device.Instructions(), 1);
+}
+
+TEST_F(PerfCounterDeviceTest, InvalidAccess) {
+    EXPECT_THROW(device.Store(Register::kCycles0, 0), std::runtime_error);
+    EXPECT_THROW(std::ignore = device.Load(PerfCounterDevice::kDeviceMemorySize),
+                 std::runtime_error);
+}
+
+} // namespace
+} // namespace emu::module::perf::test
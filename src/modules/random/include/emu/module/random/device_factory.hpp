@@ -2,6 +2,7 @@
 
 #include "emu/module/random/mt19937_device.hpp"
 #include "emu/module/random/random_device.hpp"
+#include "emu/module/random/xoshiro_device.hpp"
 #include "emu_core/device_factory.hpp"
 #include "emu_core/stream_container.hpp"
 #include <cstdint>
@@ -36,6 +37,24 @@ struct Mt19937DeviceFactory : public DeviceFactory {
     }
 };
 
+struct XoshiroDeviceFactory : public DeviceFactory {
+    XoshiroDeviceFactory() = default;
+    ~XoshiroDeviceFactory() override = default;
+
+    std::shared_ptr<Device> CreateDevice(const std::string &name,
+                                         const MemoryConfigEntry::MappedDevice &md,
+                                         Clock *clock,
+                                         std::ostream *verbose_output) const override {
+        auto instance = std::make_shared<DeviceInstance<XoshiroDevice>>();
+
+        auto seed = md.GetConfigItem<int64_t>("seed", XoshiroDevice::kDefaultSeed);
+
+        instance->device = std::make_shared<XoshiroDevice>(
+            static_cast<XoshiroDevice::IntType>(seed), verbose_output);
+        return instance;
+    }
+};
+
 struct RandomDeviceFactory : public DeviceFactory {
     RandomDeviceFactory() = default;
     ~RandomDeviceFactory() override = default;
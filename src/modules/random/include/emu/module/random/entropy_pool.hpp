@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace emu::module::random {
+
+// Byte buffer refilled in bulk. Every draw of the generator is split into bytes, lowest
+// byte first, so output does not depend on host endianness.
+template <size_t kSize = 256>
+class EntropyPool {
+public:
+    static_assert(kSize % sizeof(uint64_t) == 0);
+
+    template <typename Fill>
+    uint8_t Next(Fill &&fill) {
+        if (position == kSize) {
+            fill(std::span<uint8_t, kSize>{buffer});
+            position = 0;
+        }
+        return buffer[position++];
+    }
+
+    void Reset() { position = kSize; }
+
+    template <typename Engine>
+    static void FillFromEngine(Engine &engine, std::span<uint8_t, kSize> out) {
+        static_assert(Engine::min() == 0 &&
+                      (Engine::max() == UINT32_MAX || Engine::max() == UINT64_MAX));
+        constexpr size_t kBytesPerDraw = Engine::max() == UINT32_MAX ? 4 : 8;
+        for (size_t offset = 0; offset < kSize; offset += kBytesPerDraw) {
+            uint64_t v = engine();
+            for (size_t i = 0; i < kBytesPerDraw; ++i) {
+                out[offset + i] = static_cast<uint8_t>(v >> (8 * i));
+            }
+        }
+    }
+
+private:
+    std::array<uint8_t, kSize> buffer{};
+    size_t position = kSize;
+};
+
+// xoshiro256** 1.0, seeded with splitmix64
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed) { this->seed(seed); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    void seed(uint64_t value) {
+        for (auto &s : state) {
+            value += 0x9e3779b97f4a7c15;
+            uint64_t z = value;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            s = z ^ (z >> 31);
+        }
+    }
+
+    result_type operator()() {
+        const uint64_t result = std::rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = std::rotl(state[3], 45);
+        return result;
+    }
+
+private:
+    std::array<uint64_t, 4> state{};
+};
+
+} // namespace emu::module::random
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "emu/module/random/entropy_pool.hpp"
 #include "emu_core/memory.hpp"
 #include <cstdint>
 #include <iostream>
@@ -24,8 +25,10 @@ public:
 
 private:
     std::ostream *const verbose_output;
-    mutable std::uniform_int_distribution<> byte_distribution{0, 0xff};
+    mutable EntropyPool<> pool;
     mutable std::random_device rd;
+
+    void Fill(std::span<uint8_t> out) const;
 };
 
 } // namespace emu::module::random
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "emu/module/random/mt19937_device.hpp"
+#include "emu/module/random/xoshiro_device.hpp"
 #include "emu_core/symbol_factory.hpp"
 #include <cstdint>
 #include <memory>
@@ -31,6 +32,32 @@ struct Mt19937DeviceSymbolFactory : public SymbolFactory {
     }
 };
 
+struct XoshiroDeviceSymbolFactory : public SymbolFactory {
+    XoshiroDeviceSymbolFactory() = default;
+    ~XoshiroDeviceSymbolFactory() override = default;
+
+    static constexpr auto kClassName = "XOSHIRO";
+
+    SymbolDefVector GetSymbols(const MemoryConfigEntry &entry,
+                               const MemoryConfigEntry::MappedDevice &md) const override {
+        auto base = entry.offset;
+        SymbolDefVectorBuilder r{kClassName, entry.name};
+        using Reg = XoshiroDevice::Register;
+        r.EmitSymbol("BASE_ADDRESS"s, base);
+        r.EmitSymbol("REGISTER_SEED_0"s, base, Reg::kSeed0);
+        r.EmitSymbol("REGISTER_SEED_1"s, base, Reg::kSeed1);
+        r.EmitSymbol("REGISTER_SEED_2"s, base, Reg::kSeed2);
+        r.EmitSymbol("REGISTER_SEED_3"s, base, Reg::kSeed3);
+        r.EmitSymbol("REGISTER_SEED_4"s, base, Reg::kSeed4);
+        r.EmitSymbol("REGISTER_SEED_5"s, base, Reg::kSeed5);
+        r.EmitSymbol("REGISTER_SEED_6"s, base, Reg::kSeed6);
+        r.EmitSymbol("REGISTER_SEED_7"s, base, Reg::kSeed7);
+        r.EmitSymbol("REGISTER_ENTROPY"s, base, Reg::kEntropy);
+        r.EmitSymbol("REGISTER_CONTROL_0"s, base, Reg::kCR0);
+        return r.entries;
+    }
+};
+
 struct RandomDeviceSymbolFactory : public SymbolFactory {
     RandomDeviceSymbolFactory() = default;
     ~RandomDeviceSymbolFactory() override = default;
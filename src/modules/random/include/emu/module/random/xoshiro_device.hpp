@@ -0,0 +1,56 @@
+#pragma once
+
+#include "emu/module/random/entropy_pool.hpp"
+#include "emu_core/memory.hpp"
+#include <cstdint>
+#include <iostream>
+
+namespace emu::module::random {
+
+class XoshiroDevice : public Memory16 {
+public:
+    using IntType = uint64_t;
+    using CrReg = uint8_t;
+    using OutReg = uint8_t;
+
+    enum class Register : Memory16::Address_t {
+        kSeed0,
+        kSeed1,
+        kSeed2,
+        kSeed3,
+        kSeed4,
+        kSeed5,
+        kSeed6,
+        kSeed7,
+        kEntropy,
+        kCR0,
+    };
+
+    static constexpr IntType kDefaultSeed = 0xDEADBEEF;
+    static constexpr Memory16::Address_t kDeviceMemorySize =
+        sizeof(IntType) + sizeof(OutReg) + sizeof(CrReg);
+
+    XoshiroDevice(IntType default_seed = kDefaultSeed,
+                  std::ostream *verbose_output = nullptr);
+
+    [[nodiscard]] uint8_t Load(Address_t address) const override;
+    void Store(Address_t address, uint8_t value) override;
+
+    [[nodiscard]] std::optional<uint8_t> DebugRead(Address_t address) const override;
+
+private:
+    mutable EntropyPool<> pool;
+    mutable Xoshiro256 generator;
+    IntType current_seed;
+    uint8_t control_reg = 0;
+    std::ostream *const verbose_output;
+
+    [[noreturn]] void Error(const std::string &msg) const {
+        if (verbose_output != nullptr) {
+            (*verbose_output) << msg << "\n";
+        }
+        throw std::runtime_error(msg);
+    }
+};
+
+} // namespace emu::module::random
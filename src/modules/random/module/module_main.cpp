@@ -6,4 +6,5 @@ using namespace emu::module::random;
 
 EMU_DEFINE_FACTORIES(Mt19937DeviceFactory, Mt19937DeviceSymbolFactory, default)
 EMU_DEFINE_FACTORIES(Mt19937DeviceFactory, Mt19937DeviceSymbolFactory, mt19937)
+EMU_DEFINE_FACTORIES(XoshiroDeviceFactory, XoshiroDeviceSymbolFactory, xoshiro)
 EMU_DEFINE_FACTORIES(RandomDeviceFactory, RandomDeviceSymbolFactory, random)
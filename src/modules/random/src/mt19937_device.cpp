@@ -63,8 +63,7 @@ uint8_t Mt19937Device::Load(Address_t address) const {
     case Register::kSeed3:
         return (current_seed >> bit_offset(address)) & 0xFF;
     case Register::kEntropy:
-        // mt.operator();
-        return static_cast<uint8_t>(byte_distribution(mt));
+        return pool.Next([this](auto out) { EntropyPool<>::FillFromEngine(mt, out); });
     case Register::kCR0:
         return control_reg;
     }
@@ -81,6 +80,7 @@ void Mt19937Device::Store(Address_t address, uint8_t value) {
         current_seed = (current_seed & ~(0xFF << bit_offset(address))) |
                        (value << bit_offset(address));
         mt.seed(current_seed);
+        pool.Reset();
         return;
     case Register::kEntropy:
         if (verbose_output != nullptr) {
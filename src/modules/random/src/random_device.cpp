@@ -1,6 +1,7 @@
 #include "emu/module/random/random_device.hpp"
 #include "emu_core/bit_utils.hpp"
 #include <fmt/format.h>
+#include <sys/random.h>
 
 namespace emu::module::random {
 
@@ -13,7 +14,21 @@ std::optional<uint8_t> RandomDevice::DebugRead(Address_t address) const {
 }
 
 uint8_t RandomDevice::Load(Address_t address) const {
-    return static_cast<uint8_t>(byte_distribution(rd));
+    return pool.Next([this](auto out) { Fill(out); });
+}
+
+void RandomDevice::Fill(std::span<uint8_t> out) const {
+    // Single syscall per pool refill; fall back to random_device if getrandom fails
+    auto r = ::getrandom(out.data(), out.size(), 0);
+    if (r == static_cast<ssize_t>(out.size())) {
+        return;
+    }
+    for (size_t offset = 0; offset < out.size(); offset += sizeof(unsigned)) {
+        auto v = rd();
+        for (size_t i = 0; i < sizeof(unsigned) && offset + i < out.size(); ++i) {
+            out[offset + i] = static_cast<uint8_t>(v >> (8 * i));
+        }
+    }
 }
 
 void RandomDevice::Store(Address_t address, uint8_t value) {
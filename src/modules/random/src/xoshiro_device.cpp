@@ -0,0 +1,88 @@
+#include "emu/module/random/xoshiro_device.hpp"
+#include <fmt/format.h>
+
+namespace emu::module::random {
+
+namespace {
+
+size_t bit_offset(size_t v) {
+    return v * 8;
+}
+
+} // namespace
+
+XoshiroDevice::XoshiroDevice(IntType default_seed, std::ostream *verbose_output)
+    : generator(default_seed), current_seed(default_seed), verbose_output(verbose_output) {
+}
+
+std::optional<uint8_t> XoshiroDevice::DebugRead(Address_t address) const {
+    switch (static_cast<Register>(address)) {
+    case Register::kSeed0:
+    case Register::kSeed1:
+    case Register::kSeed2:
+    case Register::kSeed3:
+    case Register::kSeed4:
+    case Register::kSeed5:
+    case Register::kSeed6:
+    case Register::kSeed7:
+        return static_cast<uint8_t>((current_seed >> bit_offset(address)) & 0xFF);
+    case Register::kEntropy:
+        return std::nullopt;
+    case Register::kCR0:
+        return control_reg;
+    }
+
+    return std::nullopt;
+}
+
+uint8_t XoshiroDevice::Load(Address_t address) const {
+    switch (static_cast<Register>(address)) {
+    case Register::kSeed0:
+    case Register::kSeed1:
+    case Register::kSeed2:
+    case Register::kSeed3:
+    case Register::kSeed4:
+    case Register::kSeed5:
+    case Register::kSeed6:
+    case Register::kSeed7:
+        return (current_seed >> bit_offset(address)) & 0xFF;
+    case Register::kEntropy:
+        return pool.Next(
+            [this](auto out) { EntropyPool<>::FillFromEngine(generator, out); });
+    case Register::kCR0:
+        return control_reg;
+    }
+
+    Error(fmt::format("XoshiroDevice: Attempt to read address {:04x}", address));
+}
+
+void XoshiroDevice::Store(Address_t address, uint8_t value) {
+    switch (static_cast<Register>(address)) {
+    case Register::kSeed0:
+    case Register::kSeed1:
+    case Register::kSeed2:
+    case Register::kSeed3:
+    case Register::kSeed4:
+    case Register::kSeed5:
+    case Register::kSeed6:
+    case Register::kSeed7:
+        current_seed = (current_seed & ~(IntType{0xFF} << bit_offset(address))) |
+                       (IntType{value} << bit_offset(address));
+        generator.seed(current_seed);
+        pool.Reset();
+        return;
+    case Register::kEntropy:
+        if (verbose_output != nullptr) {
+            (*verbose_output) << "XoshiroDevice: Attempt to write to entropy register\n";
+        }
+        return;
+    case Register::kCR0:
+        control_reg = value;
+        return;
+    }
+
+    Error(fmt::format("XoshiroDevice: Attempt to write address {:04x} with {:02x}",
+                      address, value));
+}
+
+} // namespace emu::module::random
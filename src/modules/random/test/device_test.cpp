@@ -3,6 +3,7 @@
 
 #include "emu/module/random/mt19937_device.hpp"
 #include "emu/module/random/random_device.hpp"
+#include "emu/module/random/xoshiro_device.hpp"
 #include <sstream>
 
 namespace emu::module::random::test {
@@ -24,17 +25,49 @@ TEST_F(Mt19937DeviceTest, ConsistentResult) {
     EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kSeed1)), 0xbe);
     EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kSeed0)), 0xef);
 
+    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0x7d);
+    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0x7a);
+    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0x03);
     EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0x39);
-    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0xe5);
-    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0xc5);
-    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0x6d);
 
     EXPECT_NO_THROW(device.Store(static_cast<uint8_t>(Register::kSeed0), 0xef));
 
+    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0x7d);
+    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0x7a);
+    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0x03);
     EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0x39);
-    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0xe5);
-    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0xc5);
-    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kEntropy)), 0x6d);
+}
+
+class XoshiroDeviceTest : public testing::Test {
+public:
+    XoshiroDevice device{XoshiroDevice::kDefaultSeed, &std::cout};
+
+    using Register = XoshiroDevice::Register;
+
+    std::vector<uint8_t> Draw(size_t count) {
+        std::vector<uint8_t> r;
+        for (size_t i = 0; i < count; ++i) {
+            r.push_back(device.Load(static_cast<uint8_t>(Register::kEntropy)));
+        }
+        return r;
+    }
+};
+
+TEST_F(XoshiroDeviceTest, Reseed) {
+    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kSeed0)), 0xef);
+    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kSeed3)), 0xde);
+    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kSeed7)), 0x00);
+
+    // cross pool refill boundary
+    auto first = Draw(300);
+    EXPECT_NE(first, Draw(300));
+
+    EXPECT_NO_THROW(device.Store(static_cast<uint8_t>(Register::kSeed0), 0xef));
+    EXPECT_EQ(first, Draw(300));
+
+    EXPECT_NO_THROW(device.Store(static_cast<uint8_t>(Register::kSeed7), 0x01));
+    EXPECT_EQ(device.Load(static_cast<uint8_t>(Register::kSeed7)), 0x01);
+    EXPECT_NE(first, Draw(300));
 }
 
 class RandomDeviceTest : public testing::Test {
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "emu/module/shm/shm_ring_device.hpp"
+#include "emu_core/device_factory.hpp"
+#include <cstdint>
+#include <fmt/format.h>
+#include <unistd.h>
+
+using namespace std::string_literals;
+
+namespace emu::module::shm {
+
+struct ShmRingDeviceInstance : public Device,
+                               std::enable_shared_from_this<ShmRingDeviceInstance> {
+    ~ShmRingDeviceInstance() override = default;
+
+    std::shared_ptr<Memory16> GetMemory() override { return device; }
+    size_t GetMemorySize() override { return device->MemorySize(); };
+    std::shared_ptr<ShmRingDevice> device;
+};
+
+struct ShmRingDeviceFactory : public DeviceFactory {
+    ShmRingDeviceFactory() = default;
+    ~ShmRingDeviceFactory() override = default;
+
+    std::shared_ptr<Device> CreateDevice(const std::string &name,
+                                         const MemoryConfigEntry::MappedDevice &md,
+                                         Clock *clock,
+                                         std::ostream *verbose_output) const override {
+        auto instance = std::make_shared<ShmRingDeviceInstance>();
+
+        auto ring_size =
+            md.GetConfigItem<int64_t>("ring_size", ShmRingDevice::kDefaultRingSize);
+        ShmRingDevice::ValidateRingSize(static_cast<uint64_t>(ring_size));
+
+        auto shm_name = md.GetConfigItem("shm_name", ""s);
+        auto region = shm_name.empty()
+                          ? ShmRegion::Create(static_cast<uint32_t>(ring_size))
+                          : ShmRegion::CreateNamed(shm_name, static_cast<uint32_t>(ring_size));
+
+        if (verbose_output != nullptr) {
+            (*verbose_output) << fmt::format(
+                "ShmRingDevice {}: region {}\n", name,
+                shm_name.empty() ? fmt::format("/proc/{}/fd/{}", ::getpid(), region.Fd())
+                                 : shm_name);
+        }
+
+        instance->device = std::make_shared<ShmRingDevice>(std::move(region), verbose_output);
+        return instance;
+    }
+};
+
+} // namespace emu::module::shm
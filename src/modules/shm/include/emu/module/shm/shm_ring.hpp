@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace emu::module::shm {
+
+// Layout of the shared region. Both rings are single producer/single consumer, indices
+// are free running and only masked when accessing data.
+struct ShmRingHeader {
+    static constexpr uint32_t kMagic = 0x474E5245; // "ERNG"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ring_size;
+    uint32_t reserved;
+
+    // host -> guest
+    alignas(64) std::atomic<uint32_t> rx_head;
+    alignas(64) std::atomic<uint32_t> rx_tail;
+    // guest -> host
+    alignas(64) std::atomic<uint32_t> tx_head;
+    alignas(64) std::atomic<uint32_t> tx_tail;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+constexpr size_t kShmRingDataOffset = (sizeof(ShmRingHeader) + 63) & ~size_t{63};
+
+// Owns mapping of the shared region
+class ShmRegion {
+public:
+    // Creates anonymous memfd region
+    static ShmRegion Create(uint32_t ring_size);
+    // Creates (or truncates) named posix shared memory region
+    static ShmRegion CreateNamed(const std::string &shm_name, uint32_t ring_size);
+    // Maps region created by other process
+    static ShmRegion Attach(int fd);
+    static ShmRegion AttachNamed(const std::string &shm_name);
+
+    ShmRegion(ShmRegion &&other) noexcept;
+    ShmRegion &operator=(ShmRegion &&other) = delete;
+    ShmRegion(const ShmRegion &) = delete;
+    ShmRegion &operator=(const ShmRegion &) = delete;
+    ~ShmRegion();
+
+    [[nodiscard]] int Fd() const { return fd; }
+    [[nodiscard]] const std::string &Name() const { return name; }
+    [[nodiscard]] ShmRingHeader *Header() const { return header; }
+    [[nodiscard]] uint32_t RingSize() const { return header->ring_size; }
+    [[nodiscard]] uint8_t *RxData() const { return base + kShmRingDataOffset; }
+    [[nodiscard]] uint8_t *TxData() const { return RxData() + RingSize(); }
+
+    [[nodiscard]] static size_t RegionSize(uint32_t ring_size) {
+        return kShmRingDataOffset + 2 * static_cast<size_t>(ring_size);
+    }
+
+private:
+    ShmRegion(int fd, std::string name, bool owner);
+
+    int fd = -1;
+    std::string name;
+    bool owner = false;
+    uint8_t *base = nullptr;
+    size_t size = 0;
+    ShmRingHeader *header = nullptr;
+
+    void Map(size_t len);
+    void Init(uint32_t ring_size);
+};
+
+// Host side endpoint, produces into rx ring and consumes tx ring
+class ShmRingHost {
+public:
+    explicit ShmRingHost(const ShmRegion *region) : region(region) {}
+
+    // Returns number of bytes transferred
+    size_t Write(std::span<const uint8_t> data);
+    size_t Read(std::span<uint8_t> data);
+
+private:
+    const ShmRegion *const region;
+};
+
+} // namespace emu::module::shm
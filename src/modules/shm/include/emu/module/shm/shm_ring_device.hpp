@@ -0,0 +1,75 @@
+#pragma once
+
+#include "emu/module/shm/shm_ring.hpp"
+#include "emu_core/memory.hpp"
+#include <cstdint>
+#include <iostream>
+
+namespace emu::module::shm {
+
+// Guest side of ShmRegion. Head/tail registers are 16 bit; reading low byte latches whole
+// value, writing high byte commits it. Rx and tx data are mapped directly after registers.
+class ShmRingDevice : public Memory16 {
+public:
+    enum class Register : Memory16::Address_t {
+        kRxHead0,
+        kRxHead1,
+        kRxTail0,
+        kRxTail1,
+        kTxHead0,
+        kTxHead1,
+        kTxTail0,
+        kTxTail1,
+        kSizeShift,
+    };
+
+    static constexpr Memory16::Address_t kWindowOffset = 0x10;
+    static constexpr uint32_t kDefaultRingSize = 256;
+    static constexpr uint32_t kMaxRingSize = 0x4000;
+
+    ShmRingDevice(ShmRegion region, std::ostream *verbose_output = nullptr);
+
+    [[nodiscard]] uint8_t Load(Address_t address) const override;
+    void Store(Address_t address, uint8_t value) override;
+
+    [[nodiscard]] std::optional<uint8_t> DebugRead(Address_t address) const override;
+
+    [[nodiscard]] uint8_t Load(Register address) const {
+        return Load(static_cast<Address_t>(address));
+    }
+    void Store(Register address, uint8_t value) {
+        Store(static_cast<Address_t>(address), value);
+    }
+
+    [[nodiscard]] const ShmRegion &GetRegion() const { return region; }
+    [[nodiscard]] Memory16::Address_t MemorySize() const {
+        return static_cast<Memory16::Address_t>(kWindowOffset + 2 * ring_size);
+    }
+    [[nodiscard]] Memory16::Address_t TxWindowOffset() const {
+        return static_cast<Memory16::Address_t>(kWindowOffset + ring_size);
+    }
+
+    static void ValidateRingSize(uint64_t size);
+
+private:
+    ShmRegion region;
+    ShmRingHeader *const header;
+    uint32_t const ring_size;
+    std::ostream *const verbose_output;
+
+    mutable uint16_t read_latch = 0;
+    uint16_t write_latch = 0;
+
+    [[nodiscard]] uint8_t LatchIndex(const std::atomic<uint32_t> &index,
+                                     std::memory_order order) const;
+    static void CommitIndex(std::atomic<uint32_t> &index, uint16_t value);
+
+    [[noreturn]] void Error(const std::string &msg) const {
+        if (verbose_output != nullptr) {
+            (*verbose_output) << msg << "\n";
+        }
+        throw std::runtime_error(msg);
+    }
+};
+
+} // namespace emu::module::shm
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "emu/module/shm/shm_ring_device.hpp"
+#include "emu_core/symbol_factory.hpp"
+#include <cstdint>
+#include <memory>
+
+using namespace std::string_literals;
+
+namespace emu::module::shm {
+
+struct ShmRingDeviceSymbolFactory : public SymbolFactory {
+    ShmRingDeviceSymbolFactory() = default;
+    ~ShmRingDeviceSymbolFactory() override = default;
+
+    static constexpr auto kClassName = "SHM";
+
+    SymbolDefVector GetSymbols(const MemoryConfigEntry &entry,
+                               const MemoryConfigEntry::MappedDevice &md) const override {
+        auto base = entry.offset;
+        auto ring_size =
+            md.GetConfigItem<int64_t>("ring_size", ShmRingDevice::kDefaultRingSize);
+
+        SymbolDefVectorBuilder r{kClassName, entry.name};
+        using Reg = ShmRingDevice::Register;
+        r.EmitSymbol("BASE_ADDRESS"s, base);
+        r.EmitSymbol("REGISTER_RX_HEAD"s, base, Reg::kRxHead0);
+        r.EmitSymbol("REGISTER_RX_TAIL"s, base, Reg::kRxTail0);
+        r.EmitSymbol("REGISTER_TX_HEAD"s, base, Reg::kTxHead0);
+        r.EmitSymbol("REGISTER_TX_TAIL"s, base, Reg::kTxTail0);
+        r.EmitSymbol("REGISTER_SIZE_SHIFT"s, base, Reg::kSizeShift);
+        r.EmitSymbol("RX_WINDOW"s, base, ShmRingDevice::kWindowOffset);
+        r.EmitSymbol("TX_WINDOW"s, base, ShmRingDevice::kWindowOffset + ring_size);
+        r.EmitAlias("RING_SIZE"s, static_cast<uint32_t>(ring_size));
+        r.EmitAlias("RING_MASK"s, static_cast<uint32_t>(ring_size - 1));
+        return r.entries;
+    }
+};
+
+} // namespace emu::module::shm
@@ -0,0 +1,8 @@
+#include "emu/module/shm/device_factory.hpp"
+#include "emu/module/shm/symbol_factory.hpp"
+#include "emu_core/plugins/plugin.hpp"
+
+using namespace emu::module::shm;
+
+EMU_DEFINE_FACTORIES(ShmRingDeviceFactory, ShmRingDeviceSymbolFactory, default)
+EMU_DEFINE_FACTORIES(ShmRingDeviceFactory, ShmRingDeviceSymbolFactory, ring)
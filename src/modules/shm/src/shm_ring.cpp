@@ -0,0 +1,145 @@
+#include "emu/module/shm/shm_ring.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace emu::module::shm {
+
+namespace {
+
+[[noreturn]] void Error(const std::string &msg) {
+    throw std::runtime_error(fmt::format("ShmRegion: {}: {}", msg, std::strerror(errno)));
+}
+
+} // namespace
+
+ShmRegion::ShmRegion(int fd, std::string name, bool owner)
+    : fd(fd), name(std::move(name)), owner(owner) {}
+
+ShmRegion::ShmRegion(ShmRegion &&other) noexcept
+    : fd(std::exchange(other.fd, -1)), name(std::move(other.name)),
+      owner(std::exchange(other.owner, false)), base(std::exchange(other.base, nullptr)),
+      size(std::exchange(other.size, 0)), header(std::exchange(other.header, nullptr)) {}
+
+ShmRegion::~ShmRegion() {
+    if (base != nullptr) {
+        ::munmap(base, size);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (owner && !name.empty()) {
+        ::shm_unlink(name.c_str());
+    }
+}
+
+ShmRegion ShmRegion::Create(uint32_t ring_size) {
+    int fd = ::memfd_create("emu_shm_ring", MFD_CLOEXEC);
+    if (fd < 0) {
+        Error("memfd_create failed");
+    }
+    ShmRegion r{fd, "", true};
+    r.Init(ring_size);
+    return r;
+}
+
+ShmRegion ShmRegion::CreateNamed(const std::string &shm_name, uint32_t ring_size) {
+    int fd = ::shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        Error(fmt::format("shm_open({}) failed", shm_name));
+    }
+    ShmRegion r{fd, shm_name, true};
+    r.Init(ring_size);
+    return r;
+}
+
+ShmRegion ShmRegion::Attach(int fd) {
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        Error("fstat failed");
+    }
+    if (static_cast<size_t>(st.st_size) < kShmRingDataOffset) {
+        throw std::runtime_error("ShmRegion: Region is too small");
+    }
+    ShmRegion r{fd, "", false};
+    r.Map(st.st_size);
+    if (r.header->magic != ShmRingHeader::kMagic ||
+        r.header->version != ShmRingHeader::kVersion ||
+        RegionSize(r.header->ring_size) > r.size) {
+        throw std::runtime_error("ShmRegion: Invalid region header");
+    }
+    return r;
+}
+
+ShmRegion ShmRegion::AttachNamed(const std::string &shm_name) {
+    int fd = ::shm_open(shm_name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        Error(fmt::format("shm_open({}) failed", shm_name));
+    }
+    return Attach(fd);
+}
+
+void ShmRegion::Map(size_t len) {
+    void *p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        Error("mmap failed");
+    }
+    base = static_cast<uint8_t *>(p);
+    size = len;
+    header = reinterpret_cast<ShmRingHeader *>(base);
+}
+
+void ShmRegion::Init(uint32_t ring_size) {
+    if (ring_size == 0 || (ring_size & (ring_size - 1)) != 0) {
+        throw std::runtime_error(
+            fmt::format("ShmRegion: Ring size {} is not a power of 2", ring_size));
+    }
+    auto len = RegionSize(ring_size);
+    if (::ftruncate(fd, static_cast<off_t>(len)) != 0) {
+        Error("ftruncate failed");
+    }
+    Map(len);
+    header = new (base) ShmRingHeader{};
+    header->magic = ShmRingHeader::kMagic;
+    header->version = ShmRingHeader::kVersion;
+    header->ring_size = ring_size;
+}
+
+size_t ShmRingHost::Write(std::span<const uint8_t> data) {
+    auto *header = region->Header();
+    auto mask = region->RingSize() - 1;
+    auto head = header->rx_head.load(std::memory_order_relaxed);
+    auto tail = header->rx_tail.load(std::memory_order_acquire);
+    auto count = std::min<size_t>(data.size(), region->RingSize() - (head - tail));
+
+    auto *ring = region->RxData();
+    for (size_t i = 0; i < count; ++i) {
+        ring[(head + i) & mask] = data[i];
+    }
+    header->rx_head.store(head + static_cast<uint32_t>(count), std::memory_order_release);
+    return count;
+}
+
+size_t ShmRingHost::Read(std::span<uint8_t> data) {
+    auto *header = region->Header();
+    auto mask = region->RingSize() - 1;
+    auto tail = header->tx_tail.load(std::memory_order_relaxed);
+    auto head = header->tx_head.load(std::memory_order_acquire);
+    auto count = std::min<size_t>(data.size(), head - tail);
+
+    const auto *ring = region->TxData();
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = ring[(tail + i) & mask];
+    }
+    header->tx_tail.store(tail + static_cast<uint32_t>(count), std::memory_order_release);
+    return count;
+}
+
+} // namespace emu::module::shm
@@ -0,0 +1,122 @@
+#include "emu/module/shm/shm_ring_device.hpp"
+#include <bit>
+#include <fmt/format.h>
+
+namespace emu::module::shm {
+
+void ShmRingDevice::ValidateRingSize(uint64_t size) {
+    if (size == 0 || size > kMaxRingSize || (size & (size - 1)) != 0) {
+        throw std::runtime_error(fmt::format(
+            "ShmRingDevice: Ring size must be power of 2 not greater than {:x}, got {:x}",
+            kMaxRingSize, size));
+    }
+}
+
+ShmRingDevice::ShmRingDevice(ShmRegion _region, std::ostream *verbose_output)
+    : region(std::move(_region)), header(region.Header()), ring_size(region.RingSize()),
+      verbose_output(verbose_output) {
+    ValidateRingSize(ring_size);
+}
+
+uint8_t ShmRingDevice::LatchIndex(const std::atomic<uint32_t> &index,
+                                  std::memory_order order) const {
+    read_latch = static_cast<uint16_t>(index.load(order));
+    return static_cast<uint8_t>(read_latch & 0xFF);
+}
+
+void ShmRingDevice::CommitIndex(std::atomic<uint32_t> &index, uint16_t value) {
+    // Guest sees only low 16 bits. Ring is smaller than 64k, so distance is unambiguous
+    auto current = index.load(std::memory_order_relaxed);
+    auto delta = static_cast<uint16_t>(value - static_cast<uint16_t>(current));
+    index.store(current + delta, std::memory_order_release);
+}
+
+std::optional<uint8_t> ShmRingDevice::DebugRead(Address_t address) const {
+    if (address >= kWindowOffset && address < MemorySize()) {
+        return region.RxData()[address - kWindowOffset];
+    }
+
+    auto low = [](const std::atomic<uint32_t> &v) {
+        return static_cast<uint8_t>(v.load(std::memory_order_relaxed) & 0xFF);
+    };
+    auto high = [](const std::atomic<uint32_t> &v) {
+        return static_cast<uint8_t>((v.load(std::memory_order_relaxed) >> 8) & 0xFF);
+    };
+
+    switch (static_cast<Register>(address)) {
+    case Register::kRxHead0:
+        return low(header->rx_head);
+    case Register::kRxHead1:
+        return high(header->rx_head);
+    case Register::kRxTail0:
+        return low(header->rx_tail);
+    case Register::kRxTail1:
+        return high(header->rx_tail);
+    case Register::kTxHead0:
+        return low(header->tx_head);
+    case Register::kTxHead1:
+        return high(header->tx_head);
+    case Register::kTxTail0:
+        return low(header->tx_tail);
+    case Register::kTxTail1:
+        return high(header->tx_tail);
+    case Register::kSizeShift:
+        return static_cast<uint8_t>(std::countr_zero(ring_size));
+    }
+
+    return std::nullopt;
+}
+
+uint8_t ShmRingDevice::Load(Address_t address) const {
+    if (address >= kWindowOffset && address < MemorySize()) {
+        // rx and tx data areas are adjacent in shared region
+        return region.RxData()[address - kWindowOffset];
+    }
+
+    switch (static_cast<Register>(address)) {
+    case Register::kRxHead0:
+        return LatchIndex(header->rx_head, std::memory_order_acquire);
+    case Register::kRxTail0:
+        return LatchIndex(header->rx_tail, std::memory_order_relaxed);
+    case Register::kTxHead0:
+        return LatchIndex(header->tx_head, std::memory_order_relaxed);
+    case Register::kTxTail0:
+        return LatchIndex(header->tx_tail, std::memory_order_acquire);
+    case Register::kRxHead1:
+    case Register::kRxTail1:
+    case Register::kTxHead1:
+    case Register::kTxTail1:
+        return static_cast<uint8_t>(read_latch >> 8);
+    case Register::kSizeShift:
+        return static_cast<uint8_t>(std::countr_zero(ring_size));
+    }
+
+    Error(fmt::format("ShmRingDevice: Attempt to read address {:04x}", address));
+}
+
+void ShmRingDevice::Store(Address_t address, uint8_t value) {
+    if (address >= TxWindowOffset() && address < MemorySize()) {
+        region.TxData()[address - TxWindowOffset()] = value;
+        return;
+    }
+
+    switch (static_cast<Register>(address)) {
+    case Register::kRxTail0:
+    case Register::kTxHead0:
+        write_latch = value;
+        return;
+    case Register::kRxTail1:
+        CommitIndex(header->rx_tail, static_cast<uint16_t>(write_latch | (value << 8)));
+        return;
+    case Register::kTxHead1:
+        CommitIndex(header->tx_head, static_cast<uint16_t>(write_latch | (value << 8)));
+        return;
+    default:
+        break;
+    }
+
+    Error(fmt::format("ShmRingDevice: Attempt to write address {:04x} with {:02x}",
+                      address, value));
+}
+
+} // namespace emu::module::shm
@@ -0,0 +1,85 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "emu/module/shm/shm_ring_device.hpp"
+#include <array>
+#include <unistd.h>
+
+namespace emu::module::shm::test {
+namespace {
+
+using namespace ::testing;
+using namespace std::string_literals;
+
+class ShmRingDeviceTest : public testing::Test {
+public:
+    static constexpr uint32_t kRingSize = 16;
+
+    using Register = ShmRingDevice::Register;
+
+    ShmRingDevice device{ShmRegion::Create(kRingSize)};
+    ShmRegion host_region = ShmRegion::Attach(::dup(device.GetRegion().Fd()));
+    ShmRingHost host{&host_region};
+
+    uint16_t LoadIndex(Register reg) {
+        uint16_t r = device.Load(reg);
+        r |= device.Load(static_cast<Register>(static_cast<int>(reg) + 1)) << 8;
+        return r;
+    }
+
+    void StoreIndex(Register reg, uint16_t v) {
+        device.Store(reg, static_cast<uint8_t>(v & 0xFF));
+        device.Store(static_cast<Register>(static_cast<int>(reg) + 1),
+                     static_cast<uint8_t>(v >> 8));
+    }
+};
+
+TEST_F(ShmRingDeviceTest, InitialState) {
+    EXPECT_EQ(device.MemorySize(), ShmRingDevice::kWindowOffset + 2 * kRingSize);
+    EXPECT_EQ(device.Load(Register::kSizeShift), 4);
+    EXPECT_EQ(LoadIndex(Register::kRxHead0), 0);
+    EXPECT_EQ(LoadIndex(Register::kRxTail0), 0);
+    EXPECT_EQ(LoadIndex(Register::kTxHead0), 0);
+    EXPECT_EQ(LoadIndex(Register::kTxTail0), 0);
+}
+
+TEST_F(ShmRingDeviceTest, HostToGuest) {
+    std::array<uint8_t, 20> data{};
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i + 1);
+    }
+    EXPECT_EQ(host.Write(data), kRingSize);
+    EXPECT_EQ(LoadIndex(Register::kRxHead0), kRingSize);
+
+    for (uint16_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(device.Load(ShmRingDevice::kWindowOffset + i), i + 1);
+    }
+    StoreIndex(Register::kRxTail0, 4);
+    EXPECT_EQ(host.Write(std::span{data}.subspan(kRingSize)), 4);
+
+    // wrapped around
+    EXPECT_EQ(device.Load(ShmRingDevice::kWindowOffset), kRingSize + 1);
+}
+
+TEST_F(ShmRingDeviceTest, GuestToHost) {
+    for (uint16_t i = 0; i < 3; ++i) {
+        device.Store(device.TxWindowOffset() + i, static_cast<uint8_t>(0xA0 + i));
+    }
+
+    std::array<uint8_t, 8> data{};
+    EXPECT_EQ(host.Read(data), 0);
+    StoreIndex(Register::kTxHead0, 3);
+    ASSERT_EQ(host.Read(data), 3);
+    EXPECT_THAT(std::span{data}.first(3), ElementsAre(0xA0, 0xA1, 0xA2));
+    EXPECT_EQ(LoadIndex(Register::kTxTail0), 3);
+}
+
+TEST_F(ShmRingDeviceTest, InvalidAccess) {
+    EXPECT_THROW(device.Store(Register::kRxHead0, 0), std::runtime_error);
+    EXPECT_THROW(device.Store(ShmRingDevice::kWindowOffset, 0), std::runtime_error);
+    EXPECT_THROW(std::ignore = device.Load(device.MemorySize()), std::runtime_error);
+    EXPECT_THROW(ShmRingDevice::ValidateRingSize(24), std::runtime_error);
+}
+
+} // namespace
+} // namespace emu::module::shm::test
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace emu::module::tty {
+
+// Host side of the tty device. Both calls are made from the cpu thread and must not block.
+struct TtyChannel {
+    virtual ~TtyChannel() = default;
+
+    [[nodiscard]] virtual std::optional<uint8_t> Read() = 0;
+    virtual void Write(uint8_t byte) = 0;
+};
+
+class StreamTtyChannel : public TtyChannel {
+public:
+    StreamTtyChannel(std::istream *_input_stream, std::ostream *_output_stream)
+        : input_stream(_input_stream), output_stream(_output_stream) {}
+
+    [[nodiscard]] std::optional<uint8_t> Read() override;
+    void Write(uint8_t byte) override;
+
+private:
+    std::istream *const input_stream;
+    std::ostream *const output_stream;
+};
+
+// Pseudo terminal or unix socket serviced by an epoll loop on a separate thread.
+// Cpu thread only touches in-memory queues; a syscall is made only to wake up the
+// io thread when output queue becomes non empty.
+class EpollTtyChannel : public TtyChannel {
+public:
+    static constexpr size_t kMaxPendingInput = 64 * 1024;
+    static constexpr size_t kIoChunkSize = 4096;
+
+    ~EpollTtyChannel() override;
+
+    // Opens pty master. If link_path is not empty, symlink to slave device is created.
+    static std::shared_ptr<EpollTtyChannel> OpenPty(const std::string &link_path = "",
+                                                    std::ostream *verbose_output = nullptr);
+    // Listens on unix socket. Single client is served at a time.
+    static std::shared_ptr<EpollTtyChannel>
+    ListenUnixSocket(const std::string &socket_path, std::ostream *verbose_output = nullptr);
+
+    [[nodiscard]] std::optional<uint8_t> Read() override;
+    void Write(uint8_t byte) override;
+
+    [[nodiscard]] const std::string &GetPath() const { return path; }
+    [[nodiscard]] bool IsConnected() const { return io_fd.load() >= 0; }
+
+private:
+    struct PrivateTag {};
+
+public:
+    EpollTtyChannel(PrivateTag, std::ostream *verbose_output);
+
+private:
+    std::ostream *const verbose_output;
+
+    std::string path;
+    std::string link_path;
+    bool unlink_path = false;
+
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    int listen_fd = -1;
+    int pty_slave_fd = -1;
+    std::atomic<int> io_fd = -1;
+
+    std::mutex queue_mutex;
+    std::deque<uint8_t> input_queue;
+    std::deque<uint8_t> output_queue;
+    bool input_paused = false;
+
+    std::atomic<bool> stopping = false;
+    std::thread io_thread;
+
+    void Start();
+    void Stop();
+    void IoThreadMain();
+    void Wake();
+
+    void Accept();
+    void Disconnect();
+    void ReadInput();
+    void FlushOutput();
+    void UpdateInterest();
+
+    [[noreturn]] void Error(const std::string &msg) const;
+    void Log(const std::string &msg) const;
+};
+
+} // namespace emu::module::tty
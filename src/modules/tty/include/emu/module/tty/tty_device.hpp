@@ -1,5 +1,6 @@
 #pragma once
 
+#include "emu/module/tty/tty_channel.hpp"
 #include "emu_core/memory.hpp"
 #include <cstdint>
 #include <emu_core/clock.hpp>
@@ -43,6 +44,11 @@ public:
               BaudRate _baudrate = BaudRate::bDefault,             //
               uint64_t _fifo_buffer_size = kDefaultFifoBufferSize, //
               bool _enabled = false);
+    TtyDevice(std::shared_ptr<TtyChannel> _channel,                //
+              Clock *_clock,                                       //
+              BaudRate _baudrate = BaudRate::bDefault,             //
+              uint64_t _fifo_buffer_size = kDefaultFifoBufferSize, //
+              bool _enabled = false);
 
     uint8_t Load(Address_t address) const override;
     void Store(Address_t address, uint8_t value) override;
@@ -63,8 +69,7 @@ public:
     void SetRate(BaudRate baud);
 
 private:
-    std::istream *const input_stream;
-    std::ostream *const output_stream;
+    std::shared_ptr<TtyChannel> const channel;
     Clock *const clock;
     uint64_t const fifo_buffer_size;
 
@@ -0,0 +1,390 @@
+#include "emu/module/tty/tty_channel.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace emu::module::tty {
+
+namespace {
+
+constexpr uint64_t kWakeTag = 0;
+constexpr uint64_t kListenTag = 1;
+constexpr uint64_t kIoTag = 2;
+
+void CloseFd(int &fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+} // namespace
+
+std::optional<uint8_t> StreamTtyChannel::Read() {
+    if (input_stream == nullptr || input_stream->eof()) {
+        return std::nullopt;
+    }
+    uint8_t byte = 0;
+    input_stream->read(reinterpret_cast<char *>(&byte), 1);
+    if (input_stream->eof()) {
+        return std::nullopt;
+    }
+    return byte;
+}
+
+void StreamTtyChannel::Write(uint8_t byte) {
+    if (output_stream != nullptr) {
+        output_stream->write(reinterpret_cast<char *>(&byte), 1);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+EpollTtyChannel::EpollTtyChannel(PrivateTag, std::ostream *verbose_output)
+    : verbose_output(verbose_output) {}
+
+EpollTtyChannel::~EpollTtyChannel() { Stop(); }
+
+std::shared_ptr<EpollTtyChannel> EpollTtyChannel::OpenPty(const std::string &link_path,
+                                                          std::ostream *verbose_output) {
+    auto channel = std::make_shared<EpollTtyChannel>(PrivateTag{}, verbose_output);
+
+    int master = ::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (master < 0) {
+        channel->Error("posix_openpt failed");
+    }
+    channel->io_fd = master;
+    if (::grantpt(master) != 0 || ::unlockpt(master) != 0) {
+        channel->Error("Failed to unlock pty");
+    }
+
+    char slave_name[256] = {};
+    if (::ptsname_r(master, slave_name, sizeof(slave_name)) != 0) {
+        channel->Error("ptsname failed");
+    }
+    channel->path = slave_name;
+
+    // Keep slave opened, so master does not report hangup when client disconnects
+    channel->pty_slave_fd = ::open(slave_name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (channel->pty_slave_fd < 0) {
+        channel->Error(fmt::format("Failed to open {}", slave_name));
+    }
+    termios tio{};
+    if (::tcgetattr(channel->pty_slave_fd, &tio) == 0) {
+        ::cfmakeraw(&tio);
+        ::tcsetattr(channel->pty_slave_fd, TCSANOW, &tio);
+    }
+
+    if (!link_path.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(link_path, ec);
+        std::filesystem::create_symlink(slave_name, link_path, ec);
+        if (ec) {
+            channel->Error(fmt::format("Failed to create link {} -> {}: {}", link_path,
+                                       slave_name, ec.message()));
+        }
+        channel->link_path = link_path;
+    }
+
+    channel->Log(fmt::format("Opened pty {}", channel->path));
+    channel->Start();
+    return channel;
+}
+
+std::shared_ptr<EpollTtyChannel>
+EpollTtyChannel::ListenUnixSocket(const std::string &socket_path,
+                                  std::ostream *verbose_output) {
+    auto channel = std::make_shared<EpollTtyChannel>(PrivateTag{}, verbose_output);
+    channel->path = socket_path;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(addr.sun_path)) {
+        channel->Error(fmt::format("Invalid socket path '{}'", socket_path));
+    }
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    channel->listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (channel->listen_fd < 0) {
+        channel->Error("socket failed");
+    }
+    ::unlink(socket_path.c_str());
+    if (::bind(channel->listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) !=
+        0) {
+        channel->Error(fmt::format("Failed to bind {}", socket_path));
+    }
+    channel->unlink_path = true;
+    if (::listen(channel->listen_fd, 1) != 0) {
+        channel->Error(fmt::format("Failed to listen on {}", socket_path));
+    }
+
+    channel->Log(fmt::format("Listening on {}", socket_path));
+    channel->Start();
+    return channel;
+}
+
+void EpollTtyChannel::Error(const std::string &msg) const {
+    throw std::runtime_error(
+        fmt::format("EpollTtyChannel: {}: {}", msg, std::strerror(errno)));
+}
+
+void EpollTtyChannel::Log(const std::string &msg) const {
+    if (verbose_output != nullptr) {
+        (*verbose_output) << "EpollTtyChannel: " << msg << "\n";
+    }
+}
+
+void EpollTtyChannel::Start() {
+    epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        Error("epoll_create1 failed");
+    }
+    wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        Error("eventfd failed");
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kWakeTag;
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+
+    if (listen_fd >= 0) {
+        ev.data.u64 = kListenTag;
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+    }
+    if (int fd = io_fd.load(); fd >= 0) {
+        ev.data.u64 = kIoTag;
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    io_thread = std::thread([this] { IoThreadMain(); });
+}
+
+void EpollTtyChannel::Stop() {
+    if (io_thread.joinable()) {
+        stopping = true;
+        Wake();
+        io_thread.join();
+    }
+
+    int fd = io_fd.exchange(-1);
+    CloseFd(fd);
+    CloseFd(listen_fd);
+    CloseFd(pty_slave_fd);
+    CloseFd(wake_fd);
+    CloseFd(epoll_fd);
+
+    std::error_code ec;
+    if (!link_path.empty()) {
+        std::filesystem::remove(link_path, ec);
+    }
+    if (unlink_path) {
+        std::filesystem::remove(path, ec);
+    }
+}
+
+void EpollTtyChannel::Wake() {
+    uint64_t v = 1;
+    [[maybe_unused]] auto r = ::write(wake_fd, &v, sizeof(v));
+}
+
+std::optional<uint8_t> EpollTtyChannel::Read() {
+    bool resume = false;
+    std::optional<uint8_t> r;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (input_queue.empty()) {
+            return std::nullopt;
+        }
+        r = input_queue.front();
+        input_queue.pop_front();
+        resume = input_paused && input_queue.size() < kMaxPendingInput / 2;
+    }
+    if (resume) {
+        Wake();
+    }
+    return r;
+}
+
+void EpollTtyChannel::Write(uint8_t byte) {
+    bool was_empty = false;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        was_empty = output_queue.empty();
+        output_queue.push_back(byte);
+    }
+    if (was_empty) {
+        Wake();
+    }
+}
+
+void EpollTtyChannel::IoThreadMain() {
+    epoll_event events[4];
+    while (!stopping) {
+        int count = ::epoll_wait(epoll_fd, events, std::size(events), -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Log(fmt::format("epoll_wait failed: {}", std::strerror(errno)));
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const auto &ev = events[i];
+            switch (ev.data.u64) {
+            case kWakeTag: {
+                uint64_t v;
+                [[maybe_unused]] auto r = ::read(wake_fd, &v, sizeof(v));
+                break;
+            }
+            case kListenTag:
+                Accept();
+                break;
+            case kIoTag:
+                if ((ev.events & EPOLLIN) != 0) {
+                    ReadInput();
+                }
+                if ((ev.events & (EPOLLHUP | EPOLLERR)) != 0 && listen_fd >= 0) {
+                    Disconnect();
+                }
+                break;
+            }
+        }
+
+        if (stopping) {
+            return;
+        }
+        FlushOutput();
+        UpdateInterest();
+    }
+}
+
+void EpollTtyChannel::Accept() {
+    int client = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (client < 0) {
+        return;
+    }
+    if (io_fd.load() >= 0) {
+        Log("Rejecting client, already connected");
+        ::close(client);
+        return;
+    }
+    Log("Client connected");
+    io_fd = client;
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kIoTag;
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client, &ev);
+}
+
+void EpollTtyChannel::Disconnect() {
+    int fd = io_fd.exchange(-1);
+    if (fd < 0) {
+        return;
+    }
+    Log("Client disconnected");
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+}
+
+void EpollTtyChannel::ReadInput() {
+    uint8_t buffer[kIoChunkSize];
+    while (true) {
+        int fd = io_fd.load();
+        if (fd < 0) {
+            return;
+        }
+        size_t space = 0;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            space = kMaxPendingInput - std::min(kMaxPendingInput, input_queue.size());
+            input_paused = space == 0;
+        }
+        if (space == 0) {
+            return;
+        }
+
+        auto r = ::read(fd, buffer, std::min(space, sizeof(buffer)));
+        if (r > 0) {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            input_queue.insert(input_queue.end(), buffer, buffer + r);
+            continue;
+        }
+        if (r < 0 && (errno == EAGAIN || errno == EINTR)) {
+            return;
+        }
+        // EOF or error. Pty master reports EIO when no slave is open, it is not fatal.
+        if (listen_fd >= 0) {
+            Disconnect();
+        }
+        return;
+    }
+}
+
+void EpollTtyChannel::FlushOutput() {
+    int fd = io_fd.load();
+    uint8_t buffer[kIoChunkSize];
+    while (true) {
+        size_t count = 0;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (fd < 0) {
+                // Nobody is listening, drop data as a disconnected serial line would
+                output_queue.clear();
+                return;
+            }
+            count = std::min(output_queue.size(), sizeof(buffer));
+            std::copy_n(output_queue.begin(), count, buffer);
+        }
+        if (count == 0) {
+            return;
+        }
+
+        auto r = ::write(fd, buffer, count);
+        if (r <= 0) {
+            if (r < 0 && errno != EAGAIN && errno != EINTR && listen_fd >= 0) {
+                Disconnect();
+                fd = -1;
+                continue;
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        output_queue.erase(output_queue.begin(), output_queue.begin() + r);
+    }
+}
+
+void EpollTtyChannel::UpdateInterest() {
+    int fd = io_fd.load();
+    if (fd < 0) {
+        return;
+    }
+    epoll_event ev{};
+    ev.data.u64 = kIoTag;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (input_queue.size() < kMaxPendingInput) {
+            ev.events |= EPOLLIN;
+            input_paused = false;
+        }
+        if (!output_queue.empty()) {
+            ev.events |= EPOLLOUT;
+        }
+    }
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+}
+
+} // namespace emu::module::tty
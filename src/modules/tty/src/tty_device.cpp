@@ -96,11 +96,18 @@ TtyDevice::TtyDevice(std::istream *_input_stream,  //
                      BaudRate _baudrate,           //
                      uint64_t _fifo_buffer_size,   //
                      bool _enabled)                //
-    : input_stream(_input_stream),                 //
-      output_stream(_output_stream),               //
-      clock(_clock),                               //
-      fifo_buffer_size(_fifo_buffer_size),         //
-      enabled(!_enabled) {                         //
+    : TtyDevice(std::make_shared<StreamTtyChannel>(_input_stream, _output_stream),
+                _clock, _baudrate, _fifo_buffer_size, _enabled) {}
+
+TtyDevice::TtyDevice(std::shared_ptr<TtyChannel> _channel, //
+                     Clock *_clock,                        //
+                     BaudRate _baudrate,                   //
+                     uint64_t _fifo_buffer_size,           //
+                     bool _enabled)                        //
+    : channel(std::move(_channel)),                        //
+      clock(_clock),                                       //
+      fifo_buffer_size(_fifo_buffer_size),                 //
+      enabled(!_enabled) {                                 //
     if (fifo_buffer_size > 255) {
         throw std::runtime_error("TtyDevice: Fifo buffer size must fit in 8 bits");
     }
@@ -225,26 +232,21 @@ void TtyDevice::UpdateBuffers() {
     if (enabled) {
         for (uint64_t i = 0; i < delta && !output_queue.empty(); ++i) {
             ++processed_output_bytes;
-            auto byte = output_queue.front();
+            channel->Write(output_queue.front());
             output_queue.pop();
-            if (output_stream != nullptr) {
-                output_stream->write(reinterpret_cast<char *>(&byte), 1);
-            }
         }
     }
 
-    if (input_stream != nullptr) {
-        for (uint64_t i = 0; i < delta && !input_stream->eof(); ++i) {
-            uint8_t byte = 0;
-            input_stream->read(reinterpret_cast<char *>(&byte), 1);
-            if (!input_stream->eof()) {
-                input_queue.push(byte);
-                if (input_queue.size() >= fifo_buffer_size) {
-                    input_queue.pop();
-                }
-                ++processed_input_bytes;
-            }
+    for (uint64_t i = 0; i < delta; ++i) {
+        auto byte = channel->Read();
+        if (!byte.has_value()) {
+            break;
         }
+        input_queue.push(*byte);
+        if (input_queue.size() >= fifo_buffer_size) {
+            input_queue.pop();
+        }
+        ++processed_input_bytes;
     }
 }
 
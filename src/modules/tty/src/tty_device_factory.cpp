@@ -1,6 +1,7 @@
 
 #include "emu/module/tty/tty_device_factory.hpp"
 #include <cstdint>
+#include <fmt/format.h>
 #include <string>
 
 using namespace std::string_literals;
@@ -14,14 +15,28 @@ TtyDeviceFactory::CreateDevice(const std::string &name,
 
     auto instance = std::make_shared<TtyDeviceInstance>();
 
-    std::istream *input_stream = nullptr;
-    if (auto input = md.GetConfigItem("input", ""s); !input.empty()) {
-        input_stream = instance->stream_container.OpenBinaryInput(input);
-    }
-
-    std::ostream *output_stream = nullptr;
-    if (auto output = md.GetConfigItem("output", ""s); !output.empty()) {
-        output_stream = instance->stream_container.OpenBinaryOutput(output);
+    std::shared_ptr<TtyChannel> channel;
+    auto backend = md.GetConfigItem("backend", "stream"s);
+    if (backend == "stream") {
+        std::istream *input_stream = nullptr;
+        if (auto input = md.GetConfigItem("input", ""s); !input.empty()) {
+            input_stream = instance->stream_container.OpenBinaryInput(input);
+        }
+
+        std::ostream *output_stream = nullptr;
+        if (auto output = md.GetConfigItem("output", ""s); !output.empty()) {
+            output_stream = instance->stream_container.OpenBinaryOutput(output);
+        }
+        channel = std::make_shared<StreamTtyChannel>(input_stream, output_stream);
+    } else if (backend == "pty") {
+        channel = EpollTtyChannel::OpenPty(md.GetConfigItem("pty_link", ""s),
+                                           verbose_output);
+    } else if (backend == "socket") {
+        channel = EpollTtyChannel::ListenUnixSocket(md.GetConfigItem("socket", ""s),
+                                                    verbose_output);
+    } else {
+        throw std::runtime_error(
+            fmt::format("TtyDevice {}: Unknown backend '{}'", name, backend));
     }
 
     auto baudrate =
@@ -30,8 +45,8 @@ TtyDeviceFactory::CreateDevice(const std::string &name,
         md.GetConfigItem<int64_t>("buffer_size", kDefaultFifoBufferSize);
     auto enabled = md.GetConfigItem("enabled", false);
 
-    instance->device = std::make_shared<TtyDevice>(input_stream, output_stream, clock,
-                                                   baudrate, fifo_buffer_size, enabled);
+    instance->device = std::make_shared<TtyDevice>(std::move(channel), clock, baudrate,
+                                                   fifo_buffer_size, enabled);
 
     return instance;
 }
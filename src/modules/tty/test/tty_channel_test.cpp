@@ -0,0 +1,120 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "emu/module/tty/tty_channel.hpp"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fmt/format.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+
+namespace emu::module::tty::test {
+namespace {
+
+using namespace ::testing;
+using namespace std::string_literals;
+using namespace std::chrono_literals;
+
+std::string ReadAvailable(TtyChannel &channel, size_t count) {
+    std::string r;
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (r.size() < count && std::chrono::steady_clock::now() < deadline) {
+        if (auto byte = channel.Read(); byte.has_value()) {
+            r.push_back(static_cast<char>(*byte));
+        } else {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    return r;
+}
+
+std::string ReadFd(int fd, size_t count) {
+    std::string r;
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (r.size() < count && std::chrono::steady_clock::now() < deadline) {
+        char buffer[64];
+        auto n = ::read(fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            r.append(buffer, n);
+        } else {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    return r;
+}
+
+void WriteAll(TtyChannel &channel, const std::string &data) {
+    for (auto c : data) {
+        channel.Write(static_cast<uint8_t>(c));
+    }
+}
+
+TEST(StreamTtyChannelTest, ReadWrite) {
+    std::stringstream input{"ab"};
+    std::stringstream output;
+    StreamTtyChannel channel{&input, &output};
+
+    EXPECT_EQ(channel.Read(), 'a');
+    EXPECT_EQ(channel.Read(), 'b');
+    EXPECT_EQ(channel.Read(), std::nullopt);
+
+    channel.Write('x');
+    EXPECT_EQ(output.str(), "x"s);
+}
+
+TEST(StreamTtyChannelTest, NoStreams) {
+    StreamTtyChannel channel{nullptr, nullptr};
+    EXPECT_EQ(channel.Read(), std::nullopt);
+    EXPECT_NO_THROW(channel.Write('x'));
+}
+
+TEST(EpollTtyChannelTest, UnixSocket) {
+    auto path = (std::filesystem::temp_directory_path() /
+                 fmt::format("emu_tty_test_{}.sock", ::getpid()))
+                    .string();
+    auto channel = EpollTtyChannel::ListenUnixSocket(path);
+    EXPECT_EQ(channel->Read(), std::nullopt);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+    ::fcntl(fd, F_SETFL, O_NONBLOCK);
+
+    ASSERT_EQ(::write(fd, "hello", 5), 5);
+    EXPECT_EQ(ReadAvailable(*channel, 5), "hello"s);
+
+    WriteAll(*channel, "world");
+    EXPECT_EQ(ReadFd(fd, 5), "world"s);
+
+    ::close(fd);
+    channel.reset();
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(EpollTtyChannelTest, Pty) {
+    auto channel = EpollTtyChannel::OpenPty();
+    ASSERT_FALSE(channel->GetPath().empty());
+
+    int fd = ::open(channel->GetPath().c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    ASSERT_GE(fd, 0);
+
+    ASSERT_EQ(::write(fd, "ping", 4), 4);
+    EXPECT_EQ(ReadAvailable(*channel, 4), "ping"s);
+
+    WriteAll(*channel, "pong");
+    EXPECT_EQ(ReadFd(fd, 4), "pong"s);
+
+    ::close(fd);
+}
+
+} // namespace
+} // namespace emu::module::tty::test
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "emu/module/watchdog/watchdog_device.hpp"
+#include "emu_core/device_factory.hpp"
+#include <cstdint>
+
+namespace emu::module::watchdog {
+
+struct WatchdogDeviceInstance : public Device,
+                                std::enable_shared_from_this<WatchdogDeviceInstance> {
+    ~WatchdogDeviceInstance() override = default;
+
+    std::shared_ptr<Memory16> GetMemory() override { return device; }
+    size_t GetMemorySize() override { return WatchdogDevice::kDeviceMemorySize; };
+    std::shared_ptr<WatchdogDevice> device;
+};
+
+struct WatchdogDeviceFactory : public DeviceFactory {
+    WatchdogDeviceFactory() = default;
+    ~WatchdogDeviceFactory() override = default;
+
+    std::shared_ptr<Device> CreateDevice(const std::string &name,
+                                         const MemoryConfigEntry::MappedDevice &md,
+                                         Clock *clock,
+                                         std::ostream *verbose_output) const override {
+        auto instance = std::make_shared<WatchdogDeviceInstance>();
+        auto timeout = md.GetConfigItem<int64_t>("timeout", WatchdogDevice::kDefaultTimeout);
+        auto enabled = md.GetConfigItem("enabled", false);
+        instance->device = std::make_shared<WatchdogDevice>(
+            clock, static_cast<WatchdogDevice::TimeoutReg>(timeout), enabled,
+            verbose_output);
+        return instance;
+    }
+};
+
+} // namespace emu::module::watchdog
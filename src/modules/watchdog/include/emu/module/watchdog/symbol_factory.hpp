@@ -0,0 +1,36 @@
+#pragma once
+
+#include "emu/module/watchdog/watchdog_device.hpp"
+#include "emu_core/symbol_factory.hpp"
+#include <cstdint>
+#include <memory>
+
+using namespace std::string_literals;
+
+namespace emu::module::watchdog {
+
+struct WatchdogDeviceSymbolFactory : public SymbolFactory {
+    WatchdogDeviceSymbolFactory() = default;
+    ~WatchdogDeviceSymbolFactory() override = default;
+
+    static constexpr auto kClassName = "WATCHDOG";
+
+    SymbolDefVector GetSymbols(const MemoryConfigEntry &entry,
+                               const MemoryConfigEntry::MappedDevice &md) const override {
+        auto base = entry.offset;
+        SymbolDefVectorBuilder r{kClassName, entry.name};
+        using Reg = WatchdogDevice::Register;
+        r.EmitSymbol("BASE_ADDRESS"s, base);
+        r.EmitSymbol("REGISTER_CONTROL"s, base, Reg::kControl);
+        r.EmitSymbol("REGISTER_KICK"s, base, Reg::kKick);
+        r.EmitSymbol("REGISTER_TIMEOUT_0"s, base, Reg::kTimeout0);
+        r.EmitSymbol("REGISTER_TIMEOUT_1"s, base, Reg::kTimeout1);
+        r.EmitSymbol("REGISTER_TIMEOUT_2"s, base, Reg::kTimeout2);
+        r.EmitSymbol("REGISTER_TIMEOUT_3"s, base, Reg::kTimeout3);
+        r.EmitAlias("CONTROL_ENABLED"s, WatchdogDevice::kControlEnabled);
+        r.EmitAlias("KICK_VALUE"s, WatchdogDevice::kKickValue);
+        return r.entries;
+    }
+};
+
+} // namespace emu::module::watchdog
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "emu_core/clock.hpp"
+#include "emu_core/memory.hpp"
+#include <cstdint>
+#include <iostream>
+
+namespace emu::module::watchdog {
+
+// Guest must write kKickValue to kick register within timeout cycles once enabled,
+// otherwise cpu stops simulation with WatchdogExpired.
+class WatchdogDevice : public Memory16 {
+public:
+    using TimeoutReg = uint32_t;
+
+    enum class Register : Memory16::Address_t {
+        kControl,
+        kKick,
+        kTimeout0,
+        kTimeout1,
+        kTimeout2,
+        kTimeout3,
+    };
+
+    static constexpr uint8_t kControlEnabled = 1;
+    static constexpr uint8_t kKickValue = 0x5A;
+    static constexpr TimeoutReg kDefaultTimeout = 1'000'000;
+    static constexpr Memory16::Address_t kDeviceMemorySize = 2 + sizeof(TimeoutReg);
+
+    WatchdogDevice(Clock *clock, TimeoutReg timeout = kDefaultTimeout, bool enabled = false,
+                   std::ostream *verbose_output = nullptr);
+
+    [[nodiscard]] uint8_t Load(Address_t address) const override;
+    void Store(Address_t address, uint8_t value) override;
+
+    [[nodiscard]] std::optional<uint8_t> DebugRead(Address_t address) const override;
+
+    [[nodiscard]] uint8_t Load(Register address) const {
+        return Load(static_cast<Address_t>(address));
+    }
+    void Store(Register address, uint8_t value) {
+        Store(static_cast<Address_t>(address), value);
+    }
+
+    void Kick();
+    void SetEnabled(bool value);
+
+private:
+    Clock *const clock;
+    std::ostream *const verbose_output;
+    TimeoutReg timeout;
+    bool enabled = false;
+
+    [[noreturn]] void Error(const std::string &msg) const {
+        if (verbose_output != nullptr) {
+            (*verbose_output) << msg << "\n";
+        }
+        throw std::runtime_error(msg);
+    }
+};
+
+} // namespace emu::module::watchdog
@@ -0,0 +1,7 @@
+#include "emu/module/watchdog/device_factory.hpp"
+#include "emu/module/watchdog/symbol_factory.hpp"
+#include "emu_core/plugins/plugin.hpp"
+
+using namespace emu::module::watchdog;
+
+EMU_DEFINE_FACTORIES(WatchdogDeviceFactory, WatchdogDeviceSymbolFactory, default)
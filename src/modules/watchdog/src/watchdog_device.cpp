@@ -0,0 +1,88 @@
+#include "emu/module/watchdog/watchdog_device.hpp"
+#include <fmt/format.h>
+
+namespace emu::module::watchdog {
+
+namespace {
+
+size_t bit_offset(size_t v) {
+    return v * 8;
+}
+
+} // namespace
+
+WatchdogDevice::WatchdogDevice(Clock *clock, TimeoutReg timeout, bool enabled,
+                               std::ostream *verbose_output)
+    : clock(clock), verbose_output(verbose_output), timeout(timeout) {
+    SetEnabled(enabled);
+}
+
+void WatchdogDevice::Kick() {
+    if (enabled) {
+        clock->ArmWatchdog(timeout);
+    }
+}
+
+void WatchdogDevice::SetEnabled(bool value) {
+    enabled = value;
+    if (enabled) {
+        Kick();
+    } else {
+        clock->DisarmWatchdog();
+    }
+}
+
+std::optional<uint8_t> WatchdogDevice::DebugRead(Address_t address) const {
+    switch (static_cast<Register>(address)) {
+    case Register::kControl:
+        return static_cast<uint8_t>(enabled ? kControlEnabled : 0);
+    case Register::kKick:
+        return static_cast<uint8_t>(0);
+    case Register::kTimeout0:
+    case Register::kTimeout1:
+    case Register::kTimeout2:
+    case Register::kTimeout3: {
+        auto index = address - static_cast<Address_t>(Register::kTimeout0);
+        return static_cast<uint8_t>((timeout >> bit_offset(index)) & 0xFF);
+    }
+    }
+    return std::nullopt;
+}
+
+uint8_t WatchdogDevice::Load(Address_t address) const {
+    if (auto v = DebugRead(address); v.has_value()) {
+        return *v;
+    }
+    Error(fmt::format("WatchdogDevice: Attempt to read address {:04x}", address));
+}
+
+void WatchdogDevice::Store(Address_t address, uint8_t value) {
+    switch (static_cast<Register>(address)) {
+    case Register::kControl:
+        SetEnabled((value & kControlEnabled) != 0);
+        return;
+    case Register::kKick:
+        if (value == kKickValue) {
+            Kick();
+        } else if (verbose_output != nullptr) {
+            (*verbose_output) << fmt::format("WatchdogDevice: Invalid kick value {:02x}\n",
+                                             value);
+        }
+        return;
+    case Register::kTimeout0:
+    case Register::kTimeout1:
+    case Register::kTimeout2:
+    case Register::kTimeout3: {
+        // New timeout is applied on next kick
+        auto index = address - static_cast<Address_t>(Register::kTimeout0);
+        timeout = (timeout & ~(TimeoutReg{0xFF} << bit_offset(index))) |
+                  (TimeoutReg{value} << bit_offset(index));
+        return;
+    }
+    }
+
+    Error(fmt::format("WatchdogDevice: Attempt to write address {:04x} with {:02x}",
+                      address, value));
+}
+
+} // namespace emu::module::watchdog
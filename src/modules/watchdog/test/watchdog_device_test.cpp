@@ -0,0 +1,72 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "emu/module/watchdog/watchdog_device.hpp"
+#include "emu_core/clock.hpp"
+
+namespace emu::module::watchdog::test {
+namespace {
+
+using namespace ::testing;
+
+class WatchdogDeviceTest : public testing::Test {
+public:
+    static constexpr WatchdogDevice::TimeoutReg kTimeout = 100;
+
+    using Register = WatchdogDevice::Register;
+
+    ClockSimple clock;
+    WatchdogDevice device{&clock, kTimeout};
+
+    void Run(uint64_t cycles) {
+        for (uint64_t i = 0; i < cycles; ++i) {
+            clock.WaitForNextCycle();
+        }
+    }
+};
+
+TEST_F(WatchdogDeviceTest, DisabledNeverExpires) {
+    EXPECT_EQ(device.Load(Register::kControl), 0);
+    EXPECT_EQ(device.Load(Register::kTimeout0), kTimeout);
+    Run(10 * kTimeout);
+    EXPECT_FALSE(clock.WatchdogExpired());
+}
+
+TEST_F(WatchdogDeviceTest, Expires) {
+    device.Store(Register::kControl, WatchdogDevice::kControlEnabled);
+    Run(kTimeout - 1);
+    EXPECT_FALSE(clock.WatchdogExpired());
+    Run(1);
+    EXPECT_TRUE(clock.WatchdogExpired());
+}
+
+TEST_F(WatchdogDeviceTest, Kick) {
+    device.Store(Register::kControl, WatchdogDevice::kControlEnabled);
+    for (int i = 0; i < 10; ++i) {
+        Run(kTimeout - 1);
+        device.Store(Register::kKick, WatchdogDevice::kKickValue);
+    }
+    EXPECT_FALSE(clock.WatchdogExpired());
+
+    // invalid kick value is ignored
+    Run(kTimeout - 1);
+    device.Store(Register::kKick, 0);
+    Run(1);
+    EXPECT_TRUE(clock.WatchdogExpired());
+
+    device.Store(Register::kControl, 0);
+    EXPECT_FALSE(clock.WatchdogExpired());
+}
+
+TEST_F(WatchdogDeviceTest, ChangeTimeout) {
+    device.Store(Register::kTimeout0, 0x00);
+    device.Store(Register::kTimeout1, 0x10);
+    device.Store(Register::kControl, WatchdogDevice::kControlEnabled);
+    Run(0xFFF);
+    EXPECT_FALSE(clock.WatchdogExpired());
+    Run(1);
+    EXPECT_TRUE(clock.WatchdogExpired());
+}
+
+} // namespace
+} // namespace emu::module::watchdog::test
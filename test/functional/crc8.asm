@@ -58,7 +58,7 @@ FLUSH:
     RTS
 
 EXPECTED_RESULT:
-.byte 0x7c
+.byte 0x7a
 
 .align page
 CRC8_TABLE: